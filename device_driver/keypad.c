@@ -20,40 +20,118 @@ char keypadChar[4][4] = {
     {END_SIGN, '7', '4', '1'}   // COL3: 종료, 7, 4, 1
 };
 
-/* 이전 키 상태 저장 (디바운싱용) */
-static uint8_t prevState[4][4] = {
-    {RELEASED, RELEASED, RELEASED, RELEASED},
-    {RELEASED, RELEASED, RELEASED, RELEASED},
-    {RELEASED, RELEASED, RELEASED, RELEASED},
-    {RELEASED, RELEASED, RELEASED, RELEASED}
-};
+/* 키별 디바운싱 상태 (키패드 쓰레드만 사용, 비트/인덱스 = 열 * 4 + 행) */
+static uint16_t stableKeys = 0;     // 확정된 키 상태 (눌림 = 1)
+static uint16_t bouncing = 0;       // 읽은 값이 확정 상태와 달라 시간을 재는 중인 키
+static uint16_t longSent = 0;       // 이번 누름에서 길게 누름 이벤트를 보낸 키
+static uint64_t changeAt[16];       // 읽은 값이 확정 상태와 달라지기 시작한 시각
+static uint64_t downAt[16];         // 눌림 확정 시각 (길게 누름 기준)
+static uint64_t nextRepeat[16];     // 다음 자동 반복 시각
 
-/* 입력 버퍼 및 상태 관리 */
-char input_buf[17] = {0};     // 최대 16자 + NULL 종료자
-int idx = 0;                  // 현재 입력 위치
-int is_send = 0;              // 전송 플래그: 0=입력중, 1=전송준비완료
-pthread_mutex_t buf_mutex = PTHREAD_MUTEX_INITIALIZER;  // 버퍼 동기화용
+/* 키 입력 시간 설정 (ms) */
+unsigned keypad_debounce_ms = KEYPAD_DEFAULT_DEBOUNCE_MS;
+unsigned keypad_long_ms = KEYPAD_DEFAULT_LONG_MS;
+unsigned keypad_repeat_delay_ms = KEYPAD_DEFAULT_REPEAT_DELAY_MS;
+unsigned keypad_repeat_ms = KEYPAD_DEFAULT_REPEAT_MS;
 
 /* 프로그램 실행 제어 */
 volatile int keepRunning = 1;
 
+/* 키 이벤트 큐 (키패드 쓰레드 → 클라이언트) */
+key_queue key_events = { .wake_fd = -1 };
+
+/* 키패드 백엔드, 종료 알림 */
+const keypad_backend *keypad_active = NULL;
+int keypad_stop_fd = -1;
+
 /* Ctrl+C 시그널 핸들러 - 프로그램 종료 */
 void signalHandler(int sig) {
     keepRunning = 0;
 }
 
+/* 환경 변수에서 ms 값 읽기 (없거나 잘못되면 기본값) */
+static unsigned env_ms(const char *name, unsigned def) {
+    const char *v = getenv(name);
+    if (!v || !*v) return def;
+    char *end;
+    long ms = strtol(v, &end, 10);
+    return (*end == '\0' && ms >= 0 && ms <= 60000) ? (unsigned)ms : def;
+}
+
 /**
  * keypad_init - 키패드 및 GPIO 초기화
  * 
- * GPIO 핀을 설정하고 키패드 스캔을 위한 환경을 구성:
- * - 열 핀들: 출력으로 설정 (스캔 신호용)
- * - 행 핀들: 입력으로 설정하고 풀업 저항 활성화
+ * 키 이벤트 큐를 준비하고 키패드 백엔드를 고름:
+ * - 환경 변수 KEYPAD_BACKEND(gpiochip|mmio|mock)가 있으면 그 백엔드만 사용
+ * - 없으면 gpiochip을 먼저 시도하고, 쓸 수 없으면 mmio로 대체
+ * 디바운싱/길게 누름/자동 반복 시간은 KEYPAD_*_MS 환경 변수로 변경
  */
 void keypad_init(void){
     signal(SIGINT, signalHandler);  // Ctrl+C 핸들러 등록
 
+    // 키 이벤트 알림, 종료 알림용 eventfd
+    key_events.wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    keypad_stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (key_events.wake_fd < 0 || keypad_stop_fd < 0) exit(1);
+
+    keypad_debounce_ms = env_ms("KEYPAD_DEBOUNCE_MS", KEYPAD_DEFAULT_DEBOUNCE_MS);
+    keypad_long_ms = env_ms("KEYPAD_LONG_MS", KEYPAD_DEFAULT_LONG_MS);
+    keypad_repeat_delay_ms = env_ms("KEYPAD_REPEAT_DELAY_MS", KEYPAD_DEFAULT_REPEAT_DELAY_MS);
+    keypad_repeat_ms = env_ms("KEYPAD_REPEAT_MS", KEYPAD_DEFAULT_REPEAT_MS);
+
+    static const keypad_backend *backends[] = { &keypad_gpiochip, &keypad_mmio, &keypad_mock };
+    const char *want = getenv("KEYPAD_BACKEND");
+    for (int i = 0; i < 3 && !keypad_active; i++) {
+        if (want ? strcmp(want, backends[i]->name) != 0 : backends[i] == &keypad_mock) continue;
+        if (backends[i]->open() == 0) keypad_active = backends[i];
+    }
+    if (!keypad_active) {
+        fprintf(stderr, "키패드를 열 수 없습니다 (백엔드: %s)\n", want ? want : "gpiochip, mmio");
+        exit(1);
+    }
+    printf("키패드 백엔드: %s (디바운싱 %ums, 길게 누름 %ums, 자동 반복 %ums/%ums)\n", keypad_active->name,
+           keypad_debounce_ms, keypad_long_ms, keypad_repeat_delay_ms, keypad_repeat_ms);
+
+    lcd_clear_line2();              // LCD 2번째 줄 초기화
+}
+
+/**
+ * keypad_stop - 키패드 쓰레드 종료 요청
+ * 
+ * 키 변화를 기다리며 잠든 백엔드도 종료 알림으로 바로 깨어남
+ */
+void keypad_stop(void) {
+    uint64_t one = 1;
+    keepRunning = 0;
+    write(keypad_stop_fd, &one, sizeof(one));
+}
+
+/**
+ * keypad_wait_fd - 엣지 이벤트 fd와 종료 알림을 함께 기다림
+ * @fd: 엣지 이벤트를 읽을 수 있게 되는 fd (-1이면 종료 알림과 시간만 기다림)
+ * @timeout_ms: 최대 대기 시간 (-1: 무한)
+ * @return: 1 = 엣지 이벤트, 0 = 시간 초과, -1 = 종료 요청
+ */
+int keypad_wait_fd(int fd, int timeout_ms) {
+    struct pollfd pfd[2] = {
+        { .fd = keypad_stop_fd, .events = POLLIN },
+        { .fd = fd, .events = POLLIN },
+    };
+    int n = poll(pfd, fd >= 0 ? 2 : 1, timeout_ms);
+    if (!keepRunning || (n > 0 && pfd[0].revents)) return -1;
+    return (n > 0 && pfd[1].revents) ? 1 : 0;
+}
+
+// ================= mmio 백엔드 (/dev/mem 레지스터 직접 접근, 폴링) =================
+
+/**
+ * mmio_open - GPIO 레지스터 매핑 후 핀 설정
+ * - 열 핀들: 출력으로 설정 (스캔 신호용)
+ * - 행 핀들: 입력으로 설정하고 풀업 저항 활성화
+ */
+static int mmio_open(void) {
     // GPIO 메모리 매핑 초기화
-    setup_io();
+    if (setup_io() < 0) return -1;
     
     // 열 핀들을 출력으로 설정하고 HIGH로 초기화
     for (int i = 0; i < 4; i++) {
@@ -67,27 +145,41 @@ void keypad_init(void){
         INP_GPIO(rowPins[i]);       // 입력으로 설정
         set_pull_up(rowPins[i]);    // 내부 풀업 저항 활성화
     }
+    return 0;
+}
 
-    lcd_clear_line2();              // LCD 2번째 줄 초기화
+// 레지스터로는 키 변화를 기다릴 수 없으므로 항상 스캔 주기만큼 쉼
+static int mmio_wait(int timeout_ms) {
+    (void)timeout_ms;
+    return keypad_wait_fd(-1, KEYPAD_SCAN_PERIOD_US / 1000) >= 0;
 }
 
+const keypad_backend keypad_mmio = {
+    .name = "mmio",
+    .open = mmio_open,
+    .read_matrix = keypadReadMatrix,
+    .wait = mmio_wait,
+};
+
 /**
  * setup_io - GPIO 메모리 매핑 설정
  * /dev/mem을 통해 GPIO 레지스터에 직접 접근할 수 있도록 메모리 매핑
+ * @return: 0 성공, -1 실패 (root 권한 필요)
  */
-void setup_io() {
+int setup_io() {
     int mem_fd;
     void *gpio_map;
     
     // /dev/mem 열기 (물리 메모리 접근)
-    if ((mem_fd = open("/dev/mem", O_RDWR|O_SYNC)) < 0) exit(1);
+    if ((mem_fd = open("/dev/mem", O_RDWR|O_SYNC)) < 0) return -1;
     
     // GPIO 레지스터 영역을 가상 메모리에 매핑
     gpio_map = mmap(NULL, BLOCK_SIZE, PROT_READ|PROT_WRITE, MAP_SHARED, mem_fd, GPIO_BASE);
     close(mem_fd);
     
-    if (gpio_map == MAP_FAILED) exit(1);
+    if (gpio_map == MAP_FAILED) return -1;
     gpio = (volatile unsigned *)gpio_map;
+    return 0;
 }
 
 /**
@@ -112,19 +204,18 @@ void set_pull_up(int g) {
 }
 
 /**
- * getKeypadState - 특정 키의 상태 확인 및 키 값 반환
+ * getKeypadState - 특정 키의 현재 상태 확인
  * @col: 열 번호 (0~3)
  * @row: 행 번호 (0~3)
- * @return: 눌렸다 떼어진 키의 문자, 없으면 0
+ * @return: PUSHED 또는 RELEASED
+ * 
+ * 키 하나만 확인할 때 사용 (전체 스캔은 keypadReadMatrix)
  * 
  * 매트릭스 스캔 방식:
  * 1. 해당 열만 LOW, 나머지 열은 HIGH로 설정
  * 2. 행 핀의 상태 읽기 (풀업이므로 눌리면 LOW)
- * 3. 이전 상태와 비교하여 키 릴리스 감지
  */
 char getKeypadState(int col, int row) {
-    char key = 0;
-    
     // 1. 매트릭스 스캔: 해당 열만 LOW, 나머지는 HIGH
     for (int i = 0; i < 4; i++) {
         if (i == col) 
@@ -132,40 +223,112 @@ char getKeypadState(int col, int row) {
         else 
             GPIO_SET = 1 << colPins[i];  // 나머지 열은 HIGH로
     }
-    usleep(50);                          // 신호 안정화 대기
+    usleep(KEYPAD_SETTLE_US);            // 신호 안정화 대기
 
     // 2. 행 핀 상태 읽기 (풀업 기준: HIGH=떼어짐, LOW=눌림)
     uint8_t curState = (GET_GPIO(rowPins[row]) ? RELEASED : PUSHED);
 
-    // 3. 키 릴리스 감지 (눌림→떼어짐 전환 시점에서 키 인식)
-    if (curState == RELEASED && prevState[col][row] == PUSHED) {
-        key = keypadChar[col][row];      // 해당 위치의 키 문자 반환
-    }
-    prevState[col][row] = curState;      // 현재 상태 저장
-
-    // 4. 스캔 완료 후 열 핀을 다시 HIGH로 복원
+    // 3. 스캔 완료 후 열 핀을 다시 HIGH로 복원
     GPIO_SET = 1 << colPins[col];
 
-    return key;
+    return curState;
 }
 
 /**
- * keypadScan - 전체 키패드 스캔
- * @return: 눌린 키의 문자, 없으면 0
+ * keypadReadMatrix - 전체 키 상태를 비트맵으로 읽기
+ * @return: 눌린 키의 비트가 1인 비트맵 (KEY_BIT)
  * 
- * 4x4 매트릭스를 순차적으로 스캔하여 눌린 키를 찾음
+ * 열마다 한 번만 LOW로 구동하고, 안정화 대기 후 GPLEV0 한 번으로 네 행을 함께 읽음
+ * (키마다 열 전체를 다시 구동하고 기다리던 방식의 16번 대신 4번만 대기)
+ * 나머지 열은 스캔하지 않을 때 항상 HIGH로 유지됨
  */
-char keypadScan() {
-    char data = 0;
+uint16_t keypadReadMatrix(void) {
+    uint16_t keys = 0;
     
-    // 모든 열과 행을 순회하며 키 상태 확인
     for (int col = 0; col < 4; col++) {
+        GPIO_CLR = 1 << colPins[col];        // 이 열만 LOW
+        usleep(KEYPAD_SETTLE_US);            // 신호 안정화 대기
+        uint32_t level = GPIO_LEV0;          // 네 행을 한 번에 읽음
+        GPIO_SET = 1 << colPins[col];        // 다시 HIGH로 복원
+        
+        // 풀업 기준: LOW = 눌림
         for (int row = 0; row < 4; row++) {
-            data = getKeypadState(col, row);
-            if (data != 0) return data;      // 키가 감지되면 즉시 반환
+            if (!(level & (1u << rowPins[row]))) keys |= KEY_BIT(col, row);
         }
     }
-    return 0;                                // 눌린 키가 없음
+    return keys;
+}
+
+/**
+ * key_timers - 확정 눌림 상태인 키의 길게 누름/자동 반복 확인
+ * @bit: 키 (열 * 4 + 행)
+ * @now: 지금 시각
+ */
+static void key_timers(int bit, uint64_t now) {
+    char key = keypadChar[bit / 4][bit % 4];
+    uint64_t held = now - downAt[bit];
+    
+    if (keypad_long_ms && !(longSent & (1u << bit)) && held >= keypad_long_ms * 1000000ull) {
+        longSent |= 1u << bit;
+        key_queue_push(&key_events, key, KEY_LONG, now);
+    }
+    if (keypad_repeat_ms && now >= nextRepeat[bit]) {
+        key_queue_push(&key_events, key, KEY_REPEAT, now);
+        nextRepeat[bit] += keypad_repeat_ms * 1000000ull;
+        if (nextRepeat[bit] <= now) nextRepeat[bit] = now + keypad_repeat_ms * 1000000ull;  // 스캔이 늦었으면 몰아서 보내지 않음
+    }
+}
+
+/**
+ * keypadScan - 전체 키패드 스캔과 키별 디바운싱
+ * @return: 계속 스캔해야 하면 1 (눌려 있거나 확정을 기다리는 키가 있음), 아니면 0
+ * 
+ * 키마다 따로 도는 상태 기계 (잠들지 않고 스캔할 때마다 시각으로 판단):
+ * - 읽은 값이 확정 상태와 다르면 그때부터 시간을 재고, keypad_debounce_ms 동안 유지되면
+ *   눌림/뗌을 확정해 이벤트를 보냄 (그 전에 되돌아오면 튐으로 보고 무시)
+ * - 눌림 이벤트의 시각은 처음 바뀐 시각 (디바운싱 시간만큼 늦게 기록하지 않음)
+ * - 눌린 채로 keypad_long_ms가 지나면 KEY_LONG 한 번, keypad_repeat_delay_ms부터
+ *   keypad_repeat_ms마다 KEY_REPEAT
+ * - 키마다 독립이라 여러 키를 겹쳐 눌러도 모두 인식 (n-key rollover)
+ */
+int keypadScan() {
+    uint16_t raw = keypad_active->read_matrix();
+    uint64_t now = keypad_now_ns();
+    uint64_t debounce = keypad_debounce_ms * 1000000ull;
+    
+    uint16_t todo = raw | stableKeys | bouncing;
+    while (todo) {
+        int bit = __builtin_ctz(todo);       // 볼 키 하나 (bit = 열 * 4 + 행)
+        uint16_t mask = (uint16_t)(1u << bit);
+        todo &= todo - 1;
+        
+        int pressed = (raw & mask) != 0;
+        if (pressed != ((stableKeys & mask) != 0)) {
+            if (!(bouncing & mask)) {
+                bouncing |= mask;            // 바뀌기 시작함 - 시간 재기
+                changeAt[bit] = now;
+            }
+            if (now - changeAt[bit] < debounce) continue;
+            
+            // 확정
+            bouncing &= ~mask;
+            stableKeys ^= mask;
+            char key = keypadChar[bit / 4][bit % 4];
+            if (pressed) {
+                downAt[bit] = changeAt[bit];
+                nextRepeat[bit] = downAt[bit] + keypad_repeat_delay_ms * 1000000ull;
+                longSent &= ~mask;
+                key_queue_push(&key_events, key, KEY_PRESS, changeAt[bit]);
+            } else {
+                key_queue_push(&key_events, key, KEY_RELEASE, changeAt[bit]);
+            }
+        } else {
+            bouncing &= ~mask;               // 확정 전에 되돌아옴 (튐)
+        }
+        
+        if (stableKeys & mask) key_timers(bit, now);
+    }
+    return (stableKeys | bouncing) != 0;
 }
 
 /**
@@ -223,15 +386,68 @@ void lcd_clear_line2() {
 }
 
 /**
- * clear_keypad_str - 키패드 입력 버퍼 초기화
+ * keypad_now_ns - 단조 시계 (키 이벤트 시각)
+ * @return: CLOCK_MONOTONIC (ns)
+ */
+uint64_t keypad_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * key_queue_push - 키 이벤트 넣기 (생산자 쓰레드 하나만 호출)
+ * @q: 키 이벤트 큐
+ * @key: 키 문자
+ * @type: KEY_PRESS / KEY_RELEASE
+ * @ns: 감지한 시각
+ * @return: 0 성공, -1 가득 참 (이벤트는 버림)
  * 
- * 입력 버퍼를 비우고 관련 상태들을 초기값으로 재설정
+ * 칸을 채운 뒤 head를 release로 올려, 소비자가 head를 본 순간 칸 내용도 보이게 함
  */
-void clear_keypad_str(void){
-    memset(input_buf, 0, sizeof(input_buf)); // 버퍼 전체를 0으로 초기화
-    idx = 0;                                 // 입력 위치 초기화
-    is_send = 0;                             // 전송 플래그 초기화
-    lcd_clear_line2();                       // LCD 두 번째 줄 지우기
+int key_queue_push(key_queue *q, char key, int type, uint64_t ns) {
+    uint32_t head = q->head;
+    uint32_t tail = __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);
+    if (head - tail >= KEY_QUEUE_SIZE) {
+        q->dropped++;
+        return -1;
+    }
+    
+    key_event *ev = &q->ev[head & (KEY_QUEUE_SIZE - 1)];
+    ev->ns = ns;
+    ev->key = key;
+    ev->type = (uint8_t)type;
+    __atomic_store_n(&q->head, head + 1, __ATOMIC_RELEASE);
+    
+    uint64_t one = 1;
+    write(q->wake_fd, &one, sizeof(one));    // 소비자 깨우기 (횟수는 eventfd에서 합쳐짐)
+    return 0;
+}
+
+/**
+ * key_queue_pop - 키 이벤트 꺼내기 (소비자 쓰레드 하나만 호출)
+ * @q: 키 이벤트 큐
+ * @out: 꺼낸 이벤트
+ * @return: 1 꺼냄, 0 비어 있음
+ */
+int key_queue_pop(key_queue *q, key_event *out) {
+    uint32_t tail = q->tail;
+    if (tail == __atomic_load_n(&q->head, __ATOMIC_ACQUIRE)) return 0;
+    
+    *out = q->ev[tail & (KEY_QUEUE_SIZE - 1)];
+    __atomic_store_n(&q->tail, tail + 1, __ATOMIC_RELEASE);  // 칸을 다 읽은 뒤 생산자에게 돌려줌
+    return 1;
+}
+
+/**
+ * key_queue_drain_wake - 알림 읽기
+ * @q: 키 이벤트 큐
+ * 
+ * 알림을 먼저 읽고 큐를 비워야, 그 사이에 들어온 이벤트의 알림이 남아 다음 epoll_wait가 깨어남
+ */
+void key_queue_drain_wake(key_queue *q) {
+    uint64_t count;
+    read(q->wake_fd, &count, sizeof(count));
 }
 
 /**
@@ -239,39 +455,15 @@ void clear_keypad_str(void){
  * @arg: 스레드 인자 (사용하지 않음)
  * @return: NULL
  * 
- * 무한 루프로 키패드를 스캔하고 입력을 처리:
- * - 숫자 키: 입력 버퍼에 추가하고 LCD에 표시
- * - SEND 키: 전송 플래그 설정
- * - END_SIGN 키: 프로그램 종료
+ * 키패드를 스캔하고 키 이벤트를 키 이벤트 큐에 넣음
+ * (입력 버퍼, 전송, 종료 처리는 큐를 읽는 클라이언트가 함)
+ * 눌려 있거나 확정을 기다리는 키가 있으면 스캔 주기마다 (디바운싱, 길게 누름, 자동 반복 시각 확인),
+ * 없으면 백엔드가 다음 키 변화를 알릴 때까지 잠듦. 키를 인식한 뒤에도 스캔을 멈추지 않음
  */
 void* keypad_thread(void* arg) {
     while (keepRunning) {
-        char key = keypadScan();             // 키패드 스캔
-        
-        if (key) {                           // 키가 눌렸을 때
-            pthread_mutex_lock(&buf_mutex);  // 버퍼 접근 동기화
-            
-            // 전송 키 또는 버퍼 가득참
-            if (key == SEND || idx >= 16) { 
-                is_send = 1;                 // 전송 준비 완료
-            } 
-            // 숫자 키 입력 처리
-            else if (key >= '0' && key <= '9') {
-                if (idx < 16) {              // 버퍼 오버플로우 방지
-                    input_buf[idx++] = key;  // 버퍼에 문자 추가
-                    input_buf[idx] = '\0';   // NULL 종료자 추가
-                    lcd_write_line2(input_buf); // LCD에 현재 입력 표시
-                }
-            }
-            // 종료 키 처리
-            else if(key == END_SIGN){
-                keepRunning = 0;             // 메인 루프 종료 플래그
-            }
-            
-            pthread_mutex_unlock(&buf_mutex); // 뮤텍스 해제
-            usleep(200000);                  // 디바운싱: 200ms 대기
-        }
-        usleep(10000);                       // 스캔 주기: 10ms
+        int busy = keypadScan();
+        if (!keypad_active->wait(busy ? KEYPAD_SCAN_PERIOD_US / 1000 : -1)) break;
     }
     return NULL;
-}
\ No newline at end of file
+}
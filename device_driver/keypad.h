@@ -7,6 +7,11 @@
 // - BCM2711 SoC의 GPIO 핀 사용
 // - 4x4 매트릭스 키패드 (16개 키)
 // - LCD 디스플레이 연동
+//
+// 키패드 백엔드 (환경 변수 KEYPAD_BACKEND로 선택, 없으면 gpiochip → mmio 순서로 시도):
+// - gpiochip : GPIO 문자 장치(v2 uAPI). 행 라인의 엣지 이벤트를 epoll로 기다렸다가 스캔 (root 불필요)
+// - mmio     : /dev/mem으로 GPIO 레지스터를 직접 읽고 스캔 주기마다 폴링 (root 필요)
+// - mock     : 하드웨어 없는 시험용. 표준 입력의 글자를 키 누름으로 흉내 냄 (keypad_mock.c)
 
 #ifndef KEYPAD_H
 #define KEYPAD_H
@@ -21,6 +26,9 @@
 #include <pthread.h>        // POSIX 스레드
 #include <signal.h>         // 시그널 처리
 #include <stdint.h>         // 표준 정수 타입
+#include <time.h>           // 키 이벤트 시각 (clock_gettime)
+#include <sys/eventfd.h>    // 키 이벤트 알림 (eventfd)
+#include <poll.h>           // 엣지 이벤트/종료 알림 대기
 
 // ================= GPIO 하드웨어 관련 정의 =================
 
@@ -60,7 +68,8 @@ extern volatile unsigned *gpio;
 #define GPIO_CLR        *(gpio+10)                              // 핀을 LOW로 설정
 
 // GPIO 입력 읽기 매크로
-#define GET_GPIO(g)     (*(gpio+13)&(1<<g))                     // 핀 상태 읽기 (0 또는 1)
+#define GPIO_LEV0       *(gpio+13)                              // GPLEV0: 핀 0~31 레벨 (한 번에 읽기)
+#define GET_GPIO(g)     (GPIO_LEV0&(1<<g))                      // 핀 상태 읽기 (0 또는 1)
 
 // GPIO 풀업/풀다운 저항 제어 매크로
 #define GPIO_PULL       *(gpio+37)                              // 풀업/풀다운 모드 설정
@@ -72,6 +81,48 @@ extern volatile unsigned *gpio;
 #define PUSHED      0       // 키가 눌린 상태 (LOW)
 #define RELEASED    1       // 키가 떼어진 상태 (HIGH)
 
+// 스캔 설정
+#define KEYPAD_SETTLE_US        50      // 열을 LOW로 바꾼 뒤 행 입력이 안정될 때까지 대기 (us)
+#define KEYPAD_SCAN_PERIOD_US   5000    // 스캔 주기 (us) - 한 번 스캔에 대기 4번(열마다 한 번)
+
+// 키 입력 시간 기본값 (환경 변수로 변경, 0이면 끔)
+#define KEYPAD_DEFAULT_DEBOUNCE_MS      20      // KEYPAD_DEBOUNCE_MS: 상태가 이만큼 유지되어야 눌림/뗌 확정
+#define KEYPAD_DEFAULT_LONG_MS          800     // KEYPAD_LONG_MS: 길게 누름 이벤트까지
+#define KEYPAD_DEFAULT_REPEAT_DELAY_MS  500     // KEYPAD_REPEAT_DELAY_MS: 자동 반복 시작까지
+#define KEYPAD_DEFAULT_REPEAT_MS        150     // KEYPAD_REPEAT_MS: 자동 반복 간격
+
+// 키 비트맵: 눌린 키마다 비트 하나 (bit = 열 * 4 + 행)
+#define KEY_BIT(col, row)   ((uint16_t)1 << ((col) * 4 + (row)))
+
+// ================= 키패드 백엔드 =================
+
+#define KEYPAD_GPIOCHIP     "/dev/gpiochip0"    // BCM2711 GPIO 문자 장치
+#define KEYPAD_CONSUMER     "pager-keypad"      // 라인 요청 이름 (gpioinfo에 표시)
+
+// 키 입력을 읽는 방법 하나
+typedef struct {
+    const char *name;
+    int  (*open)(void);                 // 준비 (0: 사용 가능, -1: 사용 불가)
+    uint16_t (*read_matrix)(void);      // 전체 키 비트맵 (스캔 후 유휴 상태로 복원)
+    // 다음 스캔까지 대기 (timeout_ms: -1이면 키 변화가 있을 때까지)
+    // 반환: 1 = 스캔할 것, 0 = 종료 요청
+    int  (*wait)(int timeout_ms);
+} keypad_backend;
+
+// GPIO 라인 입출력 - gpiochip 백엔드의 스캔/대기 경로는 이것만 거침
+// (mock 백엔드는 가짜 라인을 넣어 같은 스캔/대기 경로를 그대로 탐)
+typedef struct {
+    int  (*set_cols)(uint64_t bits);    // 열 출력 값 (열마다 1 = HIGH)
+    uint64_t (*get_rows)(void);         // 행 입력 값 (행마다 1 = HIGH)
+    int  (*edge_fd)(void);              // 행 엣지가 오면 읽을 수 있게 되는 fd (논블로킹)
+    void (*drain)(void);                // 쌓인 엣지 비우기
+} keypad_lines;
+
+extern const keypad_backend keypad_mmio;       // keypad.c
+extern const keypad_backend keypad_gpiochip;   // keypad_gpiochip.c
+extern const keypad_backend keypad_mock;       // keypad_mock.c
+extern const keypad_backend *keypad_active;    // 사용 중인 백엔드
+
 // 특수 키 정의
 #define SEND        'v'     // 입력 완료 및 전송 키
 #define END_SIGN    'e'     // 프로그램 종료 키
@@ -91,33 +142,72 @@ extern char keypadChar[4][4];
 
 #define LCD_DEV     "/dev/mylcd"    // LCD 캐릭터 디바이스 경로
 
-// ================= 입력 버퍼 및 동기화 =================
-
-// 키패드 입력 관리 변수들
-extern char input_buf[17];          // 입력 버퍼 (최대 16자 + NULL 종료자)
-extern int idx;                     // 현재 입력 위치 인덱스
-extern int is_send;                 // 전송 준비 플래그 (0: 입력중, 1: 전송준비)
-extern pthread_mutex_t buf_mutex;   // 버퍼 접근 동기화용 뮤텍스
+// ================= 키 이벤트 큐 =================
+
+// 키패드 쓰레드(생산자 하나)가 키 상태 변화를 넣고, 클라이언트(소비자 하나)가 꺼내는
+// lock 없는 링 버퍼. 메시지 조립(입력 버퍼, 전송)은 소비자 쪽에서 함
+// - head는 생산자만, tail은 소비자만 씀 (서로 다른 캐시 라인)
+// - 넣을 때마다 wake_fd(eventfd)에 알리므로 소비자는 epoll로 기다릴 수 있음
+// - 가득 차면 새 이벤트를 버리고 dropped를 올림 (스캔 쓰레드는 기다리지 않음)
+#define KEY_QUEUE_SIZE  64          // 큐 크기 (2의 거듭제곱)
+
+#define KEY_RELEASE     0           // 떼어짐
+#define KEY_PRESS       1           // 눌림
+#define KEY_LONG        2           // 길게 누름 (누르고 있는 동안 한 번)
+#define KEY_REPEAT      3           // 자동 반복 (누르고 있는 동안 반복)
+
+// 키 이벤트 하나
+typedef struct {
+    uint64_t ns;                    // 감지한 시각 (CLOCK_MONOTONIC)
+    char key;                       // 키 문자 (keypadChar)
+    uint8_t type;                   // KEY_PRESS / KEY_RELEASE / KEY_LONG / KEY_REPEAT
+} key_event;
+
+typedef struct {
+    key_event ev[KEY_QUEUE_SIZE];
+    uint32_t head __attribute__((aligned(64)));     // 다음에 넣을 위치 (생산자)
+    uint32_t tail __attribute__((aligned(64)));     // 다음에 꺼낼 위치 (소비자)
+    unsigned long dropped;          // 가득 차서 버린 이벤트 수 (생산자)
+    int wake_fd;                    // 알림 eventfd (논블로킹)
+} key_queue;
+
+extern key_queue key_events;        // 키패드 쓰레드 → 클라이언트
 
 // ================= 프로그램 제어 =================
 
 extern volatile int keepRunning;    // 프로그램 실행 제어 플래그
+extern int keypad_stop_fd;          // 키패드 쓰레드 종료 알림 eventfd (대기 중인 백엔드를 깨움)
+
+// 키 입력 시간 설정 (ms, keypad_init에서 환경 변수로 읽음)
+extern unsigned keypad_debounce_ms, keypad_long_ms, keypad_repeat_delay_ms, keypad_repeat_ms;
 
 // ================= 함수 선언 =================
 
 // 초기화 함수
-void keypad_init(void);             // 키패드 및 GPIO 초기화
+void keypad_init(void);             // 키패드 및 GPIO 초기화 (백엔드 선택)
+void keypad_stop(void);             // 키패드 쓰레드 종료 요청
 
-// GPIO 관련 함수
-void setup_io();                    // GPIO 메모리 매핑 설정
+// 백엔드 공용 - 엣지 fd와 종료 알림을 함께 기다림 (1: 엣지, 0: 시간 초과, -1: 종료 요청)
+int  keypad_wait_fd(int fd, int timeout_ms);
+
+// 라인 단위 스캔/대기 (keypad_gpiochip.c, gpiochip과 mock 백엔드가 같이 씀)
+uint16_t keypad_lines_scan(const keypad_lines *l);         // 열마다 구동해 전체 키 비트맵 읽기
+int  keypad_lines_wait(const keypad_lines *l, int timeout_ms);  // 엣지 비우고 다음 스캔까지 대기
+
+// GPIO 관련 함수 (mmio 백엔드)
+int  setup_io();                    // GPIO 메모리 매핑 설정 (-1: 실패)
 void set_pull_up(int g);            // 지정 핀에 풀업 저항 설정
 
 // 키패드 입력 함수
-char getKeypadState(int col, int row);  // 특정 키의 상태 확인
-char keypadScan();                  // 전체 키패드 스캔
-
-// 버퍼 관리 함수
-void clear_keypad_str(void);        // 입력 버퍼 초기화
+char getKeypadState(int col, int row);  // 특정 키의 상태 확인 (PUSHED / RELEASED)
+uint16_t keypadReadMatrix(void);    // 열마다 한 번 구동해 전체 키 비트맵 읽기
+int  keypadScan();                  // 전체 키패드 스캔 (이벤트는 키 이벤트 큐로, 반환: 계속 스캔할지)
+
+// 키 이벤트 큐 함수
+uint64_t keypad_now_ns(void);       // 단조 시계 (ns)
+int  key_queue_push(key_queue *q, char key, int type, uint64_t ns);    // 생산자 (-1: 가득 참)
+int  key_queue_pop(key_queue *q, key_event *out);                       // 소비자 (0: 비어 있음)
+void key_queue_drain_wake(key_queue *q);    // 소비자: 알림 읽기 (비우기 전에 호출)
 
 // 스레드 함수
 void* keypad_thread(void* arg);     // 키패드 입력 처리 스레드
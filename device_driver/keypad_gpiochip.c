@@ -0,0 +1,143 @@
+// keypad_gpiochip.c - GPIO 문자 장치(v2 uAPI) 키패드 백엔드
+//
+// /dev/mem 대신 /dev/gpiochip0에서 라인을 요청하므로 root가 필요 없고(gpio 그룹 권한),
+// 아무도 누르지 않을 때는 쓰레드가 깨어나지 않습니다.
+// - 유휴 상태: 열 네 개를 모두 LOW로 둠 → 어느 키를 눌러도 그 행이 LOW로 떨어짐
+// - 행 라인은 풀업 + 양쪽 엣지 감지로 요청하고, 엣지가 오면 그때 한 번 스캔
+// - 스캔 중에는 열을 바꿔 가며 구동하므로 눌린 키가 있으면 행에 엣지가 생김 → 스캔 뒤에 비움
+// - 엣지를 비우는 사이에 눌린 키를 놓치지 않도록, 비운 뒤 유휴 상태의 행 값을 한 번 더 확인
+// - 스캔/대기(keypad_lines_scan/wait)는 라인 입출력(keypad_lines)만 거치므로
+//   mock 백엔드가 가짜 라인으로 같은 경로를 시험함
+
+#include "keypad.h"
+
+#include <errno.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+
+static int row_fd = -1;         // 행 라인 요청 (입력, 엣지 이벤트)
+static int col_fd = -1;         // 열 라인 요청 (출력)
+
+// 열 출력 값 설정 (bits: 열마다 1 = HIGH)
+static int set_cols(uint64_t bits) {
+    struct gpio_v2_line_values v = { .bits = bits, .mask = 0xF };
+    return ioctl(col_fd, GPIO_V2_LINE_SET_VALUES_IOCTL, &v);
+}
+
+// 행 입력 값 읽기 (행마다 1 = HIGH, 실패하면 모두 HIGH로 봄)
+static uint64_t get_rows(void) {
+    struct gpio_v2_line_values v = { .mask = 0xF };
+    if (ioctl(row_fd, GPIO_V2_LINE_GET_VALUES_IOCTL, &v) < 0) return 0xF;
+    return v.bits;
+}
+
+static int get_edge_fd(void) {
+    return row_fd;
+}
+
+// 스캔하면서 생긴 엣지 비우기
+static void drain_edges(void) {
+    struct gpio_v2_line_event ev[16];
+    while (read(row_fd, ev, sizeof(ev)) > 0) { }
+}
+
+static const keypad_lines gpio_lines = {
+    .set_cols = set_cols,
+    .get_rows = get_rows,
+    .edge_fd = get_edge_fd,
+    .drain = drain_edges,
+};
+
+// 라인 네 개 요청
+static int request_lines(int chip_fd, const int *pins, uint64_t flags, int out_values) {
+    struct gpio_v2_line_request req;
+    memset(&req, 0, sizeof(req));
+    for (int i = 0; i < 4; i++) req.offsets[i] = (uint32_t)pins[i];
+    req.num_lines = 4;
+    strncpy(req.consumer, KEYPAD_CONSUMER, sizeof(req.consumer) - 1);
+    req.config.flags = flags;
+    if (out_values >= 0) {
+        // 출력 초기값
+        req.config.num_attrs = 1;
+        req.config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+        req.config.attrs[0].attr.values = (uint64_t)out_values;
+        req.config.attrs[0].mask = 0xF;
+    }
+    if (ioctl(chip_fd, GPIO_V2_GET_LINE_IOCTL, &req) < 0) return -1;
+    return req.fd;
+}
+
+static int gpiochip_open(void) {
+    int chip_fd = open(KEYPAD_GPIOCHIP, O_RDONLY | O_CLOEXEC);
+    if (chip_fd < 0) return -1;
+    
+    // 열: 출력, 유휴 상태는 모두 LOW
+    col_fd = request_lines(chip_fd, colPins, GPIO_V2_LINE_FLAG_OUTPUT, 0);
+    // 행: 입력, 풀업, 양쪽 엣지 감지
+    row_fd = request_lines(chip_fd, rowPins,
+                           GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_BIAS_PULL_UP |
+                           GPIO_V2_LINE_FLAG_EDGE_RISING | GPIO_V2_LINE_FLAG_EDGE_FALLING, -1);
+    close(chip_fd);
+    
+    if (col_fd < 0 || row_fd < 0) {
+        if (col_fd >= 0) close(col_fd);
+        if (row_fd >= 0) close(row_fd);
+        col_fd = row_fd = -1;
+        return -1;
+    }
+    fcntl(row_fd, F_SETFL, fcntl(row_fd, F_GETFL) | O_NONBLOCK);
+    return 0;
+}
+
+/**
+ * keypad_lines_scan - 전체 키 비트맵 읽기
+ * @l: 라인 입출력
+ * @return: 눌린 키의 비트가 1인 비트맵 (KEY_BIT)
+ * 
+ * 열마다 한 번 (그 열만 LOW, 나머지 HIGH) 구동하고 네 행을 한 번에 읽음.
+ * 끝나면 다시 모든 열을 LOW로 두어 다음 누름을 엣지로 받음
+ */
+uint16_t keypad_lines_scan(const keypad_lines *l) {
+    uint16_t keys = 0;
+    
+    for (int col = 0; col < 4; col++) {
+        l->set_cols(0xF & ~(1u << col));     // 이 열만 LOW
+        usleep(KEYPAD_SETTLE_US);            // 신호 안정화 대기
+        uint64_t rows = l->get_rows();       // 네 행을 한 번에 읽음
+        for (int row = 0; row < 4; row++) {
+            if (!(rows & (1u << row))) keys |= KEY_BIT(col, row);
+        }
+    }
+    l->set_cols(0);                          // 유휴 상태: 모든 열 LOW
+    return keys;
+}
+
+/**
+ * keypad_lines_wait - 다음 스캔까지 대기
+ * @l: 라인 입출력
+ * @timeout_ms: -1이면 행 엣지가 올 때까지
+ * @return: 1 = 스캔할 것, 0 = 종료 요청
+ */
+int keypad_lines_wait(const keypad_lines *l, int timeout_ms) {
+    l->drain();
+    
+    // 비우는 사이에 눌렸으면 엣지를 기다리지 않고 바로 스캔
+    if (timeout_ms < 0 && l->get_rows() != 0xF) return 1;
+    
+    return keypad_wait_fd(l->edge_fd(), timeout_ms) >= 0;
+}
+
+static uint16_t gpiochip_read_matrix(void) {
+    return keypad_lines_scan(&gpio_lines);
+}
+
+static int gpiochip_wait(int timeout_ms) {
+    return keypad_lines_wait(&gpio_lines, timeout_ms);
+}
+
+const keypad_backend keypad_gpiochip = {
+    .name = "gpiochip",
+    .open = gpiochip_open,
+    .read_matrix = gpiochip_read_matrix,
+    .wait = gpiochip_wait,
+};
@@ -0,0 +1,159 @@
+// keypad_mock.c - 하드웨어 없는 시험용 키패드 백엔드
+//
+// GPIO 라인 수준의 가짜 칩입니다. 스캔과 대기는 gpiochip 백엔드의 경로
+// (keypad_lines_scan/wait)를 그대로 타고, 이 파일은 라인 입출력(keypad_lines)만 흉내 냄
+// - 키 매트릭스 상태(눌린 키 비트맵)와 열 출력 값을 메모리에 둠
+// - 행 값 = 풀업(HIGH)에 LOW로 구동 중인 열들을 AND: LOW인 열에서 눌린 키가 있으면 그 행이 LOW
+//   → 같은 행의 키 두 개를 누르면 엣지가 하나만 생기는 것도 실제 매트릭스와 같음
+// - 행 값이 바뀔 때마다(키 누름/뗌, 스캔 중 열 구동) 엣지 이벤트처럼 파이프에 한 바이트를 씀
+// - 표준 입력에서 읽은 글자를 키 누름으로 바꿈: 숫자, 'v'나 개행 = SEND, 'e' = END
+//   누르고 뗄 때마다 접점 튐을 흉내 내어 디바운싱도 함께 시험함
+//   $ KEYPAD_BACKEND=mock ./client 127.0.0.1 8080
+//   $ printf '123\ne' | KEYPAD_BACKEND=mock ./client 127.0.0.1 8080
+
+#include "keypad.h"
+
+#define MOCK_HOLD_US    40000           // 글자 하나를 누르고 있는 시간
+#define MOCK_GAP_US     40000           // 다음 글자까지 쉬는 시간
+#define MOCK_BOUNCES    3               // 누르고 뗄 때마다 흉내 내는 접점 튐 횟수
+#define MOCK_BOUNCE_US  1000            // 튐 한 번의 길이
+
+static pthread_mutex_t mock_lock = PTHREAD_MUTEX_INITIALIZER;  // 주입 쓰레드 ↔ 키패드 쓰레드
+static uint16_t mock_keys;              // 눌린 키 비트맵
+static uint64_t mock_cols;              // 열 출력 값 (열마다 1 = HIGH, 유휴 상태는 모두 LOW)
+static int edge_pipe[2] = { -1, -1 };   // 엣지 이벤트 흉내 (양쪽 논블로킹)
+
+// 현재 행 값 (mock_lock 필요)
+static uint64_t rows_locked(void) {
+    uint64_t rows = 0xF;                // 풀업: 아무것도 연결되지 않으면 HIGH
+    for (int col = 0; col < 4; col++) {
+        if (mock_cols & (1u << col)) continue;      // HIGH로 구동 중인 열은 행을 당기지 않음
+        for (int row = 0; row < 4; row++) {
+            if (mock_keys & KEY_BIT(col, row)) rows &= ~(1u << row);
+        }
+    }
+    return rows;
+}
+
+// 행 값이 바뀌었으면 엣지 알림 (mock_lock 필요, 파이프가 가득 차면 이미 읽을 것이 있으므로 버림)
+static void edge_if_changed(uint64_t before) {
+    if (rows_locked() == before) return;
+    char c = 0;
+    if (write(edge_pipe[1], &c, 1) < 0) { }
+}
+
+// 키 하나의 상태 바꾸기
+static void mock_set(int col, int row, int pressed) {
+    uint16_t bit = KEY_BIT(col, row);
+    pthread_mutex_lock(&mock_lock);
+    uint64_t before = rows_locked();
+    if (pressed) mock_keys |= bit;
+    else mock_keys &= (uint16_t)~bit;
+    edge_if_changed(before);
+    pthread_mutex_unlock(&mock_lock);
+}
+
+// ================= 라인 입출력 =================
+
+static int mock_set_cols(uint64_t bits) {
+    pthread_mutex_lock(&mock_lock);
+    uint64_t before = rows_locked();
+    mock_cols = bits & 0xF;
+    edge_if_changed(before);
+    pthread_mutex_unlock(&mock_lock);
+    return 0;
+}
+
+static uint64_t mock_get_rows(void) {
+    pthread_mutex_lock(&mock_lock);
+    uint64_t rows = rows_locked();
+    pthread_mutex_unlock(&mock_lock);
+    return rows;
+}
+
+static int mock_edge_fd(void) {
+    return edge_pipe[0];
+}
+
+static void mock_drain(void) {
+    char buf[64];
+    while (read(edge_pipe[0], buf, sizeof(buf)) > 0) { }
+}
+
+static const keypad_lines mock_lines = {
+    .set_cols = mock_set_cols,
+    .get_rows = mock_get_rows,
+    .edge_fd = mock_edge_fd,
+    .drain = mock_drain,
+};
+
+// ================= 키 누름 주입 =================
+
+// 글자 → 키 위치 (없으면 -1)
+static int mock_find(char key, int *col, int *row) {
+    for (int c = 0; c < 4; c++) {
+        for (int r = 0; r < 4; r++) {
+            if (keypadChar[c][r] == key) {
+                *col = c;
+                *row = r;
+                return 0;
+            }
+        }
+    }
+    return -1;
+}
+
+// 접점 튐을 거쳐 키 상태 바꾸기
+static void mock_press(int col, int row, int pressed) {
+    for (int i = 0; i < MOCK_BOUNCES; i++) {
+        mock_set(col, row, pressed);
+        usleep(MOCK_BOUNCE_US);
+        mock_set(col, row, !pressed);
+        usleep(MOCK_BOUNCE_US);
+    }
+    mock_set(col, row, pressed);
+}
+
+// 표준 입력의 글자를 키 누름/뗌으로 주입하는 쓰레드
+static void *mock_feed(void *arg) {
+    (void)arg;
+    int ch;
+    while (keepRunning && (ch = getchar()) != EOF) {
+        char key = (ch == '\n') ? SEND : (char)ch;
+        int col, row;
+        if (key == ' ' || mock_find(key, &col, &row) < 0) continue;   // 미사용 칸(' ')은 건너뜀
+        mock_press(col, row, 1);
+        usleep(MOCK_HOLD_US);
+        mock_press(col, row, 0);
+        usleep(MOCK_GAP_US);
+    }
+    return NULL;
+}
+
+// ================= 백엔드 (스캔/대기는 gpiochip과 같은 경로) =================
+
+static int mock_open(void) {
+    if (pipe(edge_pipe) < 0) return -1;
+    fcntl(edge_pipe[0], F_SETFL, O_NONBLOCK);
+    fcntl(edge_pipe[1], F_SETFL, O_NONBLOCK);
+    
+    pthread_t tid;
+    if (pthread_create(&tid, NULL, mock_feed, NULL) != 0) return -1;
+    pthread_detach(tid);
+    return 0;
+}
+
+static uint16_t mock_read_matrix(void) {
+    return keypad_lines_scan(&mock_lines);
+}
+
+static int mock_wait(int timeout_ms) {
+    return keypad_lines_wait(&mock_lines, timeout_ms);
+}
+
+const keypad_backend keypad_mock = {
+    .name = "mock",
+    .open = mock_open,
+    .read_matrix = mock_read_matrix,
+    .wait = mock_wait,
+};
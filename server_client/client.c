@@ -7,57 +7,198 @@
 #include <arpa/inet.h>
 #include <pthread.h>
 #include <signal.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/resource.h>
 
 #include "keypad.h"   // keypad 입력받기 위한 함수들, lcd 관련 내용도 포함됨
 
 #define BUFFER_SIZE 1024
+#define MAX_EVENTS  4       // 소켓, 키 이벤트 알림, 종료 시그널
+
+#define PING_LINE   "\x01PING"     // 서버 하트비트 줄 (개행 제외, 서버 heartbeat.h의 HB_PING_LINE)
+#define PONG_LINE   "PONG\n"
 
 int client_socket = -1;
 int running = 1;
 
-// 시그널 핸들러 - 클라이언트 종료시 소켓 정리
-void handle_shutdown(int sig) {
-    printf("\n클라이언트를 종료합니다...\n");
-    running = 0;
-    if (client_socket != -1) {
-        close(client_socket);
+// 받은 데이터 중 아직 개행이 오지 않은 부분 (recv 한 번이 줄 경계와 맞지 않을 수 있음)
+static char rx_buf[BUFFER_SIZE];
+static int rx_len;
+
+// 완성된 줄을 out에 모음 - 하트비트 줄은 PONG으로 답하고 빼며, 줄 전체가 같을 때만 하트비트로 봄
+// 반환값: out에 모은 길이 (out은 BUFFER_SIZE 바이트, NULL 종료)
+static int take_lines(int socket, char *out) {
+    int out_len = 0, start = 0;
+    for (int i = 0; i < rx_len; i++) {
+        if (rx_buf[i] != '\n') continue;
+        int line_len = i - start;
+        if (line_len == (int)strlen(PING_LINE) && memcmp(rx_buf + start, PING_LINE, line_len) == 0) {
+            send(socket, PONG_LINE, strlen(PONG_LINE), 0);
+        } else {
+            memcpy(out + out_len, rx_buf + start, line_len + 1);
+            out_len += line_len + 1;
+        }
+        start = i + 1;
+    }
+    // 개행 없이 버퍼가 가득 참 (너무 긴 줄) - 있는 그대로 표시
+    if (start == 0 && rx_len == BUFFER_SIZE - 1) {
+        memcpy(out, rx_buf, rx_len);
+        out_len = start = rx_len;
     }
-    exit(0);
+    memmove(rx_buf, rx_buf + start, rx_len - start);
+    rx_len -= start;
+    out[out_len] = '\0';
+    return out_len;
 }
 
-// 서버로부터 메시지 수신 쓰레드
-void *receive_messages(void *arg) {
-    int socket = *(int *)arg;
+// 서버로부터 받은 메시지 표시 (소켓을 읽을 수 있을 때 한 번 호출)
+// 반환값: 0 = 계속, -1 = 연결 종료
+static int receive_messages(int socket) {
+    int n = recv(socket, rx_buf + rx_len, BUFFER_SIZE - 1 - rx_len, 0);
+    
+    if (n == 0) {
+        printf("\n서버와의 연결이 종료되었습니다.\n");
+        return -1;
+    } else if (n < 0) {
+        if (errno == EINTR) return 0;
+        perror("\n수신 오류");
+        return -1;
+    }
+    rx_len += n;
+    
     char buffer[BUFFER_SIZE];
-    int bytes_received;
+    int bytes_received = take_lines(socket, buffer);
+    if (bytes_received == 0) return 0;
     
-    while (running && (bytes_received = recv(socket, buffer, BUFFER_SIZE - 1, 0)) > 0) {
-        buffer[bytes_received] = '\0';
-        
-        // 시스템 메시지나 다른 사용자의 메시지 표시
-        printf("\r%s", buffer);  // \r로 현재 줄 덮어쓰기
-        printf("> ");            // 프롬프트 재출력
-        fflush(stdout);
-
-        /* ============== 수신받은 메시지를 LCD에 출력 ===============*/
-        if(bytes_received > 16){
-            // LCD에 출력하기에 너무 긴 문자열이 온것 (welcom msg일 가능성)
-            // LCD에는 출력하지 않는다
-        }else{
-            lcd_write_line1(buffer);
-        }
-        
+    // 시스템 메시지나 다른 사용자의 메시지 표시
+    printf("\r%s", buffer);  // \r로 현재 줄 덮어쓰기
+    printf("> ");            // 프롬프트 재출력
+    fflush(stdout);
+
+    /* ============== 수신받은 메시지를 LCD에 출력 ===============*/
+    if(bytes_received > 16){
+        // LCD에 출력하기에 너무 긴 문자열이 온것 (welcom msg일 가능성)
+        // LCD에는 출력하지 않는다
+    }else{
+        lcd_write_line1(buffer);
     }
+    return 0;
+}
+
+// ================= 키 입력 → 메시지 =================
+
+// 키패드 쓰레드는 키 이벤트만 큐에 넣고, 메시지는 여기(이벤트 루프)에서 조립함
+#define INPUT_MAX   16          // 메시지 최대 길이 (LCD 한 줄)
+
+static char input_buf[INPUT_MAX + 1];   // 입력 중인 메시지
+static int input_len;
+
+// 키 → 전송 지연 (전송 키를 뗀 시각부터 send 완료까지)
+static unsigned long sent_lines;
+static uint64_t send_latency_sum, send_latency_max;
+
+// 입력 중인 메시지 전송 (서버는 개행까지를 메시지 하나로 처리)
+// 반환값: 0 = 계속, -1 = 전송 실패
+static int send_input(int socket, uint64_t key_ns) {
+    if (input_len == 0) return 0;
+    char line[INPUT_MAX + 2];
+    int line_len = snprintf(line, sizeof(line), "%s\n", input_buf);
     
-    if (bytes_received == 0) {
-        printf("\n서버와의 연결이 종료되었습니다.\n");
-    } else if (bytes_received < 0 && running) {
-        perror("\n수신 오류");
+    if (send(socket, line, line_len, 0) < 0) {
+        perror("전송 실패");
+        return -1;
     }
+    uint64_t latency = keypad_now_ns() - key_ns;
+    sent_lines++;
+    send_latency_sum += latency;
+    if (latency > send_latency_max) send_latency_max = latency;
     
-    running = 0;
-    printf("\n클라이언트를 종료합니다...\n");
-    return NULL;
+    // 전송 후 입력 정리
+    input_len = 0;
+    input_buf[0] = '\0';
+    lcd_clear_line2();
+    return 0;
+}
+
+// 숫자 하나 입력
+// 가득 찼으면 지금까지를 먼저 보내고 이 키부터 새 메시지 (키를 버리지 않음)
+static int append_digit(int socket, const key_event *ev) {
+    if (input_len >= INPUT_MAX && send_input(socket, ev->ns) < 0) return -1;
+    input_buf[input_len++] = ev->key;
+    input_buf[input_len] = '\0';
+    lcd_write_line2(input_buf);     // LCD에 현재 입력 표시
+    return 0;
+}
+
+// 키 이벤트 하나 처리
+// - 숫자: 누를 때 바로 입력 (여러 키를 겹쳐 눌러도 누른 순서대로), 누르고 있으면 자동 반복
+// - SEND: 뗄 때 전송, 길게 누르면 입력을 지우고 이번 뗌은 전송하지 않음
+// - END: 뗄 때 종료
+// 반환값: 0 = 계속, -1 = 종료 (END 키, 전송 실패)
+static int handle_key(int socket, const key_event *ev) {
+    static int send_cancelled;      // SEND를 길게 눌러 입력을 지움
+    int digit = ev->key >= '0' && ev->key <= '9';
+    
+    switch (ev->type) {
+    case KEY_PRESS:
+    case KEY_REPEAT:
+        if (digit) return append_digit(socket, ev);
+        break;
+    case KEY_LONG:
+        if (ev->key == SEND) {
+            input_len = 0;
+            input_buf[0] = '\0';
+            lcd_clear_line2();
+            send_cancelled = 1;
+        }
+        break;
+    case KEY_RELEASE:
+        if (ev->key == SEND) {
+            if (send_cancelled) {
+                send_cancelled = 0;
+                return 0;
+            }
+            return send_input(socket, ev->ns);
+        } else if (ev->key == END_SIGN) {
+            // 종료 버튼을 누른 상황 -> 프로그램 종료
+            printf("연결을 종료합니다...\n");
+            return -1;
+        }
+        break;
+    }
+    return 0;
+}
+
+// 쌓인 키 이벤트를 모두 처리
+static int drain_keys(int socket) {
+    key_event ev;
+    key_queue_drain_wake(&key_events);
+    while (key_queue_pop(&key_events, &ev)) {
+        if (handle_key(socket, &ev) < 0) return -1;
+    }
+    return 0;
+}
+
+// 실행 시간 대비 CPU 사용률 출력 (키패드 스캔 쓰레드 포함)
+static void print_cpu_usage(const struct timespec *started) {
+    struct rusage ru;
+    struct timespec now;
+    getrusage(RUSAGE_SELF, &ru);
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    
+    double cpu = ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6
+               + ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6;
+    double wall = (now.tv_sec - started->tv_sec) + (now.tv_nsec - started->tv_nsec) / 1e9;
+    printf("CPU 사용: %.2f초 / 실행 %.1f초 (%.1f%%)\n", cpu, wall, wall > 0 ? cpu * 100.0 / wall : 0.0);
+}
+
+// epoll에 읽기 이벤트 등록
+static int watch_fd(int ep, int fd) {
+    struct epoll_event ev = { .events = EPOLLIN, .data.fd = fd };
+    return epoll_ctl(ep, EPOLL_CTL_ADD, fd, &ev);
 }
 
 // 화면 지우기 함수 (선택적)
@@ -68,7 +209,7 @@ void clear_screen() {
 
 int main(int argc, char *argv[]) {
     struct sockaddr_in server_addr;
-    pthread_t receive_thread;
+    struct timespec started;
     char server_ip[20] = "127.0.0.1";  // 기본값: localhost
     int port = 8080;
     
@@ -80,6 +221,27 @@ int main(int argc, char *argv[]) {
     if (argc > 2) {
         port = atoi(argv[2]);
     }
+    int pager_id = (argc > 3) ? atoi(argv[3]) : 0;    // 호출번호 (없으면 등록 안 함)
+    // 호출번호 비밀번호 (명령줄에 남기지 않으려면 PAGER_SECRET 환경 변수로)
+    const char *pager_secret = (argc > 4) ? argv[4] : getenv("PAGER_SECRET");
+    if (pager_id > 0 && (!pager_secret || !*pager_secret)) {
+        fprintf(stderr, "호출번호 %d의 비밀번호가 없어 등록하지 않습니다 (네 번째 인자 또는 PAGER_SECRET)\n", pager_id);
+        pager_id = 0;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &started);
+
+    // 종료 시그널은 핸들러 대신 signalfd로 이벤트 루프에서 받음
+    // (키패드 쓰레드를 만들기 전에 막아야 모든 쓰레드에 적용됨)
+    sigset_t stop_signals;
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGINT);
+    sigaddset(&stop_signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stop_signals, NULL);
+    int signal_fd = signalfd(-1, &stop_signals, SFD_CLOEXEC);
+    if (signal_fd < 0) {
+        perror("signalfd 생성 실패");
+        exit(1);
+    }
 
     // ========= keypad 초기화 ==========
     keypad_init();
@@ -93,9 +255,6 @@ int main(int argc, char *argv[]) {
     printf("==================================\n");
     printf("서버 주소: %s:%d\n", server_ip, port);
     
-    // 시그널 핸들러 등록
-    signal(SIGINT, handle_shutdown);
-    
     // 소켓 생성
     client_socket = socket(AF_INET, SOCK_STREAM, 0);
     if (client_socket < 0) {
@@ -126,54 +285,68 @@ int main(int argc, char *argv[]) {
     printf("서버에 연결되었습니다!\n");
     printf("----------------------------------\n");
     
-    // 수신 쓰레드 시작
-    if (pthread_create(&receive_thread, NULL, receive_messages, &client_socket) != 0) {
-        perror("수신 쓰레드 생성 실패");
+    // 이벤트 루프 - 소켓 수신, 키 이벤트, 종료 시그널을 epoll 하나로 기다림
+    // (할 일이 없으면 잠들어 있으므로 CPU를 쓰지 않고, 전송 키는 눌린 즉시 처리됨)
+    int ep = epoll_create1(EPOLL_CLOEXEC);
+    if (ep < 0 || watch_fd(ep, client_socket) < 0 || watch_fd(ep, key_events.wake_fd) < 0 ||
+        watch_fd(ep, signal_fd) < 0) {
+        perror("epoll 설정 실패");
         close(client_socket);
         exit(1);
     }
     
-    // 잠시 대기 (서버 환영 메시지 수신)
-    sleep(1);
+    // 호출번호 등록 - 꺼져 있는 동안 온 메시지를 받음
+    if (pager_id > 0) {
+        char register_msg[96];
+        int len = snprintf(register_msg, sizeof(register_msg), "/register %d %s\n", pager_id, pager_secret);
+        if (len > 0 && (size_t)len < sizeof(register_msg)) send(client_socket, register_msg, len, 0);
+    }
     
-    // 사용자 입력 처리
     while (running) {
-        if(is_send){
-            // 사용자가 keypad 입력을 끝냄 -> 서버로 메시지 전송
-            // 서버로 전송
-            if (send(client_socket, input_buf, strlen(input_buf), 0) < 0) {
-                perror("전송 실패");
-                break;
-            }
-
-            // 전송 후 keypad 문자열 정리
-            clear_keypad_str();
-
-        }
-        // 입력중에는 할게 없음
-
-        if(!keepRunning){
-            // 종료 버튼을 누른 상황 -> 프로그램 종료
-            printf("연결을 종료합니다...\n");
-            running = 0;
+        struct epoll_event events[MAX_EVENTS];
+        int n = epoll_wait(ep, events, MAX_EVENTS, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait 실패");
             break;
         }
+        
+        for (int i = 0; i < n && running; i++) {
+            int fd = events[i].data.fd;
+            
+            if (fd == client_socket) {
+                // 서버 메시지 수신
+                if (receive_messages(client_socket) < 0) running = 0;
+            } else if (fd == key_events.wake_fd) {
+                // 키 이벤트 - 입력 조립, 전송(SEND), 종료(END)
+                if (drain_keys(client_socket) < 0) running = 0;
+            } else if (fd == signal_fd) {
+                // Ctrl+C 등 종료 시그널
+                struct signalfd_siginfo si;
+                read(signal_fd, &si, sizeof(si));
+                running = 0;
+            }
+        }
+    }
+    
+    printf("\n클라이언트를 종료합니다...\n");
+    print_cpu_usage(&started);
+    if (sent_lines > 0) {
+        printf("키→전송 지연: %lu건, 평균 %.1fus, 최대 %.1fus (버린 키 이벤트 %lu)\n", sent_lines,
+               send_latency_sum / 1e3 / sent_lines, send_latency_max / 1e3, key_events.dropped);
     }
-
-    printf("while 탈출\n");
     
     // 정리
     running = 0;
-    shutdown(client_socket, SHUT_RDWR); // running = 0을 했음에도 수신스레드가 종료되지 않는 현상때문에 추가
+    keypad_stop();                      // 키패드 쓰레드 종료 (대기 중이면 깨움)
+    close(ep);
+    close(signal_fd);
+    shutdown(client_socket, SHUT_RDWR);
     close(client_socket);
     printf("소켓 닫기 완료\n");
 
     pthread_join(keypad_tid, NULL);
     printf("키패드스레드 종료\n");
     
-    pthread_join(receive_thread, NULL);
-    printf("수신스레드 종료\n");
-    
-    
     return 0;
 }
\ No newline at end of file
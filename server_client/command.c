@@ -0,0 +1,397 @@
+// command.c - 채팅 명령어 디스패처
+
+#include "server.h"
+
+// ================= 명령어 핸들러 =================
+
+// 사용자에게 시스템 안내 한 줄 전송
+static void reply(int index, const char *msg) {
+    client_send(index, msg, strlen(msg));
+}
+
+static int cmd_quit(int index, cmd_args *args) {
+    log_printf(LOG_INFO, "[클라이언트 %d] 연결 종료 요청", client_at(index)->id);
+    return -1;
+}
+
+static int cmd_name(int index, cmd_args *args) {
+    client_info *client = client_at(index);
+    char old_name[NAME_SIZE];
+    strcpy(old_name, client->name);
+    registry_set_name(index, args->rest);
+    roster_update(index);
+
+    msgbuf *name_msg = msgbuf_printf("[시스템] %s님이 이름을 %s(으)로 변경했습니다.\n",
+                                     old_name, client->name);
+    broadcast_message(name_msg, -1);
+    if (name_msg) msgbuf_put(name_msg);
+    rate_charge_fanout((unsigned long)registry_count());
+    return 0;
+}
+
+// /list [쪽] [이름 앞부분] - 순서는 상관없음 (숫자면 쪽 번호)
+static int cmd_list(int index, cmd_args *args) {
+    int page = 1;
+    char *prefix = NULL, *save;
+    for (char *tok = strtok_r(args->rest, " ", &save); tok; tok = strtok_r(NULL, " ", &save)) {
+        char *end;
+        long n = strtol(tok, &end, 10);
+        if (*end == '\0' && n > 0 && n <= INT32_MAX) page = (int)n;
+        else prefix = tok;
+    }
+    msgbuf *list = roster_page(page, prefix);
+    client_send_buf(index, list);
+    if (list) msgbuf_put(list);
+    return 0;
+}
+
+static int cmd_msg(int index, cmd_args *args) {
+    client_info *client = client_at(index);
+    char *end;
+    long target_id = strtol(args->argv[0], &end, 10);
+    if (*end != '\0' || target_id <= 0 || target_id > CLIENT_ID_MAX) {
+        reply(index, "[시스템] 사용법: /msg <ID> <메시지>\n");
+        return 0;
+    }
+
+    msgbuf *private_msg = msgbuf_printf("[귓속말 from %s(ID:%d)] %s\n",
+                                        client->name, client->id, args->rest);
+    send_to_client(private_msg, (int)target_id, client->id);
+    if (private_msg) msgbuf_put(private_msg);
+
+    // 발신자에게 확인 메시지
+    msgbuf *confirm_msg = msgbuf_printf("[귓속말 to ID:%ld] %s\n", target_id, args->rest);
+    client_send_buf(index, confirm_msg);
+    if (confirm_msg) msgbuf_put(confirm_msg);
+    return 0;
+}
+
+// 보관 페이지 하나 전달 (keep 버퍼라 송신 대기열이 버리지 않음)
+static int replay_page(void *arg, msgbuf *page) {
+    return client_send_buf(*(int *)arg, page);
+}
+
+// /register <호출번호> <비밀번호> - 처음 등록한 비밀번호를 아는 연결만 그 번호와 보관 페이지를 받음
+static int cmd_register(int index, cmd_args *args) {
+    char *end;
+    long id = strtol(args->argv[0], &end, 10);
+    const char *secret = args->argv[1];
+    if (*end != '\0' || id <= 0 || id > CLIENT_ID_MAX || strlen(secret) > PAGELOG_SECRET_MAX) {
+        char usage[128];
+        snprintf(usage, sizeof(usage), "[시스템] 사용법: /register <호출번호> <비밀번호> (1~%d, 비밀번호 %d바이트 이하)\n",
+                 CLIENT_ID_MAX, PAGELOG_SECRET_MAX);
+        reply(index, usage);
+        return 0;
+    }
+
+    // 번호가 비어 있는지 확인하고 자리를 잡아 둔 채(clients_mutex) 비밀번호를 확인/기록한 뒤 바꿈
+    // → 등록이 실패하면 소유자를 기록하지 않고, 비밀번호가 틀리면 ID를 바꾸지 않음
+    //   (잠깐이라도 바꿨다가 되돌리면 그 사이 /msg가 이 연결로 올 수 있음)
+    char result_msg[160];
+    int claim = PAGELOG_DENIED;
+    pthread_mutex_lock(&clients_mutex);
+    int ret = registry_prepare_id(index, (int)id);
+    if (ret == 0) {
+        claim = pagelog_claim((int)id, secret);
+        if (claim != PAGELOG_DENIED) registry_set_id(index, (int)id);  // 자리를 잡아 두었으므로 실패하지 않음
+    }
+    pthread_mutex_unlock(&clients_mutex);
+
+    if (ret < 0) {
+        snprintf(result_msg, sizeof(result_msg), "[시스템] 호출번호 %ld는 이미 사용 중입니다.\n", id);
+        reply(index, result_msg);
+        return 0;
+    }
+    if (claim == PAGELOG_DENIED) {
+        snprintf(result_msg, sizeof(result_msg), "[시스템] 호출번호 %ld의 비밀번호가 맞지 않습니다.\n", id);
+        reply(index, result_msg);
+        return 0;
+    }
+    roster_update(index);
+    snprintf(result_msg, sizeof(result_msg), "[시스템] 호출번호 %ld로 등록되었습니다.\n", id);
+    reply(index, result_msg);
+
+    // 접속해 있지 않은 동안 보관된 호출 전달 - 송신 대기열 여유만큼씩 나눠 넣음
+    // (thread/epoll은 넣으면서 바로 보내므로 여유가 다시 생기고, io_uring은 다음 배치에 보냄)
+    int count = 0, left = 0, n;
+    do {
+        n = pagelog_replay((int)id, client_send_room(index), replay_page, &index, &left);
+        count += n;
+    } while (n > 0 && left > 0);
+
+    if (count > 0) {
+        snprintf(result_msg, sizeof(result_msg), "[시스템] 보관된 메시지 %d건을 전달했습니다.\n", count);
+        reply(index, result_msg);
+    }
+    if (left > 0) {
+        snprintf(result_msg, sizeof(result_msg),
+                 "[시스템] 송신 대기열이 가득 차 %d건이 남았습니다. 잠시 뒤 /register %ld <비밀번호>로 이어서 받으세요.\n",
+                 left, id);
+        reply(index, result_msg);
+    }
+    return 0;
+}
+
+// group_join/group_leave 결과 안내
+static void reply_group(int index, const char *name, int ret, const char *done, const char *already) {
+    char result_msg[160];
+    switch (ret) {
+    case GROUP_OK:
+        snprintf(result_msg, sizeof(result_msg), "[시스템] 그룹 %s%s\n", name, done);
+        break;
+    case GROUP_ALREADY:
+        snprintf(result_msg, sizeof(result_msg), "[시스템] 그룹 %s%s\n", name, already);
+        break;
+    case GROUP_BAD_NAME:
+        snprintf(result_msg, sizeof(result_msg), "[시스템] 그룹 이름은 %d바이트 미만이어야 합니다.\n", GROUP_NAME_SIZE);
+        break;
+    default:
+        snprintf(result_msg, sizeof(result_msg), "[시스템] 더 이상 그룹에 가입할 수 없습니다. (1인당 최대 %d개)\n", GROUP_PER_CLIENT);
+        break;
+    }
+    reply(index, result_msg);
+}
+
+static int cmd_join(int index, cmd_args *args) {
+    int ret = group_join(index, args->argv[0]);
+    reply_group(index, args->argv[0], ret, "에 가입했습니다.", "에 이미 가입되어 있습니다.");
+    return 0;
+}
+
+static int cmd_leave(int index, cmd_args *args) {
+    int ret = group_leave(index, args->argv[0]);
+    reply_group(index, args->argv[0], ret, "에서 탈퇴했습니다.", "에 가입되어 있지 않습니다.");
+    return 0;
+}
+
+static int cmd_page(int index, cmd_args *args) {
+    client_info *client = client_at(index);
+    const char *name = args->argv[0];
+    // 한 번만 포맷하고 가입자 모두와 발신자가 같은 버퍼를 공유
+    msgbuf *page_msg = msgbuf_printf("[그룹 %s] %s(ID:%d): %s\n",
+                                     name, client->name, client->id, args->rest);
+    int sent = group_send(name, page_msg, index);
+    if (sent < 0) {
+        char error_msg[128];
+        snprintf(error_msg, sizeof(error_msg), "[시스템] 그룹 %s에 가입한 사람이 없습니다.\n", name);
+        reply(index, error_msg);
+    } else {
+        client_send_buf(index, page_msg);
+        rate_charge_fanout((unsigned long)sent + 1);
+    }
+    if (page_msg) msgbuf_put(page_msg);
+    return 0;
+}
+
+static int cmd_all(int index, cmd_args *args) {
+    client_info *client = client_at(index);
+    // 한 번만 포맷하고 발신자를 포함한 모든 수신자가 같은 버퍼를 공유
+    msgbuf *broadcast_msg = msgbuf_printf("[전체] %s(ID:%d): %s\n",
+                                          client->name, client->id, args->rest);
+    broadcast_message(broadcast_msg, client->id);
+    client_send_buf(index, broadcast_msg);
+    if (broadcast_msg) msgbuf_put(broadcast_msg);
+    rate_charge_fanout((unsigned long)registry_count());
+    return 0;
+}
+
+static int cmd_queue(int index, cmd_args *args) {
+    outq_stats st;
+    unsigned long buf_live, buf_bytes;
+    pagelog_stats ps;
+    rate_stats rs;
+    outq_get_stats(&st);
+    msgbuf_get_stats(&buf_live, &buf_bytes);
+    pagelog_get_stats(&ps);
+    rate_get_stats(&rs);
+    msgbuf *queue_msg = msgbuf_printf(
+            "[시스템] 송신 대기열 (정책: %s, 최대 %u)\n"
+            "전체 대기: %lu, 최대 대기(클라이언트당): %lu\n"
+            "누적 추가: %lu, 전송: %lu, 버림: %lu, 초과로 종료: %lu\n"
+            "공유 메시지 버퍼: %lu개, %lu바이트\n"
+            "보관 메시지: 대기 %lu, 누적 보관 %lu, 전달 %lu, 디스크 반영 %lu회, 로그 %lu바이트\n"
+            "속도 제한 거절: 채팅 %lu, 전체 %lu, 귓속말 %lu, fanout 예산 초과 %lu\n",
+            outq_policy_name(outq_policy), outq_max_depth,
+            st.depth, st.peak, st.enqueued, st.sent, st.dropped, st.disconnects,
+            buf_live, buf_bytes,
+            ps.pending, ps.stored, ps.delivered, ps.commits, ps.bytes,
+            rs.limited[RATE_CHAT], rs.limited[RATE_BROADCAST], rs.limited[RATE_PRIVATE],
+            rs.fanout_limited);
+    client_send_buf(index, queue_msg);
+    if (queue_msg) msgbuf_put(queue_msg);
+    return 0;
+}
+
+static int cmd_stats(int index, cmd_args *args) {
+    char *text;
+    int len = stats_format(&text);
+    if (len < 0) return 0;
+    msgbuf *stats_msg = msgbuf_new(text, (size_t)len);
+    free(text);
+    client_send_buf(index, stats_msg);
+    if (stats_msg) msgbuf_put(stats_msg);
+    return 0;
+}
+
+static int cmd_help(int index, cmd_args *args) {
+    char help_msg[1024];
+    int len = snprintf(help_msg, sizeof(help_msg), "[명령어]\n");
+    len += command_help(help_msg + len, sizeof(help_msg) - len);
+    client_send(index, help_msg, (size_t)len);
+    return 0;
+}
+
+// ================= 명령어 표 =================
+
+static const command commands[] = {
+    // 이름       핸들러         단어 인자  나머지 줄  사용법                   설명                                  속도 제한       풀
+    { "/name",  cmd_name,      0,        1,        "/name <이름>",          "이름 변경",                          RATE_BROADCAST, 0 },
+    { "/list",  cmd_list,      0,        0,        "/list [쪽] [이름]",     "접속자 목록 (쪽, 이름 앞부분)",      RATE_BROADCAST, 1 },
+    { "/msg",   cmd_msg,       1,        1,        "/msg <ID> <메시지>",    "개인 메시지",                        RATE_PRIVATE,   0 },
+    { "/all",   cmd_all,       0,        1,        "/all <메시지>",         "전체 메시지",                        RATE_BROADCAST, 1 },
+    { "/join",  cmd_join,      1,        0,        "/join <그룹>",          "그룹 가입",                          RATE_PRIVATE,   0 },
+    { "/leave", cmd_leave,     1,        0,        "/leave <그룹>",         "그룹 탈퇴",                          RATE_PRIVATE,   0 },
+    { "/page",  cmd_page,      1,        1,        "/page <그룹> <메시지>", "그룹 호출",                          RATE_BROADCAST, 1 },
+    { "/register", cmd_register, 2,      0,        "/register <호출번호> <비밀번호>",  "호출번호 등록 (보관된 메시지 받기)", RATE_PRIVATE,   0 },
+    { "/queue", cmd_queue,     0,        0,        "/queue",                "송신 대기열 상태",                   RATE_NONE,      0 },
+    { "/stats", cmd_stats,     0,        0,        "/stats",                "서버 통계 (지연 분포, 카운터)",      RATE_BROADCAST, 1 },
+    { "/help",  cmd_help,      0,        0,        "/help",                 "명령어 안내",                        RATE_NONE,      0 },
+    { "/quit",  cmd_quit,      0,        0,        "/quit",                 "종료",                               RATE_NONE,      0 },
+};
+
+#define NCOMMANDS   (int)(sizeof(commands) / sizeof(commands[0]))
+_Static_assert(NCOMMANDS <= STATS_MAX_COMMANDS, "명령어별 히스토그램이 모자람 (STATS_MAX_COMMANDS)");
+
+// ================= 해시 색인 =================
+
+static signed char cmd_slot[CMD_HASH_SLOTS];    // 해시 → commands[] 번호 (-1: 없음)
+static uint32_t cmd_seed;
+
+// FNV-1a (seed를 초기값에 섞음)
+static inline unsigned cmd_hash(const char *s, size_t len, uint32_t seed) {
+    uint32_t h = 2166136261u ^ seed;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (unsigned char)s[i];
+        h *= 16777619u;
+    }
+    return h & (CMD_HASH_SLOTS - 1);
+}
+
+/**
+ * command_init - 명령어 이름 해시 색인 생성
+ * @return: 0 성공, -1 충돌 없는 seed를 찾지 못함 (CMD_HASH_SLOTS를 늘려야 함)
+ *
+ * 모든 명령어가 서로 다른 칸에 들어가는 seed를 찾으므로 조회는 해시 한 번과
+ * 문자열 비교 한 번으로 끝납니다.
+ */
+int command_init(void) {
+    for (uint32_t seed = 0; seed < 4096; seed++) {
+        memset(cmd_slot, -1, sizeof(cmd_slot));
+        int ok = 1;
+        for (int i = 0; i < NCOMMANDS && ok; i++) {
+            unsigned h = cmd_hash(commands[i].name, strlen(commands[i].name), seed);
+            if (cmd_slot[h] >= 0) ok = 0;
+            else cmd_slot[h] = (signed char)i;
+        }
+        if (ok) {
+            cmd_seed = seed;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+// 명령어 이름으로 표 항목 찾기
+static const command *command_find(const char *name, size_t len) {
+    int i = cmd_slot[cmd_hash(name, len, cmd_seed)];
+    if (i < 0) return NULL;
+    const command *cmd = &commands[i];
+    if (strncmp(cmd->name, name, len) != 0 || cmd->name[len] != '\0') return NULL;
+    return cmd;
+}
+
+// ================= 디스패치 =================
+
+// 작업 풀에서 실행할 명령어인지 (line: '/'로 시작하는 메시지, 수정하지 않음)
+int command_pooled(const char *line) {
+    size_t len = strcspn(line, " \t");
+    const command *cmd = command_find(line, len);
+    return cmd && cmd->pooled;
+}
+
+// 명령어의 속도 제한 종류 (알 수 없는 명령어는 RATE_NONE - 안내만 보냄)
+int command_rate_class(const char *line) {
+    size_t len = strcspn(line, " \t");
+    const command *cmd = command_find(line, len);
+    return cmd ? cmd->rate_class : RATE_NONE;
+}
+
+static inline int is_space(char c) {
+    return c == ' ' || c == '\t';
+}
+
+/**
+ * command_dispatch - 명령어 한 줄 실행
+ * @index: 보낸 클라이언트 인덱스
+ * @line: '/'로 시작하는 메시지 (인자를 나누면서 내용이 바뀜)
+ * @return: 0 = 계속, -1 = 연결 종료 요청
+ *
+ * 속도 제한은 받은 I/O 루프가 작업 풀에 넘기기 전에 이미 확인했습니다 (command_rate_class).
+ */
+int command_dispatch(int index, char *line) {
+    char *p = line;
+    while (*p && !is_space(*p)) p++;
+
+    const command *cmd = command_find(line, (size_t)(p - line));
+    if (!cmd) {
+        reply(index, "[시스템] 알 수 없는 명령어입니다. /help로 도움말을 확인하세요.\n");
+        return 0;
+    }
+    uint64_t start = stats_now();
+
+    // 단어 인자를 제자리에서 나누고, 남은 부분은 그대로 rest로 넘김
+    cmd_args args;
+    args.argc = 0;
+    while (args.argc < cmd->nargs) {
+        while (is_space(*p)) *p++ = '\0';
+        if (*p == '\0') break;
+        args.argv[args.argc++] = p;
+        while (*p && !is_space(*p)) p++;
+    }
+    while (is_space(*p)) *p++ = '\0';
+    args.rest = p;
+
+    if (args.argc < cmd->nargs || (cmd->need_rest && *args.rest == '\0')) {
+        char usage_msg[128];
+        snprintf(usage_msg, sizeof(usage_msg), "[시스템] 사용법: %s\n", cmd->usage);
+        reply(index, usage_msg);
+        return 0;
+    }
+    int ret = cmd->fn(index, &args);
+    stats_record(STAT_COMMAND + (int)(cmd - commands), stats_now() - start);
+    return ret;
+}
+
+/**
+ * command_help - 명령어 안내문 작성 ("사용법 - 설명" 한 줄씩)
+ * @out: 출력 버퍼
+ * @size: 버퍼 크기
+ * @return: 쓴 길이 (버퍼가 모자라면 들어간 만큼)
+ */
+int command_help(char *out, size_t size) {
+    size_t len = 0;
+    for (int i = 0; i < NCOMMANDS && len < size; i++) {
+        int n = snprintf(out + len, size - len, "%s - %s\n", commands[i].usage, commands[i].help);
+        if (n < 0) break;
+        len += (size_t)n;
+    }
+    return len < size ? (int)len : (int)size - 1;
+}
+
+int command_count(void) {
+    return NCOMMANDS;
+}
+
+const char *command_name(int i) {
+    return commands[i].name;
+}
@@ -0,0 +1,58 @@
+// command.h - 채팅 명령어 디스패처 헤더 파일
+//
+// '/'로 시작하는 메시지를 명령어 표(command.c의 commands[])에서 찾아 실행합니다.
+// - 명령어 표는 컴파일 시 고정된 상수 배열 (이름, 핸들러, 인자 형식, 도움말)
+// - 명령어 이름 → 표 항목은 충돌 없는 해시(perfect hash)로 한 번에 찾음
+//   (시작 시 충돌이 없는 seed를 골라 색인을 만들어 두므로 명령어를 추가해도 그대로 동작)
+// - 인자는 받은 버퍼 안에서 공백을 NULL로 바꿔 나누므로 메모리 할당이 없음
+// - /help와 접속 시 안내문은 명령어 표에서 만들어짐
+// - 명령어마다 속도 제한 종류가 있어 받은 I/O 루프가 실행(작업 풀에 넘기기) 전에 token bucket으로 거름
+// - 접속자 수에 비례하는 명령어는 표에 표시해 두면 작업 풀에서 실행됨 (workpool.h)
+//
+// 명령어 추가: command.c에 핸들러를 만들고 commands[]에 한 줄 추가
+
+#ifndef COMMAND_H
+#define COMMAND_H
+
+#include <stddef.h>
+
+// ================= 설정 =================
+
+#define CMD_MAX_ARGS        4               // 명령어 하나의 최대 단어 인자 수
+#define CMD_HASH_SLOTS      64              // 해시 색인 크기 (2의 거듭제곱, 명령어 수보다 충분히 크게)
+
+// ================= 자료 구조 =================
+
+// 나눈 인자 - 모두 받은 메시지 버퍼 안을 가리킴
+typedef struct {
+    int argc;                   // 단어 인자 수
+    char *argv[CMD_MAX_ARGS];   // 공백으로 나눈 단어 인자
+    char *rest;                 // 단어 인자 뒤의 나머지 줄 전체 (없으면 "")
+} cmd_args;
+
+// 명령어 핸들러: 반환값 0 = 계속, -1 = 연결 종료 요청
+typedef int (*cmd_handler)(int index, cmd_args *args);
+
+// 명령어 표 항목
+typedef struct {
+    const char *name;           // "/msg"
+    cmd_handler fn;
+    int nargs;                  // 필요한 단어 인자 수
+    int need_rest;              // 1이면 나머지 줄이 비어 있으면 안 됨
+    const char *usage;          // "/msg <ID> <메시지>"
+    const char *help;           // "개인 메시지"
+    int rate_class;             // 속도 제한 종류 (RATE_*, ratelimit.h)
+    int pooled;                 // 1이면 작업 풀에서 실행 (접속자 수에 비례하는 작업)
+} command;
+
+// ================= 함수 선언 =================
+
+int  command_init(void);                            // 해시 색인 생성 (-1: 충돌 없는 seed 없음)
+int  command_dispatch(int index, char *line);       // 명령어 실행 (-1: 연결 종료 요청)
+int  command_pooled(const char *line);              // 작업 풀에서 실행할 명령어인지
+int  command_rate_class(const char *line);          // 명령어의 속도 제한 종류 (RATE_*)
+int  command_help(char *out, size_t size);          // 명령어 안내문 작성 (길이 반환)
+int  command_count(void);                           // 명령어 표 항목 수 (지표용)
+const char *command_name(int i);                    // 명령어 표 i번째 이름
+
+#endif // COMMAND_H
@@ -0,0 +1,184 @@
+// frame.c - 수신 스트림 프레이밍 (연결별 링 버퍼 재조립)
+
+#include "frame.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+
+#define RING_MASK   (FRAME_RING_SIZE - 1)
+
+// 메시지 하나를 NULL 종료시켜 핸들러에 전달 (종료자 자리의 원래 바이트는 복원)
+// p[len]은 다음 프레임의 첫 바이트일 수 있으므로 덮어쓴 뒤 되돌려 놓음
+static int deliver(char *p, size_t len, frame_handler fn, void *arg) {
+    char saved = p[len];
+    p[len] = '\0';
+    int ret = fn(arg, p, len);
+    p[len] = saved;
+    return ret;
+}
+
+/**
+ * parse_linear - 연속된 메모리에서 완성된 프레임을 모두 처리
+ * @data: 수신 데이터 (data[len] 한 바이트를 임시로 쓸 수 있어야 함)
+ * @len: 데이터 길이
+ * @consumed: 처리한 바이트 수 (끝에 남은 미완성 프레임은 제외)
+ * @return: 0 = 계속, -1 = 핸들러가 중단을 요청했거나 프로토콜 오류
+ */
+static int parse_linear(char *data, size_t len, size_t *consumed, frame_handler fn, void *arg) {
+    size_t off = 0;
+    int ret = 0;
+
+    while (off < len && ret >= 0) {
+        char *p = data + off;
+        size_t avail = len - off;
+
+        if ((unsigned char)p[0] == FRAME_BINARY) {
+            if (avail < FRAME_HDR_SIZE) break;
+            size_t n = ((size_t)(unsigned char)p[1] << 8) | (unsigned char)p[2];
+            if (n > FRAME_MAX) {
+                ret = -1;                   // 잘못된 길이 - 이후 스트림을 신뢰할 수 없음
+                break;
+            }
+            if (avail < FRAME_HDR_SIZE + n) break;
+            ret = deliver(p + FRAME_HDR_SIZE, n, fn, arg);
+            off += FRAME_HDR_SIZE + n;
+            continue;
+        }
+
+        // 텍스트: 개행까지가 한 프레임. 개행 없이 최대 길이를 넘으면 그만큼 잘라서 처리
+        size_t scan = avail < FRAME_MAX + 1 ? avail : FRAME_MAX + 1;
+        char *nl = memchr(p, '\n', scan);
+        if (nl) {
+            size_t n = (size_t)(nl - p);
+            off += n + 1;
+            if (n > 0 && p[n - 1] == '\r') n--;
+            ret = deliver(p, n, fn, arg);
+        } else if (avail > FRAME_MAX) {
+            off += FRAME_MAX;
+            ret = deliver(p, FRAME_MAX, fn, arg);
+        } else {
+            break;
+        }
+    }
+
+    *consumed = off;
+    return ret < 0 ? -1 : 0;
+}
+
+// 버퍼가 이미 있으면(재사용하는 세션 슬롯) 비우기만 함
+int frame_rx_init(frame_rx *rx) {
+    // 링 뒤 여유 공간: 링 끝에서 잘린 프레임 이어 붙이기 + NULL 종료자 1바이트
+    if (!rx->buf) rx->buf = malloc(FRAME_RING_SIZE + FRAME_WIRE_MAX + 1);
+    rx->head = rx->tail = 0;
+    return rx->buf ? 0 : -1;
+}
+
+void frame_rx_destroy(frame_rx *rx) {
+    free(rx->buf);
+    rx->buf = NULL;
+}
+
+/**
+ * frame_rx_read - 소켓에서 링의 빈 공간으로 읽기
+ * @rx: 수신 링
+ * @fd: 소켓
+ * @return: recv와 같음 (읽은 바이트 수, 0 = 연결 종료, -1 = 오류/EAGAIN)
+ *
+ * 빈 공간이 링 끝에서 나뉘어 있으면 readv로 두 조각을 한 번에 채웁니다.
+ */
+ssize_t frame_rx_read(frame_rx *rx, int fd) {
+    size_t used = rx->tail - rx->head;
+    size_t space = FRAME_RING_SIZE - used;
+    unsigned off = rx->tail & RING_MASK;
+    size_t first = FRAME_RING_SIZE - off;
+
+    struct iovec iov[2];
+    int iovcnt = 1;
+    iov[0].iov_base = rx->buf + off;
+    iov[0].iov_len = first < space ? first : space;
+    if (first < space) {
+        iov[1].iov_base = rx->buf;
+        iov[1].iov_len = space - first;
+        iovcnt = 2;
+    }
+
+    ssize_t n;
+    do {
+        n = readv(fd, iov, iovcnt);
+    } while (n < 0 && errno == EINTR);
+    if (n > 0) rx->tail += (unsigned)n;
+    return n;
+}
+
+/**
+ * frame_rx_parse - 링에 쌓인 완성된 프레임을 모두 처리
+ * @rx: 수신 링
+ * @fn: 프레임 핸들러
+ * @arg: 핸들러 인자
+ * @return: 0 = 계속, -1 = 핸들러가 중단을 요청했거나 프로토콜 오류 (연결 종료)
+ */
+int frame_rx_parse(frame_rx *rx, frame_handler fn, void *arg) {
+    while (rx->tail != rx->head) {
+        size_t avail = rx->tail - rx->head;
+        unsigned off = rx->head & RING_MASK;
+        size_t contig = FRAME_RING_SIZE - off;
+        if (contig > avail) contig = avail;
+
+        size_t used;
+        int ret = parse_linear(rx->buf + off, contig, &used, fn, arg);
+        rx->head += (unsigned)used;
+        if (ret < 0) return -1;
+        if (used > 0) continue;
+        if (contig == avail) break;                 // 미완성 프레임 - 더 받아야 함
+
+        // 프레임이 링 끝에서 잘림 - 링 앞부분을 링 뒤 여유 공간에 이어 붙여 연속으로 만듦
+        size_t extra = avail - contig;
+        if (extra > FRAME_WIRE_MAX - contig) extra = FRAME_WIRE_MAX - contig;
+        memcpy(rx->buf + FRAME_RING_SIZE, rx->buf, extra);
+        ret = parse_linear(rx->buf + off, contig + extra, &used, fn, arg);
+        rx->head += (unsigned)used;
+        if (ret < 0) return -1;
+        if (used == 0) break;
+    }
+    return 0;
+}
+
+/**
+ * frame_rx_input - 외부 버퍼로 받은 데이터 처리 (io_uring 제공 버퍼 등)
+ * @rx: 수신 링 (이전에 남은 미완성 프레임)
+ * @data: 받은 데이터 (data[len] 한 바이트를 임시로 쓸 수 있어야 함)
+ * @len: 데이터 길이
+ * @return: frame_rx_parse와 같음
+ *
+ * 링이 비어 있으면 받은 버퍼에서 바로 프레임을 꺼내고, 끝에 남은 미완성 프레임만
+ * 링에 옮깁니다. 이어 받을 것이 있으면 링에 붙인 뒤 링에서 처리합니다.
+ */
+int frame_rx_input(frame_rx *rx, char *data, size_t len, frame_handler fn, void *arg) {
+    while (len > 0) {
+        if (rx->head == rx->tail) {
+            size_t used;
+            if (parse_linear(data, len, &used, fn, arg) < 0) return -1;
+            data += used;
+            len -= used;
+            rx->head = rx->tail = 0;
+        }
+
+        // 링 빈 공간만큼 복사 후 링에서 처리 (미완성 프레임은 FRAME_WIRE_MAX보다 작으므로 항상 진행)
+        size_t space = FRAME_RING_SIZE - (rx->tail - rx->head);
+        size_t n = len < space ? len : space;
+        for (size_t copied = 0; copied < n; ) {
+            unsigned off = rx->tail & RING_MASK;
+            size_t chunk = FRAME_RING_SIZE - off;
+            if (chunk > n - copied) chunk = n - copied;
+            memcpy(rx->buf + off, data + copied, chunk);
+            rx->tail += (unsigned)chunk;
+            copied += chunk;
+        }
+        data += n;
+        len -= n;
+        if (frame_rx_parse(rx, fn, arg) < 0) return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,50 @@
+// frame.h - 수신 스트림 프레이밍 헤더 파일
+//
+// TCP는 메시지 경계를 지키지 않으므로 recv 한 번이 메시지 하나라는 보장이 없습니다.
+// (여러 메시지가 한 번에 오거나, 메시지 하나가 나뉘어 올 수 있음)
+// 연결마다 수신 링 버퍼를 두고, 읽은 데이터에서 완성된 프레임을 모두 꺼내 처리합니다.
+//
+// 프레임 형식 (프레임마다 첫 바이트로 구분, 한 연결에서 섞어 써도 됨):
+// - 텍스트 : "메시지\n" ("\r\n"도 허용)
+// - 바이너리 : 0x00, 길이(2바이트 big-endian), 메시지 (길이는 FRAME_MAX 이하)
+//
+// 프레임은 복사하지 않고 버퍼 안에서 NULL 종료시켜 핸들러에 넘깁니다.
+// 링 끝에서 잘린 프레임 하나만 링 뒤 여유 공간에 이어 붙여 연속으로 만듭니다.
+
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+// ================= 설정 =================
+
+#define FRAME_MAX           1023            // 메시지 최대 길이 (BUFFER_SIZE - 1)
+#define FRAME_BINARY        0x00            // 바이너리 프레임 시작 바이트
+#define FRAME_HDR_SIZE      3               // 바이너리 헤더 (시작 바이트 + 길이 2바이트)
+#define FRAME_WIRE_MAX      (FRAME_HDR_SIZE + FRAME_MAX)    // 프레임 하나의 최대 전송 크기
+
+#define FRAME_RING_SIZE     4096            // 연결당 수신 링 크기 (2의 거듭제곱)
+
+// ================= 자료 구조 =================
+
+// 연결 하나의 수신 링 버퍼
+typedef struct {
+    char *buf;                  // FRAME_RING_SIZE + 잘린 프레임용 여유 공간
+    unsigned head;              // 다음에 처리할 위치 (계속 증가, 링 크기로 나눈 나머지 사용)
+    unsigned tail;              // 다음에 받을 위치
+} frame_rx;
+
+// 프레임 핸들러: msg는 NULL 종료된 메시지 (len 바이트), 반환값 < 0이면 처리 중단
+typedef int (*frame_handler)(void *arg, char *msg, size_t len);
+
+// ================= 함수 선언 =================
+
+int  frame_rx_init(frame_rx *rx);           // 버퍼가 이미 있으면 비우기만 함 (-1: 메모리 부족)
+void frame_rx_destroy(frame_rx *rx);
+
+ssize_t frame_rx_read(frame_rx *rx, int fd);    // 빈 공간으로 readv 한 번 (recv와 같은 반환값)
+int  frame_rx_parse(frame_rx *rx, frame_handler fn, void *arg);
+int  frame_rx_input(frame_rx *rx, char *data, size_t len, frame_handler fn, void *arg);
+
+#endif // FRAME_H
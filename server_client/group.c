@@ -0,0 +1,261 @@
+// group.c - 그룹 호출 채널 (구독 색인)
+//
+// 그룹 해시 버킷은 단일 연결 리스트이고, 새 그룹은 버킷 맨 앞에 붙입니다.
+// 읽기 쪽은 세션 테이블의 읽기 구간(registry_read_lock) 안에서 lock 없이
+// 버킷 → 그룹 → 가입자 배열 순으로 따라가며, 쓰기 쪽은 포인터를 바꾼 뒤
+// registry_synchronize로 읽기 구간이 끝나기를 기다렸다가 예전 것을 해제합니다.
+//
+// 가입자는 세션 슬롯 인덱스로 저장합니다. 퇴장 시 remove_client가 슬롯을 반환하기 전에
+// group_leave_all을 호출하므로 반환된 슬롯이 그룹에 남아 다른 사용자에게 가는 일은 없습니다.
+
+#include "server.h"
+
+// 가입자 배열 - 한 번 공개되면 바꾸지 않음 (메모리 부족으로 칸을 -1로 지울 때만 예외)
+typedef struct {
+    int count;
+    int index[];                // 가입한 클라이언트의 슬롯 인덱스 (-1: 지운 칸)
+} group_members;
+
+typedef struct group {
+    struct group *next;         // 같은 버킷의 다음 그룹
+    char name[GROUP_NAME_SIZE];
+    group_members *members;     // 가입자가 바뀌면 새 배열로 교체 (비어 있으면 그룹을 지움)
+} group;
+
+static group *buckets[GROUP_HASH_SIZE];
+static int ngroups;
+static pthread_mutex_t group_mutex = PTHREAD_MUTEX_INITIALIZER;    // 가입/탈퇴 직렬화
+
+// ================= 색인 =================
+
+// FNV-1a
+static unsigned group_hash(const char *name) {
+    uint32_t h = 2166136261u;
+    for (const char *p = name; *p; p++) {
+        h ^= (unsigned char)*p;
+        h *= 16777619u;
+    }
+    return h & (GROUP_HASH_SIZE - 1);
+}
+
+// 이름으로 그룹 찾기 (읽기 구간 안 또는 group_mutex를 잡고 호출)
+static group *group_find(const char *name, unsigned h) {
+    for (group *g = __atomic_load_n(&buckets[h], __ATOMIC_ACQUIRE); g;
+         g = __atomic_load_n(&g->next, __ATOMIC_ACQUIRE)) {
+        if (strcmp(g->name, name) == 0) return g;
+    }
+    return NULL;
+}
+
+static int members_has(const group_members *m, int index) {
+    for (int i = 0; i < m->count; i++) {
+        if (m->index[i] == index) return 1;
+    }
+    return 0;
+}
+
+// 지워지지 않은 가입자 수
+static int members_live(const group_members *m) {
+    int n = 0;
+    for (int i = 0; i < m->count; i++) {
+        if (m->index[i] >= 0) n++;
+    }
+    return n;
+}
+
+// 가입자 배열 복사본 생성 (drop과 지운 칸은 빼고 add는 끝에 추가, 해당 없으면 -1)
+static group_members *members_copy(const group_members *old, int drop, int add) {
+    int n = old ? old->count : 0;
+    group_members *m = malloc(sizeof(*m) + (size_t)(n + 1) * sizeof(int));
+    if (!m) return NULL;
+    m->count = 0;
+    for (int i = 0; i < n; i++) {
+        if (old->index[i] != drop && old->index[i] >= 0) m->index[m->count++] = old->index[i];
+    }
+    if (add >= 0) m->index[m->count++] = add;
+    return m;
+}
+
+/**
+ * group_drop_locked - 그룹에서 가입자 하나 빼기 (group_mutex 필요)
+ * @g: 그룹 (index가 가입되어 있어야 함)
+ * @h: 그룹 해시
+ * @index: 뺄 클라이언트 슬롯
+ * @retired: 읽기 구간이 끝난 뒤 해제할 포인터를 추가할 배열 (최대 2개 추가)
+ * @nretired: retired에 든 개수
+ *
+ * 새 배열을 만들 메모리가 없으면 공개된 배열의 해당 칸을 -1로 지움
+ * (읽기 쪽은 -1을 건너뜀) → 탈퇴는 항상 성공
+ */
+static void group_drop_locked(group *g, unsigned h, int index, void **retired, int *nretired) {
+    group_members *old = g->members;
+    if (members_live(old) == 1) {
+        // 마지막 가입자 → 그룹을 버킷에서 떼어냄 (읽는 중인 쪽은 g->next로 계속 진행 가능)
+        group **pp = &buckets[h];
+        while (*pp != g) pp = &(*pp)->next;
+        __atomic_store_n(pp, g->next, __ATOMIC_RELEASE);
+        ngroups--;
+        retired[(*nretired)++] = g;
+    } else {
+        group_members *m = members_copy(old, index, -1);
+        if (!m) {
+            for (int i = 0; i < old->count; i++) {
+                if (old->index[i] == index) __atomic_store_n(&old->index[i], -1, __ATOMIC_RELEASE);
+            }
+            client_at(index)->groups--;
+            return;
+        }
+        __atomic_store_n(&g->members, m, __ATOMIC_RELEASE);
+    }
+    retired[(*nretired)++] = old;
+    client_at(index)->groups--;
+}
+
+// 읽기 구간이 모두 끝난 뒤 교체된 그룹/배열 해제
+static void retire(void **retired, int n) {
+    if (n == 0) return;
+    registry_synchronize();
+    for (int i = 0; i < n; i++) free(retired[i]);
+}
+
+// ================= 가입/탈퇴 =================
+
+/**
+ * group_join - 그룹 가입 (그룹이 없으면 만듦)
+ * @index: 클라이언트 슬롯 인덱스
+ * @name: 그룹 이름
+ * @return: GROUP_OK, GROUP_ALREADY, GROUP_FULL (제한 초과 또는 메모리 부족), GROUP_BAD_NAME
+ *
+ * 가입자 배열을 새로 만들어 교체하므로 가입자 수에 비례하는 비용이 듭니다.
+ * 가입/탈퇴는 호출보다 훨씬 드물다고 보고 호출 쪽을 lock 없이 만들었습니다.
+ */
+int group_join(int index, const char *name) {
+    if (strlen(name) >= GROUP_NAME_SIZE) return GROUP_BAD_NAME;
+    unsigned h = group_hash(name);
+    client_info *c = client_at(index);
+
+    pthread_mutex_lock(&group_mutex);
+    group *g = group_find(name, h);
+    if (g && members_has(g->members, index)) {
+        pthread_mutex_unlock(&group_mutex);
+        return GROUP_ALREADY;
+    }
+    if (c->groups >= GROUP_PER_CLIENT || (!g && ngroups >= GROUP_MAX)) {
+        pthread_mutex_unlock(&group_mutex);
+        return GROUP_FULL;
+    }
+
+    group_members *old = g ? g->members : NULL;
+    group_members *m = members_copy(old, -1, index);
+    if (!m) {
+        pthread_mutex_unlock(&group_mutex);
+        return GROUP_FULL;
+    }
+    if (g) {
+        __atomic_store_n(&g->members, m, __ATOMIC_RELEASE);
+    } else {
+        g = calloc(1, sizeof(*g));
+        if (!g) {
+            free(m);
+            pthread_mutex_unlock(&group_mutex);
+            return GROUP_FULL;
+        }
+        strcpy(g->name, name);
+        g->members = m;
+        g->next = buckets[h];
+        __atomic_store_n(&buckets[h], g, __ATOMIC_RELEASE);    // 다 채운 뒤 공개
+        ngroups++;
+    }
+    c->groups++;
+    pthread_mutex_unlock(&group_mutex);
+
+    void *retired[1] = { old };
+    retire(retired, old ? 1 : 0);
+    return GROUP_OK;
+}
+
+/**
+ * group_leave - 그룹 탈퇴
+ * @index: 클라이언트 슬롯 인덱스
+ * @name: 그룹 이름
+ * @return: GROUP_OK, GROUP_ALREADY (가입하지 않은 그룹)
+ */
+int group_leave(int index, const char *name) {
+    unsigned h = group_hash(name);
+    void *retired[2];
+    int nretired = 0;
+
+    pthread_mutex_lock(&group_mutex);
+    group *g = group_find(name, h);
+    if (!g || !members_has(g->members, index)) {
+        pthread_mutex_unlock(&group_mutex);
+        return GROUP_ALREADY;
+    }
+    group_drop_locked(g, h, index, retired, &nretired);
+    pthread_mutex_unlock(&group_mutex);
+
+    retire(retired, nretired);
+    return GROUP_OK;
+}
+
+/**
+ * group_leave_all - 가입한 모든 그룹에서 탈퇴
+ * @index: 퇴장하는 클라이언트 슬롯 인덱스
+ *
+ * remove_client에서 슬롯을 반환하기 전에 호출합니다. 가입한 그룹이 없으면 바로 반환.
+ */
+void group_leave_all(int index) {
+    client_info *c = client_at(index);
+    if (c->groups == 0) return;
+
+    void *retired[2 * GROUP_PER_CLIENT];
+    int nretired = 0;
+
+    pthread_mutex_lock(&group_mutex);
+    for (unsigned h = 0; h < GROUP_HASH_SIZE && c->groups > 0; h++) {
+        group *next;
+        for (group *g = buckets[h]; g; g = next) {
+            next = g->next;
+            if (members_has(g->members, index)) {
+                group_drop_locked(g, h, index, retired, &nretired);
+            }
+        }
+    }
+    pthread_mutex_unlock(&group_mutex);
+
+    retire(retired, nretired);
+}
+
+// ================= 호출 =================
+
+/**
+ * group_send - 그룹 가입자 모두에게 같은 공유 버퍼 전송
+ * @name: 그룹 이름
+ * @message: 보낼 메시지 (가입자마다 참조만 추가)
+ * @skip_index: 보내지 않을 슬롯 (발신자, 없으면 -1)
+ * @return: 보낸 가입자 수, -1 그룹 없음
+ */
+int group_send(const char *name, msgbuf *message, int skip_index) {
+    if (!message) return 0;
+
+    int sent = -1;
+    uint64_t start = stats_now();
+    registry_read_lock();
+    group *g = group_find(name, group_hash(name));
+    if (g) {
+        group_members *m = __atomic_load_n(&g->members, __ATOMIC_ACQUIRE);
+        sent = 0;
+        for (int i = 0; i < m->count; i++) {
+            int target = __atomic_load_n(&m->index[i], __ATOMIC_ACQUIRE);
+            if (target < 0 || target == skip_index || !registry_active(target)) continue;
+            if (client_send_buf(target, message) < 0) {
+                log_printf(LOG_WARN, "그룹 호출 전송 실패: %m");
+            } else {
+                sent++;
+            }
+        }
+    }
+    registry_read_unlock();
+    if (sent >= 0) stats_record(STAT_FANOUT, stats_now() - start);
+    return sent;
+}
@@ -0,0 +1,38 @@
+// group.h - 그룹 호출 채널 헤더 파일
+//
+// /join으로 가입한 사람들에게 /page로 한 번에 호출을 보냅니다 (당번 그룹 호출 등).
+// - 그룹 이름 → 그룹 해시 색인, 그룹마다 가입자 슬롯 배열을 가짐
+//   → 그룹 호출은 가입자 수만큼만 순회 (전체 세션 테이블을 훑지 않음)
+// - 메시지는 한 번만 포맷해 모든 가입자가 같은 공유 버퍼를 참조
+// - 가입자 배열은 바꾸지 않고 새로 만들어 교체 (read-copy-update)
+//   → 호출은 세션 테이블과 같은 읽기 구간에서 lock 없이 수행하고,
+//     가입/탈퇴만 group_mutex로 직렬화한 뒤 읽기 구간이 끝나면 예전 배열을 해제
+// - 가입자가 없어진 그룹은 지움
+
+#ifndef GROUP_H
+#define GROUP_H
+
+#include "msgbuf.h"         // 공유 메시지 버퍼
+
+// ================= 설정 =================
+
+#define GROUP_NAME_SIZE     32          // 그룹 이름 최대 길이 (NULL 포함)
+#define GROUP_HASH_SIZE     256         // 그룹 해시 버킷 수 (2의 거듭제곱)
+#define GROUP_MAX           4096        // 서버 전체 최대 그룹 수
+#define GROUP_PER_CLIENT    32          // 클라이언트 한 명이 가입할 수 있는 최대 그룹 수
+
+// group_join / group_leave 반환값
+#define GROUP_OK            0
+#define GROUP_ALREADY       1           // 이미 가입함 / 가입하지 않은 그룹
+#define GROUP_FULL          (-1)        // 그룹 수 또는 가입 수 제한 초과
+#define GROUP_BAD_NAME      (-2)        // 이름이 너무 김
+
+// ================= 함수 선언 =================
+
+int  group_join(int index, const char *name);     // 그룹 가입 (GROUP_*)
+int  group_leave(int index, const char *name);    // 그룹 탈퇴 (GROUP_*)
+void group_leave_all(int index);                  // 모든 그룹에서 탈퇴 (퇴장 시)
+
+int  group_send(const char *name, msgbuf *message, int skip_index);  // 가입자에게 전송 (받은 수, -1: 그룹 없음)
+
+#endif // GROUP_H
@@ -0,0 +1,62 @@
+// hdr.h - HDR 히스토그램 칸 계산 (서버 지표와 부하 생성기가 같이 씀)
+//
+// 2의 거듭제곱 구간마다 2^HDR_SUB_BITS개로 나눈 칸에 값을 셉니다.
+// - 2^HDR_SUB_BITS 미만은 값 그대로 칸 번호, 그 위는 지수 구간 안에서 상위 비트로 나눔
+// - 상대 오차 약 12.5%로 0 ~ 2^HDR_MAX_BITS - 1을 칸 HDR_BUCKETS개로 표현 (넘으면 마지막 칸)
+// - 칸 배열과 집계 방식(원자적 덧셈, 쓰레드별 칸 등)은 쓰는 쪽이 정함
+// - 헤더만으로 동작하므로 loadgen.c처럼 따로 빌드하는 프로그램도 include만 하면 됨
+
+#ifndef HDR_H
+#define HDR_H
+
+#include <stdint.h>
+
+// ================= 설정 =================
+
+#define HDR_SUB_BITS    3                   // 2의 거듭제곱 구간 하나를 나누는 칸 수 (2^3)
+#define HDR_MAX_BITS    40                  // 기록 가능한 최대값 2^40 - 1 (넘으면 마지막 칸)
+#define HDR_BUCKETS     ((HDR_MAX_BITS - HDR_SUB_BITS + 1) << HDR_SUB_BITS)
+
+// ================= 함수 =================
+
+// 값 → 칸 번호
+static inline int hdr_bucket_of(uint64_t v) {
+    if (v < (1u << HDR_SUB_BITS)) return (int)v;
+    if (v >> HDR_MAX_BITS) return HDR_BUCKETS - 1;
+    int e = 63 - __builtin_clzll(v);
+    return ((e - HDR_SUB_BITS + 1) << HDR_SUB_BITS) +
+           (int)((v >> (e - HDR_SUB_BITS)) & ((1u << HDR_SUB_BITS) - 1));
+}
+
+// 칸 번호 → 그 칸에 들어가는 가장 큰 값
+static inline uint64_t hdr_bucket_upper(int i) {
+    if (i < (1 << HDR_SUB_BITS)) return (uint64_t)i;
+    int e = (i >> HDR_SUB_BITS) + HDR_SUB_BITS - 1;
+    uint64_t sub = (uint64_t)(i & ((1 << HDR_SUB_BITS) - 1));
+    return ((((uint64_t)1 << HDR_SUB_BITS) + sub + 1) << (e - HDR_SUB_BITS)) - 1;
+}
+
+/**
+ * hdr_percentile - 칸 배열에서 백분위수
+ * @b: 칸 HDR_BUCKETS개
+ * @count: 기록 수 (칸 합계)
+ * @max: 기록된 최대값
+ * @p: 백분위 (0~100)
+ * @return: 해당 순위 값이 든 칸의 상한값 (최대값을 넘지 않음), 기록이 없으면 0
+ */
+static inline uint64_t hdr_percentile(const uint64_t *b, uint64_t count, uint64_t max, double p) {
+    if (count == 0) return 0;
+    uint64_t rank = (uint64_t)(p / 100.0 * (double)count + 0.5);
+    if (rank < 1) rank = 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < HDR_BUCKETS; i++) {
+        seen += b[i];
+        if (seen >= rank) {
+            uint64_t upper = hdr_bucket_upper(i);
+            return upper < max ? upper : max;
+        }
+    }
+    return max;
+}
+
+#endif // HDR_H
@@ -0,0 +1,143 @@
+// heartbeat.c - 하트비트(PING/PONG)와 유휴 연결 종료
+//
+// 휠은 hb_lock 하나로 보호합니다. 하트비트 쓰레드는 읽기 구간 안에서 hb_lock을 잡고 휠을 돌리므로,
+// 만료 처리 중에 본 슬롯은 remove_client의 registry_synchronize가 끝나기 전까지 재사용되지 않고,
+// 퇴장한 연결의 타이머는 그 뒤 heartbeat_cancel로 휠에서 빠집니다.
+
+#include "server.h"
+
+#include <time.h>
+
+unsigned hb_ping_sec = HB_DEFAULT_PING;
+unsigned hb_timeout_sec = HB_DEFAULT_TIMEOUT;
+uint64_t hb_clock = 1;                      // 0은 "PING을 보내지 않음"으로 씀
+
+static pthread_mutex_t hb_lock = PTHREAD_MUTEX_INITIALIZER;
+static timer_wheel wheel;
+static uint64_t ping_ticks, timeout_ticks;
+
+/**
+ * heartbeat_parse - 하트비트 간격 설정
+ * @spec: "핑초,종료초" (예: "30,90"), "off"면 하트비트와 유휴 종료를 모두 끔
+ * @return: 0 성공, -1 형식 오류 (종료 시간은 PING 간격보다 길어야 함)
+ */
+int heartbeat_parse(const char *spec) {
+    if (strcmp(spec, "off") == 0) {
+        hb_ping_sec = 0;
+        return 0;
+    }
+    char *end;
+    long ping = strtol(spec, &end, 10);
+    if (end == spec || *end != ',' || ping < 1 || ping > 86400) return -1;
+    const char *p = end + 1;
+    long timeout = strtol(p, &end, 10);
+    if (end == p || *end != '\0' || timeout <= ping || timeout > 86400) return -1;
+    hb_ping_sec = (unsigned)ping;
+    hb_timeout_sec = (unsigned)timeout;
+    return 0;
+}
+
+static uint64_t sec_to_ticks(unsigned sec) {
+    return (uint64_t)sec * 1000 / HB_TICK_MS;
+}
+
+// ================= 만료 처리 =================
+
+// 만료된 타이머 하나 (hb_lock, 읽기 구간 안)
+static void on_expire(tw_timer *t, void *arg) {
+    (void)arg;
+    hb_state *hb = (hb_state *)((char *)t - offsetof(hb_state, timer));
+    int index = hb->index;
+    if (!registry_active(index)) return;    // 퇴장 중 (곧 heartbeat_cancel)
+
+    client_info *c = client_at(index);
+    uint64_t now = wheel.now - 1;           // 방금 처리한 틱
+    uint64_t last = __atomic_load_n(&c->last_rx, __ATOMIC_RELAXED);
+    uint64_t idle = now > last ? now - last : 0;
+
+    if (idle >= timeout_ticks) {
+        // 소켓만 닫으면 담당 I/O 루프가 상대방 종료와 같은 경로로 정리함
+        log_printf(LOG_INFO, "[클라이언트 %d] %u초 동안 응답이 없어 연결을 끊습니다.",
+                   c->id, hb_timeout_sec);
+        shutdown(c->socket, SHUT_RDWR);
+        stats_count(STAT_REAPED, 1);
+        return;
+    }
+    if (idle >= ping_ticks) {
+        if (hb->pinged <= last) {           // 마지막 수신 뒤로 아직 보내지 않음
+            client_send(index, HB_PING_LINE, sizeof(HB_PING_LINE) - 1);
+            hb->pinged = now;
+            stats_count(STAT_PINGS, 1);
+        }
+        tw_arm(&wheel, t, last + timeout_ticks);
+        return;
+    }
+    tw_arm(&wheel, t, last + ping_ticks);
+}
+
+// 하트비트 쓰레드 - 틱마다 시계를 올리고 휠을 돌림 (깨어날 시각은 절대 시각이라 늦어져도 밀리지 않음)
+static void *heartbeat_loop(void *arg) {
+    (void)arg;
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    while (1) {
+        next.tv_nsec += HB_TICK_MS * 1000000L;
+        if (next.tv_nsec >= 1000000000L) {
+            next.tv_sec++;
+            next.tv_nsec -= 1000000000L;
+        }
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL) == EINTR) { }
+        uint64_t now = __atomic_add_fetch(&hb_clock, 1, __ATOMIC_RELAXED);
+
+        registry_read_lock();
+        pthread_mutex_lock(&hb_lock);
+        tw_advance(&wheel, now, on_expire, NULL);
+        pthread_mutex_unlock(&hb_lock);
+        registry_read_unlock();
+    }
+    return NULL;
+}
+
+int heartbeat_init(void) {
+    if (hb_ping_sec == 0) return 0;
+    ping_ticks = sec_to_ticks(hb_ping_sec);
+    timeout_ticks = sec_to_ticks(hb_timeout_sec);
+    tw_init(&wheel, heartbeat_clock());
+
+    pthread_t tid;
+    if (pthread_create(&tid, NULL, heartbeat_loop, NULL) != 0) {
+        perror("하트비트 쓰레드 생성 실패");
+        return -1;
+    }
+    pthread_detach(tid);
+
+    log_printf(LOG_INFO, "하트비트: %u초 동안 조용하면 PING, %u초면 연결 종료", hb_ping_sec, hb_timeout_sec);
+    return 0;
+}
+
+// ================= 등록/취소 =================
+
+void heartbeat_arm(int index) {
+    if (hb_ping_sec == 0) return;
+    client_info *c = client_at(index);
+    pthread_mutex_lock(&hb_lock);
+    c->hb.index = index;
+    c->hb.pinged = 0;
+    tw_arm(&wheel, &c->hb.timer, __atomic_load_n(&c->last_rx, __ATOMIC_RELAXED) + ping_ticks);
+    pthread_mutex_unlock(&hb_lock);
+}
+
+void heartbeat_cancel(int index) {
+    if (hb_ping_sec == 0) return;
+    pthread_mutex_lock(&hb_lock);
+    tw_cancel(&wheel, &client_at(index)->hb.timer);
+    pthread_mutex_unlock(&hb_lock);
+}
+
+unsigned long heartbeat_armed(void) {
+    pthread_mutex_lock(&hb_lock);
+    unsigned long n = wheel.armed;
+    pthread_mutex_unlock(&hb_lock);
+    return n;
+}
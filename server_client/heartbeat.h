@@ -0,0 +1,61 @@
+// heartbeat.h - 하트비트(PING/PONG)와 유휴 연결 종료 헤더 파일
+//
+// 반쯤 열린 TCP 연결(단말기 전원이 꺼지거나 망이 끊긴 경우)은 recv가 오류를 돌려줄 때까지
+// 세션 슬롯을 계속 차지합니다. 일정 시간 아무것도 받지 못한 연결에 PING 줄을 보내고,
+// 그 뒤에도 조용하면 연결을 끊어 슬롯을 바로 돌려받습니다.
+// - 연결마다 타이머 하나를 계층형 타이머 휠(timerwheel.h)에 등록 → 등록/취소 O(1)
+// - 휠은 하트비트 쓰레드 하나가 HB_TICK_MS마다 돌림. 수신 경로는 틱 시계를 읽어
+//   client_info.last_rx에 적기만 하고 타이머는 건드리지 않음 (시스템 호출, lock 없음)
+// - 만료된 타이머는 마지막 수신 시각을 보고 다시 등록하거나, PING을 보내거나, 연결을 끊음
+//   → 활동 중인 연결도 타이머는 핑 간격마다 한 번만 만료됨
+// - 끊을 때는 shutdown만 하고 정리는 I/O 모델의 평소 종료 경로가 함 (퇴장 알림, 슬롯 반환)
+// - PING은 제어 바이트(HB_CTRL)로 시작하는 줄. 채팅은 받은 줄을 그대로 보내므로 서버가
+//   제어 바이트로 시작하는 채팅을 거절함 → 사용자가 보낸 "PING"은 하트비트로 오인되지 않음
+// - 클라이언트는 PING 줄 전체가 일치할 때만 "PONG"으로 답함. 서버는 PONG 줄을 무시하며,
+//   받은 데이터는 무엇이든 활동으로 봄
+
+#ifndef HEARTBEAT_H
+#define HEARTBEAT_H
+
+#include <stdint.h>
+
+#include "timerwheel.h"     // 계층형 타이머 휠
+
+// ================= 설정 =================
+
+#define HB_TICK_MS          100         // 타이머 휠 한 틱 (ms)
+#define HB_DEFAULT_PING     30          // 마지막 수신 후 PING을 보내기까지 (초)
+#define HB_DEFAULT_TIMEOUT  90          // 마지막 수신 후 연결을 끊기까지 (초)
+
+#define HB_CTRL             '\x01'      // 서버 제어 줄 시작 바이트 (채팅 줄은 이 바이트로 시작할 수 없음)
+#define HB_PING_LINE        "\x01PING\n"
+#define HB_PONG_LINE        "PONG"      // 클라이언트 응답 (개행 제외)
+
+// ================= 자료 구조 =================
+
+// 연결별 하트비트 상태 (client_info에 들어 있음, hb_lock으로 보호)
+typedef struct {
+    tw_timer timer;
+    int index;                  // 세션 슬롯 인덱스
+    uint64_t pinged;            // 마지막으로 PING을 보낸 틱 (0: 보내지 않음)
+} hb_state;
+
+extern unsigned hb_ping_sec;                // PING 간격 (0: 하트비트 끔)
+extern unsigned hb_timeout_sec;             // 유휴 종료 시간
+extern uint64_t hb_clock;                   // 틱 시계 (하트비트 쓰레드만 증가)
+
+// ================= 함수 선언 =================
+
+int  heartbeat_parse(const char *spec);     // "핑초,종료초" 또는 "off" (-1: 형식 오류)
+int  heartbeat_init(void);                  // 하트비트 쓰레드 시작 (꺼져 있으면 아무것도 안 함, -1: 실패)
+
+void heartbeat_arm(int index);              // 접속 (슬롯을 공개한 뒤)
+void heartbeat_cancel(int index);           // 퇴장 (registry_synchronize 뒤, 슬롯 반환 전)
+unsigned long heartbeat_armed(void);        // 등록된 타이머 수 (지표용)
+
+// 지금 틱 - 수신 경로에서 client_info.last_rx에 적음
+static inline uint64_t heartbeat_clock(void) {
+    return __atomic_load_n(&hb_clock, __ATOMIC_RELAXED);
+}
+
+#endif // HEARTBEAT_H
@@ -0,0 +1,604 @@
+// loadgen.c - 호출 서버 부하 생성기 / 종단 간 배달 지연 측정
+//
+// 키패드 없이 접속을 여러 개 열어 채팅, /all, /msg, /list, 재접속을 섞어 보내고,
+// 메시지 안에 넣은 보낸 시각(LG:<ns>)으로 받는 쪽에서 배달 지연을 잽니다.
+// 보내는 쪽과 받는 쪽이 같은 프로세스라 같은 단조 시계를 씁니다.
+//
+// - 접속은 쓰레드(-T)마다 나눠 맡고, 각 쓰레드는 epoll로 자기 접속을 읽음
+// - 전송은 전체 초당 횟수(-r)를 쓰레드끼리 나눠 일정한 간격으로 보냄 (open loop)
+// - 서버의 속도 제한에 걸리면 안내 수를 따로 셈 → 측정할 때는 서버를 -r off -f 0으로 실행
+//
+// 시나리오 (-m):
+// - mixed      : 채팅 60, /all 10, /msg 25, /list 5 (기본)
+// - fanout     : /all만 → 브로드캐스트 fanout 처리량
+// - contention : 채팅/귓속말 + 초당 재접속(-k 기본 100) → 입장/퇴장과 읽기가 겹치는 상황
+// - churn      : 메시지 없이 환영 메시지를 받자마자 끊고 다시 접속 (closed loop)
+//                → 초당 접속 수, 접속→환영 메시지 지연, 서버의 연결당 세션 할당 수(/stats)
+// - 직접 지정  : "chat=70,all=10,msg=15,list=5"
+//
+// 빌드: gcc loadgen.c -o loadgen -Wall -O2 -pthread
+// 예:   ./loadgen -c 2000 -T 4 -r 5000 -d 10 -m mixed
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <time.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+#include "hdr.h"
+
+// ================= 설정 =================
+
+#define MAX_THREADS     64
+#define RECV_BUF_SIZE   65536
+#define LIST_PENDING    16          // 접속당 응답을 기다리는 /list 수
+#define MARK            "LG:"       // 메시지에 넣는 보낸 시각 표시
+
+// 보내는 동작
+#define OP_CHAT         0
+#define OP_ALL          1
+#define OP_MSG          2
+#define OP_LIST         3
+#define OP_COUNT        4
+
+static const char *op_names[OP_COUNT] = { "chat", "all", "msg", "list" };
+
+// ================= 자료 구조 =================
+
+typedef struct {
+    uint64_t count, sum, max;
+    uint64_t b[HDR_BUCKETS];
+} hist;
+
+// 접속 하나
+typedef struct {
+    int fd;                         // -1: 끊김
+    char *rbuf;                     // 받은 데이터 (줄 단위로 처리하고 남은 부분)
+    size_t rlen;
+    uint64_t list_sent[LIST_PENDING];   // 보낸 /list 시각 (FIFO)
+    int list_head, list_count;
+    uint64_t opened_at;             // 접속 시각 (환영 메시지를 받으면 0)
+    int welcomed;                   // 환영 메시지를 받음 (churn: 다시 접속할 차례)
+} conn;
+
+// 쓰레드 하나가 맡은 접속과 결과
+typedef struct {
+    int tid;
+    int first, count;               // 맡은 접속 conns[first .. first+count)
+    int ep;
+    uint64_t rng;
+    hist delivery;                  // 배달 지연 (보낸 시각 → 받은 시각)
+    hist list_latency;              // /list 응답 지연
+    hist connect_latency;           // 접속 → 환영 메시지 지연
+    unsigned long sent[OP_COUNT];
+    unsigned long delivered;
+    unsigned long limited;          // 서버 속도 제한 안내 수
+    unsigned long reconnects;
+    unsigned long errors;           // 연결/전송 실패
+    unsigned long bytes_in;
+} worker;
+
+// 명령줄 설정
+static const char *host = "127.0.0.1";
+static int port = 8080;
+static int nconns = 100;
+static int nthreads = 1;
+static double rate = 1000;          // 전체 초당 전송 수
+static double duration = 10;        // 측정 시간 (초)
+static double churn = -1;           // 초당 재접속 수 (-1: 시나리오 기본값)
+static int churn_loop;              // 1: 환영 메시지를 받는 대로 재접속 (churn 시나리오)
+static int payload = 32;            // 메시지 본문 길이 (바이트, 시각 표시 포함)
+static int mix[OP_COUNT] = { 60, 10, 25, 5 };
+
+static conn *conns;
+static int *conn_ids;               // 접속별 서버 ID (0: 아직 모름) - /msg 대상 선택용, 쓰레드 공유
+static struct sockaddr_in server_addr;
+static volatile int measuring;      // 0: 접속/준비 중, 1: 측정 중, 2: 끝
+
+// ================= 유틸 =================
+
+static inline uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint64_t rng_next(uint64_t *s) {
+    // xorshift64*
+    *s ^= *s >> 12;
+    *s ^= *s << 25;
+    *s ^= *s >> 27;
+    return *s * 2685821657736338717ULL;
+}
+
+static void hist_add(hist *h, uint64_t v) {
+    h->b[hdr_bucket_of(v)]++;
+    h->count++;
+    h->sum += v;
+    if (v > h->max) h->max = v;
+}
+
+static void hist_merge(hist *dst, const hist *src) {
+    for (int i = 0; i < HDR_BUCKETS; i++) dst->b[i] += src->b[i];
+    dst->count += src->count;
+    dst->sum += src->sum;
+    if (src->max > dst->max) dst->max = src->max;
+}
+
+static uint64_t hist_percentile(const hist *h, double p) {
+    return hdr_percentile(h->b, h->count, h->max, p);
+}
+
+// ================= 접속 =================
+
+static int conn_open(worker *w, int i) {
+    conn *c = &conns[i];
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    struct epoll_event ev = { .events = EPOLLIN, .data.u32 = (uint32_t)i };
+    if (epoll_ctl(w->ep, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        close(fd);
+        return -1;
+    }
+    c->fd = fd;
+    c->rlen = 0;
+    c->list_head = c->list_count = 0;
+    c->opened_at = now_ns();
+    c->welcomed = 0;
+    __atomic_store_n(&conn_ids[i], 0, __ATOMIC_RELAXED);
+    return 0;
+}
+
+static void conn_close(worker *w, int i) {
+    conn *c = &conns[i];
+    if (c->fd < 0) return;
+    __atomic_store_n(&conn_ids[i], 0, __ATOMIC_RELAXED);
+    epoll_ctl(w->ep, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    c->fd = -1;
+}
+
+// 한 줄을 끝까지 전송 (소켓 버퍼가 차면 잠깐 기다림 - 줄이 잘린 채로 남지 않도록)
+static int send_line(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t n = send(fd, data, len, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) return -1;
+            struct pollfd pfd = { .fd = fd, .events = POLLOUT };
+            if (poll(&pfd, 1, 1000) <= 0) return -1;
+            continue;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+// ================= 수신 처리 =================
+
+static void on_line(worker *w, int i, char *line, uint64_t now) {
+    conn *c = &conns[i];
+    if (strcmp(line, "\x01PING") == 0) {        // 서버 하트비트 (heartbeat.h의 HB_PING_LINE)
+        send_line(c->fd, "PONG\n", 5);
+        return;
+    }
+    char *mark = strstr(line, MARK);
+    if (mark) {
+        // 귓속말 확인("[귓속말 to")은 보낸 사람에게 돌아온 것이라 배달로 세지 않음
+        if (strncmp(line, "[귓속말 to", strlen("[귓속말 to")) == 0) return;
+        uint64_t sent_at = strtoull(mark + strlen(MARK), NULL, 10);
+        if (measuring == 1 && sent_at > 0 && sent_at <= now) {
+            hist_add(&w->delivery, now - sent_at);
+            w->delivered++;
+        }
+        return;
+    }
+    if (strncmp(line, "당신의 ID: ", strlen("당신의 ID: ")) == 0) {
+        __atomic_store_n(&conn_ids[i], atoi(line + strlen("당신의 ID: ")), __ATOMIC_RELAXED);
+        if (measuring == 1 && c->opened_at) hist_add(&w->connect_latency, now - c->opened_at);
+        c->opened_at = 0;
+        c->welcomed = 1;
+        return;
+    }
+    if (strncmp(line, "총 ", strlen("총 ")) == 0 && strstr(line, "명 접속 중") && c->list_count > 0) {
+        uint64_t sent_at = c->list_sent[c->list_head];
+        c->list_head = (c->list_head + 1) % LIST_PENDING;
+        c->list_count--;
+        if (measuring == 1) hist_add(&w->list_latency, now - sent_at);
+        return;
+    }
+    if (strstr(line, "너무 많습니다")) w->limited++;
+}
+
+// 읽을 수 있는 만큼 읽고 완성된 줄을 처리 (0: 계속, -1: 끊김)
+static int conn_read(worker *w, int i) {
+    conn *c = &conns[i];
+    while (1) {
+        if (c->rlen == RECV_BUF_SIZE) c->rlen = 0;     // 줄이 버퍼보다 길면 버림 (목록 등)
+        ssize_t n = recv(c->fd, c->rbuf + c->rlen, RECV_BUF_SIZE - c->rlen, 0);
+        if (n == 0) return -1;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+        }
+        w->bytes_in += (size_t)n;
+        uint64_t now = now_ns();
+        size_t start = 0, end = c->rlen + (size_t)n;
+        for (size_t p = c->rlen; p < end; p++) {
+            if (c->rbuf[p] != '\n') continue;
+            c->rbuf[p] = '\0';
+            on_line(w, i, c->rbuf + start, now);
+            start = p + 1;
+        }
+        memmove(c->rbuf, c->rbuf + start, end - start);
+        c->rlen = end - start;
+    }
+}
+
+// ================= 전송 =================
+
+static int pick_op(worker *w) {
+    int total = mix[OP_CHAT] + mix[OP_ALL] + mix[OP_MSG] + mix[OP_LIST];
+    int r = (int)(rng_next(&w->rng) % (uint64_t)total);
+    for (int op = 0; op < OP_COUNT; op++) {
+        if (r < mix[op]) return op;
+        r -= mix[op];
+    }
+    return OP_CHAT;
+}
+
+// 임의의 접속 중인 상대 ID (없으면 0)
+static int pick_target(worker *w) {
+    for (int tries = 0; tries < 8; tries++) {
+        int id = __atomic_load_n(&conn_ids[rng_next(&w->rng) % (uint64_t)nconns], __ATOMIC_RELAXED);
+        if (id > 0) return id;
+    }
+    return 0;
+}
+
+static void send_one(worker *w) {
+    int i = w->first + (int)(rng_next(&w->rng) % (uint64_t)w->count);
+    conn *c = &conns[i];
+    if (c->fd < 0) return;
+
+    char line[2048];
+    int op = pick_op(w);
+    int len;
+    uint64_t now = now_ns();
+    int target = (op == OP_MSG) ? pick_target(w) : 0;
+    if (op == OP_MSG && target == 0) op = OP_CHAT;
+
+    switch (op) {
+    case OP_ALL:
+        len = snprintf(line, sizeof(line), "/all %s%lu ", MARK, (unsigned long)now);
+        break;
+    case OP_MSG:
+        len = snprintf(line, sizeof(line), "/msg %d %s%lu ", target, MARK, (unsigned long)now);
+        break;
+    case OP_LIST:
+        if (c->list_count == LIST_PENDING) return;  // 응답이 밀려 있으면 건너뜀
+        len = snprintf(line, sizeof(line), "/list");
+        c->list_sent[(c->list_head + c->list_count) % LIST_PENDING] = now;
+        c->list_count++;
+        break;
+    default:
+        len = snprintf(line, sizeof(line), "%s%lu ", MARK, (unsigned long)now);
+        break;
+    }
+    // 본문 길이 맞추기 (채팅/전체/귓속말)
+    if (op != OP_LIST) {
+        while (len < payload && len < (int)sizeof(line) - 2) line[len++] = 'x';
+    }
+    line[len++] = '\n';
+
+    if (send_line(c->fd, line, (size_t)len) < 0) {
+        w->errors++;
+        conn_close(w, i);
+        return;
+    }
+    if (measuring == 1) w->sent[op]++;
+}
+
+// ================= 쓰레드 =================
+
+static void *worker_main(void *arg) {
+    worker *w = arg;
+    struct epoll_event events[256];
+
+    for (int i = w->first; i < w->first + w->count; i++) {
+        if (conn_open(w, i) < 0) w->errors++;
+    }
+
+    double my_rate = rate / nthreads;
+    double my_churn = churn / nthreads;
+    uint64_t send_gap = my_rate > 0 ? (uint64_t)(1e9 / my_rate) : 0;
+    uint64_t churn_gap = my_churn > 0 ? (uint64_t)(1e9 / my_churn) : 0;
+    uint64_t next_send = 0, next_churn = 0;
+
+    while (measuring != 2) {
+        uint64_t now = now_ns();
+        if (measuring == 1) {
+            if (next_send == 0) next_send = now;
+            if (next_churn == 0) next_churn = now + churn_gap;
+            // 밀린 전송은 한 번에 최대 1000개까지 따라잡음
+            for (int k = 0; send_gap && next_send <= now && k < 1000; k++) {
+                send_one(w);
+                next_send += send_gap;
+            }
+            if (next_send + 1000000000ULL < now) next_send = now;   // 1초 이상 밀리면 포기
+            while (churn_gap && next_churn <= now) {
+                int i = w->first + (int)(rng_next(&w->rng) % (uint64_t)w->count);
+                conn_close(w, i);
+                if (conn_open(w, i) < 0) w->errors++;
+                else w->reconnects++;
+                next_churn += churn_gap;
+            }
+        }
+
+        int timeout = 10;
+        if (measuring == 1 && send_gap) {
+            uint64_t t = now_ns();
+            timeout = next_send > t ? (int)((next_send - t) / 1000000) : 0;
+            if (timeout > 10) timeout = 10;
+        }
+        int n = epoll_wait(w->ep, events, 256, timeout);
+        for (int e = 0; e < n; e++) {
+            int i = (int)events[e].data.u32;
+            if (conns[i].fd >= 0 && conn_read(w, i) < 0) {
+                w->errors++;
+                conn_close(w, i);
+            }
+        }
+
+        // churn: 환영 메시지를 받은 접속은 바로 끊고 다시 접속
+        if (churn_loop && measuring == 1) {
+            for (int i = w->first; i < w->first + w->count; i++) {
+                if (conns[i].fd >= 0 && !conns[i].welcomed) continue;
+                conn_close(w, i);
+                if (conn_open(w, i) < 0) w->errors++;
+                else w->reconnects++;
+            }
+        }
+    }
+
+    for (int i = w->first; i < w->first + w->count; i++) conn_close(w, i);
+    return NULL;
+}
+
+// ================= 설정/보고 =================
+
+static int parse_mix(const char *spec) {
+    if (strcmp(spec, "mixed") == 0) {
+        int m[OP_COUNT] = { 60, 10, 25, 5 };
+        memcpy(mix, m, sizeof(mix));
+        return 0;
+    }
+    if (strcmp(spec, "fanout") == 0) {
+        int m[OP_COUNT] = { 0, 100, 0, 0 };
+        memcpy(mix, m, sizeof(mix));
+        return 0;
+    }
+    if (strcmp(spec, "churn") == 0) {
+        memset(mix, 0, sizeof(mix));
+        churn_loop = 1;
+        return 0;
+    }
+    if (strcmp(spec, "contention") == 0) {
+        int m[OP_COUNT] = { 50, 0, 50, 0 };
+        memcpy(mix, m, sizeof(mix));
+        if (churn < 0) churn = 100;
+        return 0;
+    }
+
+    int m[OP_COUNT] = { 0 };
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%s", spec);
+    for (char *tok = strtok(buf, ","); tok; tok = strtok(NULL, ",")) {
+        char *eq = strchr(tok, '=');
+        if (!eq) return -1;
+        *eq = '\0';
+        int op;
+        for (op = 0; op < OP_COUNT; op++) {
+            if (strcmp(tok, op_names[op]) == 0) break;
+        }
+        if (op == OP_COUNT || atoi(eq + 1) < 0) return -1;
+        m[op] = atoi(eq + 1);
+    }
+    if (m[OP_CHAT] + m[OP_ALL] + m[OP_MSG] + m[OP_LIST] == 0) return -1;
+    memcpy(mix, m, sizeof(mix));
+    return 0;
+}
+
+// 서버 /stats의 세션 줄 출력 (연결당 새 할당 수)
+static void print_server_sessions(void) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return;
+    struct timeval tv = { .tv_sec = 1 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    if (connect(fd, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0 ||
+        send_line(fd, "/stats\n", 7) < 0) {
+        close(fd);
+        return;
+    }
+
+    char buf[RECV_BUF_SIZE];
+    size_t len = 0;
+    while (len < sizeof(buf) - 1) {
+        ssize_t n = recv(fd, buf + len, sizeof(buf) - 1 - len, 0);
+        if (n <= 0) break;
+        len += (size_t)n;
+        buf[len] = '\0';
+        char *line = strstr(buf, "세션: ");
+        if (line && strchr(line, '\n')) {
+            *strchr(line, '\n') = '\0';
+            printf("서버 %s\n", line);
+            break;
+        }
+    }
+    close(fd);
+}
+
+static void print_usage(const char *prog) {
+    fprintf(stderr,
+            "사용법: %s [-H 서버IP] [-p 포트] [-c 접속수] [-T 쓰레드수] [-r 초당전송] [-d 초]\n"
+            "       [-m mixed|fanout|contention|churn|chat=N,all=N,msg=N,list=N] [-k 초당재접속] [-l 본문길이]\n"
+            "  측정 전에 서버를 속도 제한 없이 실행하세요: ./server -m epoll -r off -f 0\n",
+            prog);
+}
+
+static void print_hist(const char *label, const hist *h) {
+    if (h->count == 0) {
+        printf("%s: 기록 없음\n", label);
+        return;
+    }
+    printf("%s (us): %lu건, 평균 %.1f, p50 %.1f, p99 %.1f, p999 %.1f, 최대 %.1f\n",
+           label, (unsigned long)h->count, (double)h->sum / (double)h->count / 1000.0,
+           hist_percentile(h, 50) / 1000.0, hist_percentile(h, 99) / 1000.0,
+           hist_percentile(h, 99.9) / 1000.0, h->max / 1000.0);
+}
+
+int main(int argc, char *argv[]) {
+    int opt;
+    while ((opt = getopt(argc, argv, "H:p:c:T:r:d:m:k:l:h")) != -1) {
+        switch (opt) {
+        case 'H': host = optarg; break;
+        case 'p': port = atoi(optarg); break;
+        case 'c': nconns = atoi(optarg); break;
+        case 'T': nthreads = atoi(optarg); break;
+        case 'r': rate = atof(optarg); break;
+        case 'd': duration = atof(optarg); break;
+        case 'k': churn = atof(optarg); break;
+        case 'l': payload = atoi(optarg); break;
+        case 'm':
+            if (parse_mix(optarg) < 0) { print_usage(argv[0]); exit(1); }
+            break;
+        default:
+            print_usage(argv[0]);
+            exit(1);
+        }
+    }
+    if (nconns < 1 || nthreads < 1 || nthreads > MAX_THREADS || nthreads > nconns ||
+        rate < 0 || duration <= 0 || payload < 0 || payload > 1000) {
+        print_usage(argv[0]);
+        exit(1);
+    }
+    if (churn < 0) churn = 0;
+    if (churn_loop) {
+        rate = 0;                   // 메시지 없이 접속/종료만
+        churn = 0;
+    }
+
+    memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, host, &server_addr.sin_addr) <= 0) {
+        fprintf(stderr, "잘못된 주소: %s\n", host);
+        exit(1);
+    }
+
+    conns = calloc((size_t)nconns, sizeof(conn));
+    conn_ids = calloc((size_t)nconns, sizeof(int));
+    worker *workers = calloc((size_t)nthreads, sizeof(worker));
+    if (!conns || !conn_ids || !workers) {
+        perror("메모리 할당 실패");
+        exit(1);
+    }
+    for (int i = 0; i < nconns; i++) {
+        conns[i].fd = -1;
+        conns[i].rbuf = malloc(RECV_BUF_SIZE);
+        if (!conns[i].rbuf) {
+            perror("메모리 할당 실패");
+            exit(1);
+        }
+    }
+
+    printf("서버 %s:%d, 접속 %d개, 쓰레드 %d개, 초당 %.0f건, %.0f초, 재접속 초당 %.0f\n",
+           host, port, nconns, nthreads, rate, duration, churn);
+    printf("구성: chat %d, all %d, msg %d, list %d\n", mix[OP_CHAT], mix[OP_ALL], mix[OP_MSG], mix[OP_LIST]);
+
+    pthread_t tids[MAX_THREADS];
+    int per = nconns / nthreads, extra = nconns % nthreads, first = 0;
+    for (int t = 0; t < nthreads; t++) {
+        worker *w = &workers[t];
+        w->tid = t;
+        w->first = first;
+        w->count = per + (t < extra ? 1 : 0);
+        first += w->count;
+        w->rng = 0x9E3779B97F4A7C15ULL ^ ((uint64_t)(t + 1) * 0xBF58476D1CE4E5B9ULL) ^ now_ns();
+        w->ep = epoll_create1(EPOLL_CLOEXEC);
+        if (w->ep < 0 || pthread_create(&tids[t], NULL, worker_main, w) != 0) {
+            perror("쓰레드 시작 실패");
+            exit(1);
+        }
+    }
+
+    // 모든 접속이 ID를 받을 때까지 (최대 10초) 기다린 뒤 측정 시작
+    uint64_t wait_until = now_ns() + 10000000000ULL;
+    int ready = 0;
+    while (now_ns() < wait_until) {
+        ready = 0;
+        for (int i = 0; i < nconns; i++) ready += __atomic_load_n(&conn_ids[i], __ATOMIC_RELAXED) > 0;
+        if (ready == nconns) break;
+        usleep(50000);
+    }
+    printf("접속 완료: %d/%d\n", ready, nconns);
+
+    uint64_t start = now_ns();
+    measuring = 1;
+    usleep((useconds_t)(duration * 1e6));
+    measuring = 2;
+    double elapsed = (double)(now_ns() - start) / 1e9;
+    for (int t = 0; t < nthreads; t++) pthread_join(tids[t], NULL);
+
+    // 결과 합치기
+    hist delivery = { 0 }, list_latency = { 0 }, connect_latency = { 0 };
+    unsigned long sent[OP_COUNT] = { 0 }, delivered = 0, limited = 0, reconnects = 0, errors = 0, bytes_in = 0;
+    for (int t = 0; t < nthreads; t++) {
+        worker *w = &workers[t];
+        hist_merge(&delivery, &w->delivery);
+        hist_merge(&list_latency, &w->list_latency);
+        hist_merge(&connect_latency, &w->connect_latency);
+        for (int op = 0; op < OP_COUNT; op++) sent[op] += w->sent[op];
+        delivered += w->delivered;
+        limited += w->limited;
+        reconnects += w->reconnects;
+        errors += w->errors;
+        bytes_in += w->bytes_in;
+    }
+    unsigned long total_sent = sent[OP_CHAT] + sent[OP_ALL] + sent[OP_MSG] + sent[OP_LIST];
+
+    printf("\n=== 결과 (%.1f초) ===\n", elapsed);
+    printf("전송: %lu건 (%.0f/s) - chat %lu, all %lu, msg %lu, list %lu\n",
+           total_sent, total_sent / elapsed, sent[OP_CHAT], sent[OP_ALL], sent[OP_MSG], sent[OP_LIST]);
+    printf("배달: %lu건 (%.0f/s), 수신 %.1f MB/s\n",
+           delivered, delivered / elapsed, bytes_in / elapsed / 1e6);
+    print_hist("배달 지연", &delivery);
+    print_hist("/list 응답", &list_latency);
+    printf("속도 제한 안내: %lu, 재접속: %lu, 오류: %lu\n", limited, reconnects, errors);
+    if (reconnects > 0) {
+        printf("재접속: %.0f/s\n", reconnects / elapsed);
+        print_hist("접속→환영 메시지", &connect_latency);
+        print_server_sessions();
+    }
+    return 0;
+}
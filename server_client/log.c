@@ -0,0 +1,286 @@
+// log.c - 비동기 로그 (쓰레드별 링 버퍼 + 쓰기 쓰레드)
+//
+// 링은 칸마다 순번(seq)을 두는 bounded queue입니다.
+// - 칸 pos가 비어 있으면 seq == pos, 기록이 끝나 읽을 수 있으면 seq == pos + 1
+// - 기록하는 쪽: tail을 CAS로 하나 올려 칸을 잡고, 채운 뒤 seq = pos + 1 (release)
+// - 쓰기 쓰레드: head 칸의 seq가 head + 1이면 읽고, seq = head + LOG_RING_SLOTS로 비움
+
+#include "log.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+
+#define LOG_OUT_BUF         65536       // 쓰기 쓰레드 출력 버퍼
+#define LOG_IDLE_NS         2000000     // 기록이 없을 때 쓰기 쓰레드가 쉬는 시간 (2ms)
+
+typedef struct {
+    unsigned long seq;
+    uint64_t ts;                // CLOCK_REALTIME (ns)
+    uint16_t len;
+    uint8_t level;
+    char text[LOG_TEXT_MAX];
+} log_slot;
+
+typedef struct {
+    unsigned long tail __attribute__((aligned(64)));    // 기록하는 쪽이 잡을 다음 칸
+    unsigned long head __attribute__((aligned(64)));    // 쓰기 쓰레드가 읽을 다음 칸
+    unsigned long dropped;
+    log_slot slots[LOG_RING_SLOTS];
+} log_ring;
+
+int log_level = LOG_INFO;
+
+static log_ring *rings[LOG_RINGS];      // 처음 쓸 때 할당 (해제하지 않음)
+static unsigned next_ring;
+static __thread log_ring *my_ring;
+static unsigned long early_dropped;     // 링을 할당하지 못해 버린 수
+
+static int log_fd = STDOUT_FILENO;
+static pthread_mutex_t drain_lock = PTHREAD_MUTEX_INITIALIZER;  // 읽는 쪽은 한 번에 하나
+
+static const char *level_names[] = { "DEBUG", "INFO", "WARN", "ERROR" };
+
+// ================= 기록 =================
+
+// 현재 쓰레드의 링 (처음이면 순서대로 하나 받음)
+static log_ring *ring_self(void) {
+    if (my_ring) return my_ring;
+
+    unsigned i = __atomic_fetch_add(&next_ring, 1, __ATOMIC_RELAXED) % LOG_RINGS;
+    log_ring *r = __atomic_load_n(&rings[i], __ATOMIC_ACQUIRE);
+    if (!r) {
+        log_ring *fresh = aligned_alloc(64, sizeof(log_ring));
+        if (!fresh) return NULL;
+        memset(fresh, 0, sizeof(log_ring));
+        for (unsigned long s = 0; s < LOG_RING_SLOTS; s++) fresh->slots[s].seq = s;
+        if (__atomic_compare_exchange_n(&rings[i], &r, fresh, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            r = fresh;
+        } else {
+            free(fresh);                    // 다른 쓰레드가 먼저 할당함
+        }
+    }
+    my_ring = r;
+    return r;
+}
+
+// 빈 칸 하나 잡기 (가득 찼으면 NULL)
+static log_slot *slot_reserve(log_ring *r, unsigned long *pos_out) {
+    unsigned long pos = __atomic_load_n(&r->tail, __ATOMIC_RELAXED);
+    while (1) {
+        log_slot *s = &r->slots[pos & (LOG_RING_SLOTS - 1)];
+        long diff = (long)(__atomic_load_n(&s->seq, __ATOMIC_ACQUIRE) - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&r->tail, &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                *pos_out = pos;
+                return s;
+            }
+        } else if (diff < 0) {
+            return NULL;                    // 가득 참
+        } else {
+            pos = __atomic_load_n(&r->tail, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static inline uint64_t realtime_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// 칸을 잡아 시각/레벨을 채움 (실패 시 버린 수 증가)
+static log_slot *log_begin(int level, unsigned long *pos) {
+    log_ring *r = ring_self();
+    if (!r) {
+        __atomic_fetch_add(&early_dropped, 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+    log_slot *s = slot_reserve(r, pos);
+    if (!s) {
+        __atomic_fetch_add(&r->dropped, 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+    s->ts = realtime_ns();
+    s->level = (uint8_t)level;
+    return s;
+}
+
+static inline void log_commit(log_slot *s, unsigned long pos) {
+    __atomic_store_n(&s->seq, pos + 1, __ATOMIC_RELEASE);
+}
+
+void log_write(int level, const char *text, size_t len) {
+    if (level < log_level) return;
+    unsigned long pos;
+    log_slot *s = log_begin(level, &pos);
+    if (!s) return;
+    if (len > LOG_TEXT_MAX) len = LOG_TEXT_MAX;
+    memcpy(s->text, text, len);
+    s->len = (uint16_t)len;
+    log_commit(s, pos);
+}
+
+void log_printf(int level, const char *fmt, ...) {
+    if (level < log_level) return;
+    unsigned long pos;
+    log_slot *s = log_begin(level, &pos);
+    if (!s) return;
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(s->text, LOG_TEXT_MAX, fmt, ap);     // NULL 종료자 자리 때문에 최대 LOG_TEXT_MAX - 1
+    va_end(ap);
+    if (n < 0) n = 0;
+    if (n > LOG_TEXT_MAX - 1) n = LOG_TEXT_MAX - 1;
+    s->len = (uint16_t)n;
+    log_commit(s, pos);
+}
+
+// ================= 출력 =================
+
+static int write_all(const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(log_fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+// 읽을 수 있는 맨 앞 칸 (없으면 NULL)
+static log_slot *ring_peek(log_ring *r) {
+    log_slot *s = &r->slots[r->head & (LOG_RING_SLOTS - 1)];
+    if (__atomic_load_n(&s->seq, __ATOMIC_ACQUIRE) != r->head + 1) return NULL;
+    return s;
+}
+
+/**
+ * drain - 링에 쌓인 기록을 시각 순서로 출력 (drain_lock 필요)
+ * @return: 출력한 기록 수
+ *
+ * 링마다 맨 앞 기록을 보고 가장 이른 것을 골라 출력하므로,
+ * 여러 쓰레드가 남긴 기록도 대체로 일어난 순서대로 나옵니다.
+ */
+static int drain(void) {
+    static char out[LOG_OUT_BUF];
+    size_t len = 0;
+    int count = 0;
+    time_t last_sec = 0;
+    struct tm tm;
+
+    while (1) {
+        log_ring *best = NULL;
+        log_slot *best_slot = NULL;
+        for (int i = 0; i < LOG_RINGS; i++) {
+            log_ring *r = __atomic_load_n(&rings[i], __ATOMIC_ACQUIRE);
+            if (!r) continue;
+            log_slot *s = ring_peek(r);
+            if (s && (!best_slot || s->ts < best_slot->ts)) {
+                best = r;
+                best_slot = s;
+            }
+        }
+        if (!best) break;
+
+        if (len + LOG_TEXT_MAX + 64 > sizeof(out)) {
+            write_all(out, len);
+            len = 0;
+        }
+        time_t sec = (time_t)(best_slot->ts / 1000000000ULL);
+        if (sec != last_sec) {
+            localtime_r(&sec, &tm);
+            last_sec = sec;
+        }
+        len += (size_t)snprintf(out + len, sizeof(out) - len, "%02d:%02d:%02d.%06u %-5s ",
+                                tm.tm_hour, tm.tm_min, tm.tm_sec,
+                                (unsigned)(best_slot->ts % 1000000000ULL / 1000),
+                                level_names[best_slot->level]);
+        memcpy(out + len, best_slot->text, best_slot->len);
+        len += best_slot->len;
+        out[len++] = '\n';
+
+        // 칸 비우기 (다음 바퀴에서 기록하는 쪽이 다시 잡을 수 있게)
+        __atomic_store_n(&best_slot->seq, best->head + LOG_RING_SLOTS, __ATOMIC_RELEASE);
+        best->head++;
+        count++;
+    }
+    if (len > 0) write_all(out, len);
+    return count;
+}
+
+static void *writer_loop(void *arg) {
+    struct timespec idle = { 0, LOG_IDLE_NS };
+    while (1) {
+        pthread_mutex_lock(&drain_lock);
+        int n = drain();
+        pthread_mutex_unlock(&drain_lock);
+        if (n == 0) nanosleep(&idle, NULL);
+    }
+    return NULL;
+}
+
+void log_flush(void) {
+    pthread_mutex_lock(&drain_lock);
+    drain();
+    pthread_mutex_unlock(&drain_lock);
+}
+
+/**
+ * log_init - 로그 출력 대상 열고 쓰기 쓰레드 시작
+ * @path: 로그 파일 (덧붙여 씀), NULL이면 표준 출력
+ * @return: 0 성공, -1 실패
+ *
+ * 쓰기 쓰레드는 시그널을 받지 않으므로 종료 시그널 처리 중 log_flush가 막히지 않습니다.
+ * 정상 종료(exit) 시 남은 기록은 atexit로 출력합니다.
+ */
+int log_init(const char *path) {
+    if (path) {
+        log_fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (log_fd < 0) {
+            perror("로그 파일 열기 실패");
+            return -1;
+        }
+    }
+
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, &old);
+    pthread_t tid;
+    int err = pthread_create(&tid, NULL, writer_loop, NULL);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+    if (err != 0) {
+        fprintf(stderr, "로그 쓰레드 생성 실패: %s\n", strerror(err));
+        return -1;
+    }
+    pthread_detach(tid);
+    atexit(log_flush);
+    return 0;
+}
+
+int log_parse_level(const char *name) {
+    for (int i = LOG_DEBUG; i <= LOG_ERROR; i++) {
+        if (strcasecmp(name, level_names[i]) == 0) return i;
+    }
+    return -1;
+}
+
+unsigned long log_dropped(void) {
+    unsigned long total = __atomic_load_n(&early_dropped, __ATOMIC_RELAXED);
+    for (int i = 0; i < LOG_RINGS; i++) {
+        log_ring *r = __atomic_load_n(&rings[i], __ATOMIC_ACQUIRE);
+        if (r) total += __atomic_load_n(&r->dropped, __ATOMIC_RELAXED);
+    }
+    return total;
+}
@@ -0,0 +1,44 @@
+// log.h - 비동기 로그 헤더 파일
+//
+// 메시지 처리 경로에서 printf(stdio lock + 터미널/파이프 write)를 하지 않고
+// 쓰레드별 링 버퍼에 기록만 한 뒤, 백그라운드 쓰기 쓰레드가 모아서 출력합니다.
+// - 기록: 링 칸 하나를 lock 없이 잡고(CAS 한 번) 텍스트를 복사/포맷한 뒤 공개
+//   → 시계 읽기와 memcpy/vsnprintf 비용만 듦
+// - 시각은 기록할 때 ns 정수로만 저장하고, 사람이 읽는 형식으로 바꾸는 일은 쓰기 쓰레드가 함
+// - 링이 가득 차면 기다리지 않고 버리며 버린 수를 셈 (/stats, 지표 소켓에서 확인)
+// - 링은 쓰레드가 처음 기록할 때 받음. 리액터 쓰레드는 보통 링을 혼자 쓰고, 접속당 쓰레드
+//   모델처럼 쓰레드가 LOG_RINGS개보다 많으면 나눠 씀 (칸 예약이 CAS라 여러 쓰레드가 써도 안전)
+// - 쓰기 쓰레드는 링들의 맨 앞 기록 중 시각이 가장 이른 것부터 출력 (쓰레드 간 순서 유지)
+
+#ifndef LOG_H
+#define LOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ================= 설정 =================
+
+#define LOG_RINGS           64          // 최대 링 수
+#define LOG_RING_SLOTS      1024        // 링 하나의 칸 수 (2의 거듭제곱)
+#define LOG_TEXT_MAX        236         // 기록 하나의 최대 길이 (넘으면 잘림, 칸 하나 = 256바이트)
+
+// 로그 레벨
+#define LOG_DEBUG           0
+#define LOG_INFO            1
+#define LOG_WARN            2
+#define LOG_ERROR           3
+
+extern int log_level;                   // 이 레벨 미만은 기록하지 않음 (기본 LOG_INFO)
+
+// ================= 함수 선언 =================
+
+int  log_init(const char *path);        // 쓰기 쓰레드 시작 (path: NULL이면 표준 출력, -1: 실패)
+void log_write(int level, const char *text, size_t len);    // 텍스트 한 줄 기록 (개행 없이)
+void log_printf(int level, const char *fmt, ...)            // 포맷해서 기록 (%m: strerror(errno))
+        __attribute__((format(printf, 2, 3)));
+void log_flush(void);                   // 남은 기록을 모두 출력 (종료 시)
+
+int  log_parse_level(const char *name); // "debug|info|warn|error" (-1: 알 수 없음)
+unsigned long log_dropped(void);        // 링이 가득 차 버린 기록 수
+
+#endif // LOG_H
@@ -0,0 +1,66 @@
+// msgbuf.c - 참조 카운트 공유 메시지 버퍼
+
+#include "msgbuf.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 살아있는 버퍼 수/바이트 (팬아웃 메모리 사용량 확인용)
+static unsigned long g_live, g_bytes;
+
+static msgbuf *msgbuf_alloc(size_t len) {
+    msgbuf *m = malloc(sizeof(msgbuf) + len + 1);
+    if (!m) return NULL;
+    m->refs = 1;
+    m->keep = 0;
+    m->len = len;
+    __atomic_fetch_add(&g_live, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&g_bytes, len, __ATOMIC_RELAXED);
+    return m;
+}
+
+msgbuf *msgbuf_new(const char *data, size_t len) {
+    msgbuf *m = msgbuf_alloc(len);
+    if (!m) return NULL;
+    memcpy(m->data, data, len);
+    m->data[len] = '\0';
+    return m;
+}
+
+/**
+ * msgbuf_printf - printf 형식으로 공유 버퍼 생성
+ * @fmt: 형식 문자열
+ * @return: 참조 1개를 가진 버퍼, 실패 시 NULL
+ *
+ * 길이를 먼저 계산한 뒤 버퍼에 직접 포맷하므로 중간 복사가 없습니다.
+ */
+msgbuf *msgbuf_printf(const char *fmt, ...) {
+    va_list ap;
+
+    va_start(ap, fmt);
+    int len = vsnprintf(NULL, 0, fmt, ap);
+    va_end(ap);
+    if (len < 0) return NULL;
+
+    msgbuf *m = msgbuf_alloc((size_t)len);
+    if (!m) return NULL;
+
+    va_start(ap, fmt);
+    vsnprintf(m->data, (size_t)len + 1, fmt, ap);
+    va_end(ap);
+    return m;
+}
+
+void msgbuf_put(msgbuf *m) {
+    if (__atomic_sub_fetch(&m->refs, 1, __ATOMIC_ACQ_REL) != 0) return;
+    __atomic_fetch_sub(&g_live, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_sub(&g_bytes, m->len, __ATOMIC_RELAXED);
+    free(m);
+}
+
+void msgbuf_get_stats(unsigned long *live, unsigned long *bytes) {
+    *live = __atomic_load_n(&g_live, __ATOMIC_RELAXED);
+    *bytes = __atomic_load_n(&g_bytes, __ATOMIC_RELAXED);
+}
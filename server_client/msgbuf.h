@@ -0,0 +1,36 @@
+// msgbuf.h - 참조 카운트 공유 메시지 버퍼 헤더 파일
+//
+// 브로드캐스트 메시지를 한 번만 만들어(포맷) 두고, 모든 수신자의 송신 대기열이
+// 같은 버퍼를 가리키게 합니다. 수신자마다 메시지를 복사하지 않으며,
+// 마지막 수신자의 전송이 끝나 참조가 0이 되면 해제됩니다.
+//
+// 버퍼는 만든 뒤에는 읽기 전용입니다 (여러 쓰레드가 동시에 send 가능).
+
+#ifndef MSGBUF_H
+#define MSGBUF_H
+
+#include <stddef.h>
+
+// 공유 메시지 버퍼
+typedef struct {
+    int refs;                   // 참조 수 (원자적 연산으로만 변경)
+    int keep;                   // 송신 대기열이 버리지 않는 메시지 (보관 페이지 재전달, 보내기 전에 설정)
+    size_t len;                 // 데이터 길이 (NULL 종료자 제외)
+    char data[];                // 데이터 (항상 NULL 종료)
+} msgbuf;
+
+msgbuf *msgbuf_new(const char *data, size_t len);  // 데이터를 복사해 생성 (참조 1)
+msgbuf *msgbuf_printf(const char *fmt, ...)        // printf 형식으로 생성 (참조 1)
+        __attribute__((format(printf, 1, 2)));
+
+// 참조 추가
+static inline msgbuf *msgbuf_get(msgbuf *m) {
+    __atomic_fetch_add(&m->refs, 1, __ATOMIC_RELAXED);
+    return m;
+}
+
+void msgbuf_put(msgbuf *m);                         // 참조 해제 (0이 되면 메모리 해제)
+
+void msgbuf_get_stats(unsigned long *live, unsigned long *bytes);  // 살아있는 버퍼 수/바이트
+
+#endif // MSGBUF_H
@@ -0,0 +1,364 @@
+// outq.c - 클라이언트별 송신 대기열
+//
+// 생산자(브로드캐스트 하는 쓰레드 등)는 outq_push로 메시지를 넣기만 하고,
+// 소켓에 쓰는 일은 그 클라이언트를 담당하는 I/O 루프가 outq_flush로 수행합니다.
+// 대기열 항목은 공유 메시지 버퍼(msgbuf)의 참조만 가지므로 fanout 시 복사가 없습니다.
+// 전송은 앞쪽 메시지들을 iovec으로 모아 sendmsg 한 번으로 보내고, 보낸 바이트만큼
+// 앞에서부터 완료 처리합니다 (메시지 경계와 상관없이 일부만 보내진 경우도 같은 방식).
+
+#include "outq.h"
+#include "stats.h"          // 대기열 길이 히스토그램, 단조 시계
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+
+unsigned outq_max_depth = OUTQ_DEFAULT_MAX_DEPTH;
+int outq_policy = OUTQ_DROP_OLDEST;
+unsigned outq_batch_usec = 0;
+size_t outq_batch_bytes = OUTQ_DEFAULT_BATCH_BYTES;
+int outq_cork = 0;
+
+// 서버 전체 카운터 (여러 쓰레드에서 갱신)
+static unsigned long g_depth, g_peak, g_enqueued, g_sent, g_sent_bytes, g_writes, g_dropped, g_disconnects;
+
+static inline void counter_add(unsigned long *c, unsigned long v) {
+    __atomic_fetch_add(c, v, __ATOMIC_RELAXED);
+}
+
+static inline void counter_sub(unsigned long *c, unsigned long v) {
+    __atomic_fetch_sub(c, v, __ATOMIC_RELAXED);
+}
+
+static void update_peak(unsigned depth) {
+    unsigned long cur = __atomic_load_n(&g_peak, __ATOMIC_RELAXED);
+    while (depth > cur &&
+           !__atomic_compare_exchange_n(&g_peak, &cur, depth, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+// 대기열 항목 해제 (공유 버퍼 참조 반환)
+static void msg_free(outq_msg *m) {
+    msgbuf_put(m->buf);
+    free(m);
+}
+
+void outq_init(outq *q) {
+    pthread_mutex_init(&q->lock, NULL);
+    q->head = q->tail = NULL;
+    q->depth = 0;
+    q->peak = 0;
+    q->bytes = 0;
+    q->since = 0;
+    q->overflowed = 0;
+    q->dropped = 0;
+}
+
+void outq_destroy(outq *q) {
+    pthread_mutex_lock(&q->lock);
+    outq_msg *m = q->head;
+    while (m) {
+        outq_msg *next = m->next;
+        msg_free(m);
+        m = next;
+    }
+    counter_sub(&g_depth, q->depth);
+    q->head = q->tail = NULL;
+    q->depth = 0;
+    q->bytes = 0;
+    pthread_mutex_unlock(&q->lock);
+    pthread_mutex_destroy(&q->lock);
+}
+
+// 메시지 m을 대기열에서 떼어냄 (prev: 앞 메시지, 없으면 NULL). lock을 잡은 상태에서 호출
+static void unlink_locked(outq *q, outq_msg *prev, outq_msg *m) {
+    if (prev) prev->next = m->next;
+    else q->head = m->next;
+    if (q->tail == m) q->tail = prev;
+    q->depth--;
+    q->bytes -= m->buf->len - m->off;
+    counter_sub(&g_depth, 1);
+}
+
+// 보낸 바이트 수만큼 앞쪽 메시지를 완료 처리 (마지막 메시지는 일부만 보냈을 수 있음)
+static void advance_locked(outq *q, size_t sent) {
+    while (sent > 0 && q->head) {
+        outq_msg *m = q->head;
+        size_t left = m->buf->len - m->off;
+        size_t k = sent < left ? sent : left;
+        m->off += k;
+        q->bytes -= k;
+        sent -= k;
+        if (m->off < m->buf->len) break;
+
+        counter_add(&g_sent_bytes, m->buf->len);
+        unlink_locked(q, NULL, m);
+        msg_free(m);
+        counter_add(&g_sent, 1);
+    }
+}
+
+// 앞쪽 메시지를 최대 max개 iovec으로 모음 (msgs가 NULL이 아니면 메시지도 저장)
+static int gather_locked(outq *q, struct iovec *iov, outq_msg **msgs, int max) {
+    int n = 0;
+    for (outq_msg *m = q->head; m && n < max; m = m->next, n++) {
+        iov[n].iov_base = m->buf->data + m->off;
+        iov[n].iov_len = m->buf->len - m->off;
+        if (msgs) msgs[n] = m;
+    }
+    return n;
+}
+
+// 전송을 시작하지 않은 가장 오래된 메시지를 버림 (keep 메시지는 건너뜀). 버릴 것이 없으면 0
+static int drop_oldest_locked(outq *q) {
+    outq_msg *prev = NULL;
+    for (outq_msg *m = q->head; m; prev = m, m = m->next) {
+        if (m->off == 0 && !m->inflight && !m->buf->keep) {
+            unlink_locked(q, prev, m);
+            msg_free(m);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * outq_push - 대기열에 메시지 추가
+ * @q: 대상 대기열
+ * @buf: 보낼 공유 버퍼 (대기열이 참조를 하나 추가로 가짐, 복사 없음)
+ * @was_empty: NULL이 아니면 추가 전에 대기열이 비어 있었는지 저장 (깨우기 판단용)
+ * @return: OUTQ_OK / OUTQ_DROPPED / OUTQ_OVERFLOW
+ *
+ * keep이 켜진 버퍼는 가득 차 있어도 다른 메시지를 버리지 않고 그대로 넣습니다.
+ * 넣는 쪽이 outq_room만큼씩 나눠 넣으므로 넘치는 양은 그 사이 들어온 메시지 수 정도입니다.
+ */
+int outq_push(outq *q, msgbuf *buf, int *was_empty) {
+    int ret = OUTQ_OK;
+
+    pthread_mutex_lock(&q->lock);
+    if (was_empty) *was_empty = (q->head == NULL);
+
+    if (q->overflowed) {
+        pthread_mutex_unlock(&q->lock);     // 이미 끊기로 한 연결
+        return OUTQ_DROPPED;
+    }
+
+    if (q->depth >= outq_max_depth && !buf->keep) {
+        if (outq_policy == OUTQ_DISCONNECT) {
+            q->overflowed = 1;
+            pthread_mutex_unlock(&q->lock);
+            counter_add(&g_disconnects, 1);
+            return OUTQ_OVERFLOW;
+        }
+        if (outq_policy == OUTQ_DROP_NEWEST || !drop_oldest_locked(q)) {
+            q->dropped++;
+            pthread_mutex_unlock(&q->lock);
+            counter_add(&g_dropped, 1);
+            return OUTQ_DROPPED;
+        }
+        q->dropped++;
+        counter_add(&g_dropped, 1);
+        ret = OUTQ_DROPPED;
+    }
+
+    outq_msg *m = malloc(sizeof(outq_msg));
+    if (!m) {
+        pthread_mutex_unlock(&q->lock);
+        return OUTQ_DROPPED;
+    }
+    m->next = NULL;
+    m->buf = msgbuf_get(buf);
+    m->off = 0;
+    m->inflight = 0;
+
+    if (!q->head && outq_batch_usec) q->since = stats_now();   // 묶음 창 시작
+    if (q->tail) q->tail->next = m;
+    else q->head = m;
+    q->tail = m;
+    q->depth++;
+    q->bytes += buf->len;
+    if (q->depth > q->peak) q->peak = q->depth;
+    unsigned depth = q->depth;
+    pthread_mutex_unlock(&q->lock);
+
+    stats_record(STAT_OUTQ_DEPTH, depth);
+
+    counter_add(&g_depth, 1);
+    counter_add(&g_enqueued, 1);
+    update_peak(q->peak);
+    return ret;
+}
+
+/**
+ * outq_flush - 논블로킹 소켓으로 대기열을 가능한 만큼 전송
+ * @q: 대상 대기열
+ * @fd: 논블로킹 소켓
+ * @return: 0 = 모두 전송, 1 = 소켓 버퍼가 가득 차 남음 (쓰기 가능 이벤트 대기), -1 = 오류
+ *
+ * 쌓인 메시지를 OUTQ_IOV_MAX개씩 sendmsg 한 번으로 보냅니다.
+ */
+int outq_flush(outq *q, int fd) {
+    struct iovec iov[OUTQ_IOV_MAX];
+
+    pthread_mutex_lock(&q->lock);
+    while (q->head) {
+        int n = gather_locked(q, iov, NULL, OUTQ_IOV_MAX);
+        struct msghdr msg = { .msg_iov = iov, .msg_iovlen = (size_t)n };
+        int flags = MSG_NOSIGNAL | MSG_DONTWAIT;
+        if (outq_cork && q->depth > (unsigned)n) flags |= MSG_MORE;    // 뒤에 더 있음 - 꽉 찬 세그먼트만 전송
+
+        ssize_t sent = sendmsg(fd, &msg, flags);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            pthread_mutex_unlock(&q->lock);
+            return (errno == EAGAIN || errno == EWOULDBLOCK) ? 1 : -1;
+        }
+        counter_add(&g_writes, 1);
+        advance_locked(q, (size_t)sent);    // 일부만 전송됐으면 다시 시도해서 EAGAIN 확인
+    }
+    pthread_mutex_unlock(&q->lock);
+    return 0;
+}
+
+int outq_pending(outq *q) {
+    pthread_mutex_lock(&q->lock);
+    int pending = (q->head != NULL);
+    pthread_mutex_unlock(&q->lock);
+    return pending;
+}
+
+// 가득 찰 때까지 더 넣을 수 있는 메시지 수 (이미 넘친 대기열은 0 - 보관 페이지 재전달을 나누는 단위)
+unsigned outq_room(outq *q) {
+    pthread_mutex_lock(&q->lock);
+    unsigned room = q->depth < outq_max_depth ? outq_max_depth - q->depth : 0;
+    if (q->overflowed) room = 0;
+    pthread_mutex_unlock(&q->lock);
+    return room;
+}
+
+/**
+ * outq_batch_wait - 지금 전송할지, 묶음 창이 끝날 때까지 기다릴지
+ * @q: 대상 대기열
+ * @return: -1 = 보낼 것이 없음, 0 = 지금 전송, 양수 = 묶음 창이 끝날 때까지 남은 시간(us)
+ *
+ * 묶음 창이 꺼져 있거나, 쌓인 바이트가 기준을 넘었거나, 창 시간이 지났으면 0입니다.
+ * 일부만 보내고 남은 대기열은 창 시간이 이미 지났으므로 항상 0입니다.
+ */
+long outq_batch_wait(outq *q) {
+    long wait = 0;
+    pthread_mutex_lock(&q->lock);
+    if (!q->head) {
+        wait = -1;
+    } else if (outq_batch_usec && q->bytes < outq_batch_bytes) {
+        uint64_t deadline = q->since + (uint64_t)outq_batch_usec * 1000;
+        uint64_t now = stats_now();
+        if (now < deadline) wait = (long)((deadline - now + 999) / 1000);
+    }
+    pthread_mutex_unlock(&q->lock);
+    return wait;
+}
+
+/**
+ * outq_gather - 앞쪽 메시지를 iovec으로 모으고 전송 중으로 표시 (io_uring용)
+ * @q: 대상 대기열
+ * @iov: 채울 iovec 배열
+ * @msgs: 모은 메시지 (outq_advance에 그대로 넘김)
+ * @max: 최대 메시지 수
+ * @return: 모은 메시지 수
+ *
+ * 전송 중인 메시지는 drop-oldest 정책으로 버려지지 않습니다.
+ */
+int outq_gather(outq *q, struct iovec *iov, outq_msg **msgs, int max) {
+    pthread_mutex_lock(&q->lock);
+    int n = gather_locked(q, iov, msgs, max);
+    for (int i = 0; i < n; i++) msgs[i]->inflight = 1;
+    pthread_mutex_unlock(&q->lock);
+    if (n > 0) counter_add(&g_writes, 1);
+    return n;
+}
+
+/**
+ * outq_advance - outq_gather로 보낸 요청의 결과 반영 (io_uring용)
+ * @q: 대상 대기열
+ * @msgs: outq_gather가 모은 메시지 (대기열 맨 앞에 순서대로 있음)
+ * @n: 메시지 수
+ * @sent: 보낸 바이트 수, 음수면 전송 실패 - 모은 메시지를 모두 버림
+ *
+ * 보내지 못한 나머지는 전송 중 표시만 풀고 대기열에 남겨 다음 요청에서 보냅니다.
+ */
+void outq_advance(outq *q, outq_msg **msgs, int n, ssize_t sent) {
+    pthread_mutex_lock(&q->lock);
+    for (int i = 0; i < n; i++) msgs[i]->inflight = 0;
+    if (sent >= 0) {
+        advance_locked(q, (size_t)sent);
+    } else {
+        for (int i = 0; i < n && q->head; i++) {
+            outq_msg *m = q->head;
+            unlink_locked(q, NULL, m);
+            msg_free(m);
+        }
+    }
+    pthread_mutex_unlock(&q->lock);
+}
+
+void outq_get_stats(outq_stats *st) {
+    st->depth = __atomic_load_n(&g_depth, __ATOMIC_RELAXED);
+    st->peak = __atomic_load_n(&g_peak, __ATOMIC_RELAXED);
+    st->enqueued = __atomic_load_n(&g_enqueued, __ATOMIC_RELAXED);
+    st->sent = __atomic_load_n(&g_sent, __ATOMIC_RELAXED);
+    st->sent_bytes = __atomic_load_n(&g_sent_bytes, __ATOMIC_RELAXED);
+    st->writes = __atomic_load_n(&g_writes, __ATOMIC_RELAXED);
+    st->dropped = __atomic_load_n(&g_dropped, __ATOMIC_RELAXED);
+    st->disconnects = __atomic_load_n(&g_disconnects, __ATOMIC_RELAXED);
+}
+
+int outq_parse_policy(const char *name) {
+    if (strcmp(name, "drop-oldest") == 0) return OUTQ_DROP_OLDEST;
+    if (strcmp(name, "drop-newest") == 0) return OUTQ_DROP_NEWEST;
+    if (strcmp(name, "disconnect") == 0) return OUTQ_DISCONNECT;
+    return -1;
+}
+
+const char *outq_policy_name(int policy) {
+    switch (policy) {
+    case OUTQ_DROP_NEWEST: return "drop-newest";
+    case OUTQ_DISCONNECT:  return "disconnect";
+    default:               return "drop-oldest";
+    }
+}
+
+/**
+ * outq_parse_batch - 묶음 전송 설정
+ * @spec: "창us[,바이트][,cork]" (예: "500", "1000,32768,cork"), "off"면 바로 전송
+ * @return: 0 성공, -1 형식 오류
+ */
+int outq_parse_batch(const char *spec) {
+    if (strcmp(spec, "off") == 0) {
+        outq_batch_usec = 0;
+        outq_cork = 0;
+        return 0;
+    }
+    char *end;
+    long usec = strtol(spec, &end, 10);
+    if (end == spec || usec < 0 || usec > 1000000) return -1;
+
+    long bytes = OUTQ_DEFAULT_BATCH_BYTES;
+    int cork = 0;
+    while (*end == ',') {
+        const char *p = end + 1;
+        if (strncmp(p, "cork", 4) == 0 && (p[4] == ',' || p[4] == '\0')) {
+            cork = 1;
+            end = (char *)p + 4;
+            continue;
+        }
+        bytes = strtol(p, &end, 10);
+        if (end == p || bytes < 1) return -1;
+    }
+    if (*end != '\0') return -1;
+
+    outq_batch_usec = (unsigned)usec;
+    outq_batch_bytes = (size_t)bytes;
+    outq_cork = cork;
+    return 0;
+}
@@ -0,0 +1,105 @@
+// outq.h - 클라이언트별 송신 대기열 헤더 파일
+//
+// 브로드캐스트/개인 메시지를 소켓에 바로 send하지 않고 클라이언트마다
+// 크기가 제한된 대기열에 넣은 뒤, I/O 루프가 소켓이 쓰기 가능할 때 비웁니다.
+// 수신이 느린 클라이언트 하나 때문에 다른 클라이언트로의 전송이 멈추지 않습니다.
+//
+// 대기열이 가득 찼을 때의 정책:
+// - drop-oldest : 가장 오래된(아직 전송을 시작하지 않은) 메시지를 버림
+// - drop-newest : 새 메시지를 버림
+// - disconnect  : 클라이언트 연결을 끊음
+//
+// 묶음 전송:
+// - 대기열에 쌓인 메시지는 writev(sendmsg) 한 번으로 최대 OUTQ_IOV_MAX개씩 보냄
+// - 묶음 창(-b)을 켜면 대기열이 비어 있다가 처음 들어온 메시지부터 창 시간 동안 또는
+//   쌓인 바이트가 기준을 넘을 때까지 기다렸다가 한 번에 보냄 (지연을 조금 늘리고 시스템 콜을 줄임)
+// - cork를 켜면 한 번에 다 보내지 못할 때 MSG_MORE(TCP_CORK와 같은 효과)로 꽉 찬 세그먼트만 보냄
+
+#ifndef OUTQ_H
+#define OUTQ_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include "msgbuf.h"         // 공유 메시지 버퍼
+
+// ================= 설정 =================
+
+#define OUTQ_DEFAULT_MAX_DEPTH  256         // 클라이언트당 최대 대기 메시지 수
+#define OUTQ_IOV_MAX            64          // writev 한 번에 모을 최대 메시지 수
+#define OUTQ_DEFAULT_BATCH_BYTES 16384      // 묶음 창 중이라도 이만큼 쌓이면 바로 전송
+
+// 가득 찼을 때 정책 (keep이 켜진 메시지는 어느 정책으로도 버리지 않음 - outq_room 참고)
+#define OUTQ_DROP_OLDEST    0
+#define OUTQ_DROP_NEWEST    1
+#define OUTQ_DISCONNECT     2
+
+// outq_push 반환값
+#define OUTQ_OK             0               // 대기열에 추가됨
+#define OUTQ_DROPPED        1               // 정책에 따라 메시지 하나를 버림
+#define OUTQ_OVERFLOW       2               // 연결을 끊어야 함 (처음 넘쳤을 때 한 번만 반환)
+
+extern unsigned outq_max_depth;             // 클라이언트당 최대 대기 메시지 수
+extern int outq_policy;                     // 가득 찼을 때 정책 (OUTQ_*)
+extern unsigned outq_batch_usec;            // 묶음 창 (us, 0: 바로 전송)
+extern size_t outq_batch_bytes;             // 묶음 창을 끝내는 바이트 수
+extern int outq_cork;                       // 다 보내지 못할 때 MSG_MORE 사용
+
+// ================= 자료 구조 =================
+
+// 대기 중인 메시지 하나 - 데이터는 복사하지 않고 공유 버퍼를 참조
+typedef struct outq_msg {
+    struct outq_msg *next;
+    msgbuf *buf;                // 공유 메시지 버퍼 (참조 하나 보유)
+    size_t off;                 // 이미 전송된 바이트 수
+    int inflight;               // io_uring에 제출되어 완료 대기 중
+} outq_msg;
+
+// 클라이언트 하나의 송신 대기열
+typedef struct {
+    pthread_mutex_t lock;
+    outq_msg *head, *tail;
+    unsigned depth;             // 현재 대기 메시지 수
+    unsigned peak;              // 최대 대기 메시지 수
+    size_t bytes;               // 아직 보내지 않은 바이트 수
+    uint64_t since;             // 비어 있던 대기열에 메시지가 들어온 시각 (묶음 창 시작, ns)
+    int overflowed;             // disconnect 정책으로 끊어야 하는 상태
+    unsigned long dropped;      // 이 대기열에서 버린 메시지 수
+} outq;
+
+// 서버 전체 대기열 카운터
+typedef struct {
+    unsigned long depth;        // 현재 모든 대기열의 메시지 수 합
+    unsigned long peak;         // 클라이언트 하나의 최대 대기 메시지 수
+    unsigned long enqueued;     // 누적 추가 메시지 수
+    unsigned long sent;         // 누적 전송 완료 메시지 수
+    unsigned long sent_bytes;   // 누적 전송 완료 바이트
+    unsigned long writes;       // 누적 쓰기 시스템 콜(io_uring: sendmsg 요청) 수
+    unsigned long dropped;      // 누적 버린 메시지 수
+    unsigned long disconnects;  // 대기열 초과로 끊은 연결 수
+} outq_stats;
+
+// ================= 함수 선언 =================
+
+void outq_init(outq *q);
+void outq_destroy(outq *q);                 // 남은 메시지 해제
+
+int  outq_push(outq *q, msgbuf *buf, int *was_empty);
+int  outq_flush(outq *q, int fd);           // 0: 모두 전송, 1: 남음(EAGAIN), -1: 오류
+int  outq_pending(outq *q);                 // 대기 메시지가 있는지
+unsigned outq_room(outq *q);                // 가득 찰 때까지 더 넣을 수 있는 메시지 수
+long outq_batch_wait(outq *q);              // -1: 비어 있음, 0: 지금 전송, 양수: 묶음 창 남은 시간(us)
+
+// io_uring용: 앞쪽 메시지를 iovec으로 모아 전송 중으로 표시하고, 완료되면 결과를 반영
+int  outq_gather(outq *q, struct iovec *iov, outq_msg **msgs, int max);
+void outq_advance(outq *q, outq_msg **msgs, int n, ssize_t sent);  // sent < 0: 모두 버림
+
+void outq_get_stats(outq_stats *st);
+int  outq_parse_policy(const char *name);   // 이름 → 정책 (-1: 알 수 없음)
+const char *outq_policy_name(int policy);
+int  outq_parse_batch(const char *spec);    // "창us[,바이트][,cork]" 또는 "off" (-1: 형식 오류)
+
+#endif // OUTQ_H
@@ -0,0 +1,574 @@
+// pagelog.c - 오프라인 호출(페이지) 보관 로그 (mmap, 추가 전용, group commit)
+
+#include "pagelog.h"
+#include "log.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define FILE_MAGIC      "PAGELOG1"
+#define REC_MAGIC       0x31454750u         // "PGE1"
+#define REC_PAGE        1                   // 보관 페이지
+#define REC_ACK         2                   // 받는 사람에게 seq까지 전달됨
+#define REC_OWNER       3                   // 호출번호 소유자 (데이터: 비밀번호 해시 8바이트)
+#define HDR_SIZE        64                  // 파일 헤더 크기 (첫 레코드 위치)
+#define BOX_BUCKETS     1024                // 받는 사람 색인 해시 버킷 수 (2의 거듭제곱)
+
+#define ALIGN8(x)       (((x) + 7) & ~(size_t)7)
+
+// 파일 헤더
+typedef struct {
+    char magic[8];
+    uint32_t gen;               // 세대 번호 (로그를 비울 때마다 증가)
+    uint32_t reserved[13];
+} file_hdr;
+
+// 레코드 헤더 (뒤에 len 바이트 데이터, 8바이트 정렬)
+typedef struct {
+    uint32_t magic;
+    uint32_t gen;               // 기록할 때의 세대 번호 (다르면 비우기 전의 옛 레코드)
+    uint32_t type;              // REC_PAGE / REC_ACK / REC_OWNER
+    uint32_t len;               // 데이터 길이
+    int32_t  target;            // 받는 사람 ID
+    uint32_t sum;               // 헤더(sum 제외) + 데이터 체크섬
+    uint64_t seq;               // 레코드 번호 (ACK: 이 번호까지 전달됨)
+} rec_hdr;
+
+// 받는 사람 한 명의 보관 페이지 (레코드 위치를 기록 순서대로)
+typedef struct page_box {
+    struct page_box *next;
+    int id;
+    int head, n, cap;           // offs[head..n)이 전달 대기
+    uint64_t *offs;
+    uint64_t owner;             // 소유자 비밀번호 해시 (0: 등록된 적 없음)
+} page_box;
+
+static pthread_mutex_t log_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t log_cond = PTHREAD_COND_INITIALIZER;
+
+static int log_fd = -1;
+static char *log_path, *log_tmp_path;       // 로그 경로, 비울 때 새로 쓰는 파일 경로 (<경로>.tmp)
+static char *log_map;                       // PAGELOG_MAX_SIZE만큼 예약한 매핑
+static size_t log_size;                     // 파일에 할당된 크기
+static size_t log_tail;                     // 다음 레코드 위치
+static size_t log_synced;                   // 디스크 반영이 끝난 위치
+static uint32_t log_gen;
+static uint64_t next_seq = 1;
+
+static page_box *boxes[BOX_BUCKETS];
+static unsigned long n_pending, n_stored, n_delivered, n_commits;
+static size_t owner_bytes;                  // 소유자 레코드 크기 합 (비운 뒤에도 다시 기록되는 양)
+
+// ================= 레코드 =================
+
+static uint32_t fnv1a(uint32_t h, const void *data, size_t len) {
+    const unsigned char *p = data;
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// 비밀번호 해시 (FNV-1a 64비트, 호출번호를 섞음). 0은 "소유자 없음"이므로 쓰지 않음
+static uint64_t secret_hash(int id, const char *secret) {
+    uint64_t h = 14695981039346656037ull;
+    const unsigned char *p = (const unsigned char *)&id;
+    for (size_t i = 0; i < sizeof(id); i++) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    for (p = (const unsigned char *)secret; *p; p++) {
+        h ^= *p;
+        h *= 1099511628211ull;
+    }
+    return h ? h : 1;
+}
+
+static uint32_t rec_sum(const rec_hdr *h, const char *data) {
+    rec_hdr tmp = *h;
+    tmp.sum = 0;
+    return fnv1a(fnv1a(2166136261u, &tmp, sizeof(tmp)), data, h->len);
+}
+
+// ================= 받는 사람 색인 =================
+
+static page_box *box_get(int id, int create) {
+    page_box **link = &boxes[(unsigned)id & (BOX_BUCKETS - 1)];
+    for (page_box *b = *link; b; b = b->next) {
+        if (b->id == id) return b;
+    }
+    if (!create) return NULL;
+
+    page_box *b = calloc(1, sizeof(page_box));
+    if (!b) return NULL;
+    b->id = id;
+    b->next = *link;
+    *link = b;
+    return b;
+}
+
+static int box_push(page_box *b, uint64_t off) {
+    if (b->n == b->cap) {
+        int cap = b->cap ? b->cap * 2 : 8;
+        uint64_t *offs = realloc(b->offs, cap * sizeof(uint64_t));
+        if (!offs) return -1;
+        b->offs = offs;
+        b->cap = cap;
+    }
+    b->offs[b->n++] = off;
+    return 0;
+}
+
+// seq 이하 페이지를 전달된 것으로 처리 (페이지는 seq 순서로 들어 있음)
+static void box_ack(page_box *b, uint64_t seq) {
+    while (b->head < b->n && ((rec_hdr *)(log_map + b->offs[b->head]))->seq <= seq) {
+        b->head++;
+        n_pending--;
+    }
+    if (b->head == b->n) b->head = b->n = 0;
+}
+
+// 로그를 비울 때 색인 정리 - 소유자가 없는 항목은 해제하고, 있는 항목은 페이지만 비움
+static void box_reset_all(void) {
+    for (int i = 0; i < BOX_BUCKETS; i++) {
+        page_box **link = &boxes[i];
+        while (*link) {
+            page_box *b = *link;
+            if (b->owner) {
+                b->head = b->n = 0;
+                link = &b->next;
+                continue;
+            }
+            *link = b->next;
+            free(b->offs);
+            free(b);
+        }
+    }
+}
+
+// ================= 기록 (log_lock 필요) =================
+
+// 파일을 PAGELOG_GROW 단위로 늘려 need 바이트를 더 쓸 수 있게 함
+static int reserve_locked(size_t need) {
+    if (log_tail + need <= log_size) return 0;
+    size_t size = log_size;
+    while (log_tail + need > size) size += PAGELOG_GROW;
+    if (size > PAGELOG_MAX_SIZE) return -1;
+
+    int err = posix_fallocate(log_fd, (off_t)log_size, (off_t)(size - log_size));
+    if (err != 0) {
+        log_printf(LOG_ERROR, "보관 로그 확장 실패: %s", strerror(err));
+        return -1;
+    }
+    log_size = size;
+    return 0;
+}
+
+// 레코드 하나를 매핑에 기록, 위치 반환 (-1: 공간 부족)
+static long append_locked(uint32_t type, int target, uint64_t seq, const char *data, size_t len) {
+    size_t need = sizeof(rec_hdr) + ALIGN8(len);
+    if (reserve_locked(need) < 0) return -1;
+
+    size_t off = log_tail;
+    rec_hdr h;
+    h.magic = REC_MAGIC;
+    h.gen = log_gen;
+    h.type = type;
+    h.len = (uint32_t)len;
+    h.target = target;
+    h.seq = seq;
+    h.sum = rec_sum(&h, data);
+    if (len) memcpy(log_map + off + sizeof(rec_hdr), data, len);     // ACK 레코드는 데이터 없음 (NULL)
+    memcpy(log_map + off, &h, sizeof(h));
+
+    log_tail += need;
+    pthread_cond_signal(&log_cond);         // 커밋 쓰레드 깨우기
+    return (long)off;
+}
+
+/**
+ * pagelog_claim - 호출번호 소유 확인 (소유자가 없으면 이 비밀번호로 기록)
+ * @target_id: 호출번호
+ * @secret: 비밀번호 (NULL 종료, PAGELOG_SECRET_MAX 바이트 이하)
+ * @return: PAGELOG_CLAIMED / PAGELOG_OWNER / PAGELOG_DENIED
+ *
+ * 로그를 쓰지 않으면 보관된 페이지가 없으므로 확인하지 않고 PAGELOG_OWNER입니다.
+ */
+int pagelog_claim(int target_id, const char *secret) {
+    if (target_id <= 0 || target_id > PAGELOG_MAX_ID) return PAGELOG_DENIED;
+    uint64_t hash = secret_hash(target_id, secret);
+
+    pthread_mutex_lock(&log_lock);
+    if (log_fd < 0) {
+        pthread_mutex_unlock(&log_lock);
+        return PAGELOG_OWNER;
+    }
+    page_box *b = box_get(target_id, 1);
+    int ret = PAGELOG_DENIED;
+    if (b && b->owner) {
+        ret = (b->owner == hash) ? PAGELOG_OWNER : PAGELOG_DENIED;
+    } else if (b && append_locked(REC_OWNER, target_id, 0, (const char *)&hash, sizeof(hash)) >= 0) {
+        b->owner = hash;
+        owner_bytes += sizeof(rec_hdr) + ALIGN8(sizeof(hash));
+        ret = PAGELOG_CLAIMED;
+    }
+    pthread_mutex_unlock(&log_lock);
+    return ret;
+}
+
+/**
+ * pagelog_store - 받는 사람이 오프라인인 페이지 보관
+ * @target_id: 받는 사람 ID
+ * @msg: 전달할 메시지 (그대로 다시 보냄)
+ * @len: 메시지 길이
+ * @return: 0 성공, -1 로그 없음/공간 부족/ID 범위 밖/등록된 적 없는 번호
+ *
+ * 매핑에 기록만 하고 돌아오며 디스크 반영은 커밋 쓰레드가 묶어서 합니다.
+ * 소유자가 없는 번호는 누가 먼저 등록하느냐에 따라 받는 사람이 바뀌므로 보관하지 않습니다.
+ */
+int pagelog_store(int target_id, const char *msg, size_t len) {
+    if (target_id <= 0 || target_id > PAGELOG_MAX_ID) return -1;
+
+    pthread_mutex_lock(&log_lock);
+    if (log_fd < 0) {
+        pthread_mutex_unlock(&log_lock);
+        return -1;
+    }
+
+    page_box *b = box_get(target_id, 0);
+    long off = (b && b->owner) ? append_locked(REC_PAGE, target_id, next_seq, msg, len) : -1;
+    if (off < 0 || box_push(b, (uint64_t)off) < 0) {
+        pthread_mutex_unlock(&log_lock);
+        return -1;
+    }
+    next_seq++;
+    n_pending++;
+    n_stored++;
+    pthread_mutex_unlock(&log_lock);
+    return 0;
+}
+
+/**
+ * pagelog_replay - 보관 중인 페이지를 기록 순서대로 최대 max건 전달
+ * @target_id: 받는 사람 ID
+ * @max: 이번에 전달할 최대 페이지 수 (받는 쪽 송신 대기열의 여유)
+ * @fn: 페이지마다 호출할 함수
+ * @arg: fn 인자
+ * @left: NULL이 아니면 아직 남은 페이지 수 저장
+ * @return: 전달한 페이지 수
+ *
+ * log_lock 아래에서는 페이지를 버퍼로 복사만 하고, fn은 lock을 놓은 뒤 호출합니다.
+ * fn이 받아들인 페이지까지만 ACK 레코드를 덧붙여 재시작 후 다시 전달하지 않게 합니다.
+ * 같은 받는 사람을 동시에 재전달하지 않는다고 가정합니다 (호출번호는 한 연결만 가짐).
+ */
+int pagelog_replay(int target_id, int max, pagelog_fn fn, void *arg, int *left) {
+    if (left) *left = 0;
+
+    pthread_mutex_lock(&log_lock);
+    page_box *b = (log_fd >= 0) ? box_get(target_id, 0) : NULL;
+    int n = b ? b->n - b->head : 0;
+    if (left) *left = n;
+    if (n > max) n = max;
+    if (n <= 0) {
+        pthread_mutex_unlock(&log_lock);
+        return 0;
+    }
+
+    msgbuf **pages = malloc((size_t)n * sizeof(msgbuf *));
+    uint64_t *seqs = malloc((size_t)n * sizeof(uint64_t));
+    if (!pages || !seqs) {
+        pthread_mutex_unlock(&log_lock);
+        free(pages);
+        free(seqs);
+        return 0;
+    }
+    for (int i = 0; i < n; i++) {
+        rec_hdr *h = (rec_hdr *)(log_map + b->offs[b->head + i]);
+        pages[i] = msgbuf_new((const char *)(h + 1), h->len);
+        if (pages[i]) pages[i]->keep = 1;
+        seqs[i] = h->seq;
+    }
+    pthread_mutex_unlock(&log_lock);
+
+    int count = 0;
+    while (count < n && pages[count] && fn(arg, pages[count]) == 0) count++;
+    for (int i = 0; i < n; i++) {
+        if (pages[i]) msgbuf_put(pages[i]);
+    }
+
+    pthread_mutex_lock(&log_lock);
+    b = box_get(target_id, 0);
+    if (count > 0 && b) {
+        box_ack(b, seqs[count - 1]);
+        if (append_locked(REC_ACK, target_id, seqs[count - 1], NULL, 0) < 0) {
+            log_printf(LOG_ERROR, "보관 로그 ACK 기록 실패 (재시작 시 다시 전달될 수 있음)");
+        }
+        n_delivered += count;
+    }
+    if (left) *left = b ? b->n - b->head : 0;
+    pthread_mutex_unlock(&log_lock);
+
+    free(pages);
+    free(seqs);
+    return count;
+}
+
+// ================= 커밋 쓰레드 =================
+
+// rename이 디스크에 반영되도록 로그가 있는 디렉터리를 fsync
+static void sync_dir(const char *path) {
+    char *copy = strdup(path);
+    if (!copy) return;
+    int fd = open(dirname(copy), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd >= 0) {
+        if (fsync(fd) < 0) log_printf(LOG_ERROR, "보관 로그 디렉터리 반영 실패: %m");
+        close(fd);
+    }
+    free(copy);
+}
+
+// 보관 페이지가 없고 로그가 커졌으면 소유자 레코드만 담은 새 세대 로그로 바꿈 (log_lock 필요)
+// 새 파일에 소유자 레코드를 모두 쓰고 msync한 뒤에야 rename으로 바꿔 넣으므로, 어느 순간에
+// 멈춰도 디스크에는 옛 로그 전체나 소유자가 모두 반영된 새 로그 중 하나가 남음
+// (제자리에서 세대만 올리면 소유자 레코드가 반영되기 전에 멈췄을 때 모든 번호의 소유자를 잃음)
+static void compact_locked(void) {
+    const char *what = "파일 생성";
+    int fd = open(log_tmp_path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    char *map = MAP_FAILED;
+    if (fd >= 0) {
+        what = "파일 할당";
+        errno = posix_fallocate(fd, 0, PAGELOG_GROW);
+        if (errno == 0) {
+            what = "mmap";
+            map = mmap(NULL, PAGELOG_MAX_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+    }
+    if (map == MAP_FAILED) {
+        log_printf(LOG_ERROR, "보관 로그 비우기 실패 (%s): %m", what);
+        if (fd >= 0) {
+            close(fd);
+            unlink(log_tmp_path);
+        }
+        return;
+    }
+
+    // 새 파일로 기록 위치를 옮겨 소유자 레코드를 씀 (실패하면 되돌리고 지금 로그를 계속 씀)
+    int old_fd = log_fd;
+    char *old_map = log_map;
+    size_t old_size = log_size, old_tail = log_tail;
+    uint32_t old_gen = log_gen;
+
+    file_hdr *hdr = (file_hdr *)map;
+    memset(hdr, 0, HDR_SIZE);
+    memcpy(hdr->magic, FILE_MAGIC, sizeof(hdr->magic));
+    hdr->gen = log_gen + 1;
+    log_fd = fd;
+    log_map = map;
+    log_size = PAGELOG_GROW;
+    log_tail = HDR_SIZE;
+    log_gen++;
+
+    int ok = 1;
+    what = "소유자 기록";
+    for (int i = 0; i < BOX_BUCKETS && ok; i++) {
+        for (page_box *b = boxes[i]; b && ok; b = b->next) {
+            if (b->owner && append_locked(REC_OWNER, b->id, 0, (const char *)&b->owner, sizeof(b->owner)) < 0) {
+                ok = 0;
+            }
+        }
+    }
+    if (ok && msync(map, log_tail, MS_SYNC) < 0) {
+        what = "msync";
+        ok = 0;
+    }
+    if (ok && rename(log_tmp_path, log_path) < 0) {
+        what = "rename";
+        ok = 0;
+    }
+    if (!ok) {
+        log_printf(LOG_ERROR, "보관 로그 비우기 실패 (%s): %m", what);
+        munmap(map, PAGELOG_MAX_SIZE);
+        close(fd);
+        unlink(log_tmp_path);
+        log_fd = old_fd;
+        log_map = old_map;
+        log_size = old_size;
+        log_tail = old_tail;
+        log_gen = old_gen;
+        return;
+    }
+    sync_dir(log_path);
+
+    munmap(old_map, PAGELOG_MAX_SIZE);
+    close(old_fd);
+    box_reset_all();
+    log_synced = log_tail;
+}
+
+static void *commit_loop(void *arg) {
+    long page = sysconf(_SC_PAGESIZE);
+
+    pthread_mutex_lock(&log_lock);
+    while (1) {
+        while (log_synced == log_tail) {
+            pthread_cond_wait(&log_cond, &log_lock);
+        }
+
+        // 지금까지 쌓인 레코드를 한 번에 반영 (그동안 들어오는 레코드는 다음 차례)
+        size_t from = log_synced & ~(size_t)(page - 1);
+        size_t to = log_tail;
+        pthread_mutex_unlock(&log_lock);
+
+        if (msync(log_map + from, to - from, MS_SYNC) < 0) {
+            log_printf(LOG_ERROR, "보관 로그 반영 실패: %m");
+        }
+
+        pthread_mutex_lock(&log_lock);
+        log_synced = to;
+        n_commits++;
+        if (n_pending == 0 && log_tail == log_synced && log_tail >= PAGELOG_COMPACT_SIZE + owner_bytes) {
+            compact_locked();
+        }
+    }
+    return NULL;
+}
+
+// ================= 열기/복구 =================
+
+// 로그를 처음부터 읽어 받는 사람별 색인을 다시 만듦 (쓰다 만 레코드에서 멈춤)
+static void recover(void) {
+    size_t off = HDR_SIZE;
+    while (off + sizeof(rec_hdr) <= log_size) {
+        rec_hdr *h = (rec_hdr *)(log_map + off);
+        if (h->magic != REC_MAGIC || h->gen != log_gen) break;
+        if (off + sizeof(rec_hdr) + h->len > log_size) break;
+        if (h->sum != rec_sum(h, (const char *)(h + 1))) break;
+
+        if (h->type == REC_PAGE && (h->target <= 0 || h->target > PAGELOG_MAX_ID)) {
+            // 상한이 없던 때 기록된 범위 밖 번호 - 등록할 수 없으므로 색인에 넣지 않음
+        } else if (h->type == REC_PAGE) {
+            page_box *b = box_get(h->target, 1);
+            if (!b || box_push(b, off) < 0) break;
+            n_pending++;
+            if (h->seq >= next_seq) next_seq = h->seq + 1;
+        } else if (h->type == REC_ACK) {
+            page_box *b = box_get(h->target, 0);
+            if (b) box_ack(b, h->seq);
+        } else if (h->type == REC_OWNER && h->len == sizeof(uint64_t)) {
+            page_box *b = box_get(h->target, 1);
+            if (!b) break;
+            if (!b->owner) owner_bytes += sizeof(rec_hdr) + ALIGN8(h->len);
+            memcpy(&b->owner, h + 1, sizeof(b->owner));
+        }
+        off += sizeof(rec_hdr) + ALIGN8(h->len);
+    }
+    log_tail = log_synced = off;
+}
+
+/**
+ * pagelog_open - 보관 로그 열기
+ * @path: 로그 파일 경로 (없으면 새로 만듦)
+ * @return: 0 성공, -1 실패
+ *
+ * 기존 로그가 있으면 보관 중인 페이지 색인을 복구하고 커밋 쓰레드를 시작합니다.
+ */
+int pagelog_open(const char *path) {
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        perror("보관 로그 열기 실패");
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size > PAGELOG_MAX_SIZE) {
+        fprintf(stderr, "보관 로그 크기가 잘못되었습니다: %s\n", path);
+        close(fd);
+        return -1;
+    }
+    log_size = (size_t)st.st_size;
+    if (log_size < PAGELOG_GROW) {
+        int err = posix_fallocate(fd, 0, PAGELOG_GROW);
+        if (err != 0) {
+            fprintf(stderr, "보관 로그 할당 실패: %s\n", strerror(err));
+            close(fd);
+            return -1;
+        }
+        log_size = PAGELOG_GROW;
+    }
+
+    // 최대 크기만큼 주소 공간을 예약 - 파일이 늘어나도 다시 매핑하지 않음
+    char *map = mmap(NULL, PAGELOG_MAX_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        perror("보관 로그 mmap 실패");
+        close(fd);
+        return -1;
+    }
+
+    log_path = strdup(path);
+    log_tmp_path = malloc(strlen(path) + sizeof(".tmp"));
+    if (!log_path || !log_tmp_path) {
+        fprintf(stderr, "보관 로그 경로 할당 실패\n");
+        munmap(map, PAGELOG_MAX_SIZE);
+        close(fd);
+        return -1;
+    }
+    sprintf(log_tmp_path, "%s.tmp", path);
+
+    pthread_mutex_lock(&log_lock);
+    log_fd = fd;
+    log_map = map;
+    file_hdr *hdr = (file_hdr *)map;
+    if (memcmp(hdr->magic, FILE_MAGIC, sizeof(hdr->magic)) != 0) {
+        // 새 로그
+        memset(hdr, 0, HDR_SIZE);
+        memcpy(hdr->magic, FILE_MAGIC, sizeof(hdr->magic));
+        hdr->gen = 1;
+        msync(map, HDR_SIZE, MS_SYNC);
+    }
+    log_gen = hdr->gen;
+    recover();
+    pthread_mutex_unlock(&log_lock);
+
+    pthread_t tid;
+    if (pthread_create(&tid, NULL, commit_loop, NULL) != 0) {
+        perror("커밋 쓰레드 생성 실패");
+        return -1;
+    }
+    pthread_detach(tid);
+
+    log_printf(LOG_INFO, "보관 로그: %s (전달 대기 페이지 %lu건)", path, n_pending);
+    return 0;
+}
+
+int pagelog_enabled(void) {
+    return log_fd >= 0;
+}
+
+// 새 세션의 자동 ID를 고를 때 호출 (clients_mutex 안, 잠금 순서: clients_mutex → log_lock)
+int pagelog_owned(int target_id) {
+    if (target_id <= 0 || target_id > PAGELOG_MAX_ID) return 0;
+    pthread_mutex_lock(&log_lock);
+    page_box *b = log_fd >= 0 ? box_get(target_id, 0) : NULL;
+    int owned = b && b->owner;
+    pthread_mutex_unlock(&log_lock);
+    return owned;
+}
+
+void pagelog_get_stats(pagelog_stats *st) {
+    pthread_mutex_lock(&log_lock);
+    st->pending = n_pending;
+    st->stored = n_stored;
+    st->delivered = n_delivered;
+    st->commits = n_commits;
+    st->bytes = log_tail;
+    pthread_mutex_unlock(&log_lock);
+}
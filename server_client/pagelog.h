@@ -0,0 +1,73 @@
+// pagelog.h - 오프라인 호출(페이지) 보관 로그 헤더 파일
+//
+// 받는 사람이 접속해 있지 않은 귓속말(/msg)을 버리지 않고 파일에 보관했다가,
+// 그 사람이 자기 호출번호로 등록(/register)하면 순서대로 전달합니다.
+//
+// - 추가만 하는 로그 파일을 mmap으로 매핑해 레코드를 memcpy로 기록
+//   (파일은 PAGELOG_GROW 단위로 미리 할당, 매핑 주소는 바뀌지 않음)
+// - 전달이 끝나면 지우지 않고 ACK 레코드를 덧붙임. 재전달은 송신 대기열 여유만큼씩 나눠
+//   버리지 않는(keep) 메시지로 넣고, 넣은 페이지까지만 ACK함
+//   (대기열에 들어간 뒤 연결이 끊기면 그 페이지는 다시 전달되지 않음)
+// - 받는 사람별 색인(메모리)으로 보관 중인 페이지를 바로 찾음.
+//   서버 시작 시 로그를 처음부터 읽어 색인을 다시 만듦
+// - 디스크 반영(msync)은 별도 커밋 쓰레드가 그동안 쌓인 레코드를 한 번에 처리
+//   (group commit: 한 번 반영하는 동안 들어온 레코드는 다음 반영에 함께 묶임).
+//   기록하는 쪽은 fsync를 기다리지 않으며, 전원이 나가면 진행 중인 커밋 한 번
+//   분량의 페이지를 잃을 수 있음
+// - 호출번호는 처음 /register할 때 준 비밀번호(해시)로 소유자를 기록하고, 그 뒤로는
+//   비밀번호가 맞아야 등록/재전달함. 소유자가 없는 번호로 보낸 페이지는 보관하지 않음
+//   (로그 파일에는 비밀번호 해시가 남으므로 파일 권한으로 보호해야 함)
+// - 레코드마다 세대 번호와 체크섬이 있어 쓰다 만 레코드나 비운 뒤의 옛 레코드는 무시
+// - 보관 중인 페이지가 하나도 없고 로그가 충분히 커지면 커밋 쓰레드가 로그를 비움
+//   (소유자 레코드만 담은 새 파일을 반영한 뒤 rename으로 바꿔 넣음)
+
+#ifndef PAGELOG_H
+#define PAGELOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "msgbuf.h"         // 공유 메시지 버퍼
+
+// ================= 설정 =================
+
+#define PAGELOG_DEFAULT_PATH    "pages.log"
+#define PAGELOG_MAX_SIZE        (1UL << 30)     // 로그 최대 크기 (매핑 예약 크기)
+#define PAGELOG_GROW            (1UL << 20)     // 파일을 늘리는 단위
+#define PAGELOG_COMPACT_SIZE    (4UL << 20)     // 보관 페이지가 없을 때 로그를 비우는 크기
+#define PAGELOG_MAX_ID          999999999       // 받는 사람 ID 상한 (INT32_MAX보다 충분히 작게)
+#define PAGELOG_SECRET_MAX      32              // 호출번호 비밀번호 최대 길이 (바이트)
+
+// pagelog_claim 반환값
+#define PAGELOG_CLAIMED         1               // 소유자가 없던 번호 - 이 비밀번호로 기록함
+#define PAGELOG_OWNER           0               // 비밀번호 일치 (로그를 쓰지 않으면 항상)
+#define PAGELOG_DENIED          (-1)            // 비밀번호 불일치 또는 기록 실패
+
+// ================= 자료 구조 =================
+
+// 보관 로그 카운터
+typedef struct {
+    unsigned long pending;      // 전달을 기다리는 페이지 수
+    unsigned long stored;       // 누적 보관 페이지 수
+    unsigned long delivered;    // 누적 전달 페이지 수
+    unsigned long commits;      // 디스크 반영(msync) 횟수
+    unsigned long bytes;        // 현재 로그 크기 (바이트)
+} pagelog_stats;
+
+// 보관 페이지 재전달 콜백 (페이지 하나마다 호출, 기록 순서대로, keep이 켜진 버퍼)
+// 0: 대기열에 넣음, -1: 넣지 못함 (이 페이지부터는 ACK하지 않고 멈춤)
+typedef int (*pagelog_fn)(void *arg, msgbuf *page);
+
+// ================= 함수 선언 =================
+
+int  pagelog_open(const char *path);        // 로그 열기/복구, 커밋 쓰레드 시작 (-1: 실패)
+int  pagelog_enabled(void);
+
+int  pagelog_claim(int target_id, const char *secret);              // 호출번호 소유 확인/기록 (PAGELOG_*)
+int  pagelog_store(int target_id, const char *msg, size_t len);     // 페이지 보관 (-1: 실패/소유자 없음)
+int  pagelog_replay(int target_id, int max, pagelog_fn fn, void *arg, int *left);  // 최대 max건 전달 (전달 수)
+int  pagelog_owned(int target_id);          // 소유자가 기록된 호출번호인지 (자동 ID에서 제외)
+
+void pagelog_get_stats(pagelog_stats *st);
+
+#endif // PAGELOG_H
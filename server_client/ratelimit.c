@@ -0,0 +1,169 @@
+// ratelimit.c - token bucket 속도 제한
+
+#include "ratelimit.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TOKEN_UNIT      1000            // 토큰 1개 = 1000 단위
+#define MAX_ELAPSED_NS  60000000000ULL  // 한 번에 채우는 시간 상한 (곱셈 넘침 방지)
+#define FANOUT_REFILL_NS 100000ULL      // fanout 예산을 채우는 최소 간격 (공유 캐시 줄 쓰기 줄이기)
+
+unsigned rate_per_sec[RATE_CLASSES] = {
+    RATE_DEFAULT_CHAT, RATE_DEFAULT_BROADCAST, RATE_DEFAULT_PRIVATE,
+};
+unsigned rate_fanout_per_sec = RATE_DEFAULT_FANOUT;
+
+// 전체 fanout 예산 - 모든 I/O 쓰레드가 나눠 씀 (원자적 연산으로만 변경)
+// fanout_last가 0이면 첫 채우기에서 시간 상한만큼 채워져 burst로 시작
+static int64_t fanout_tokens;
+static uint64_t fanout_last;
+
+static unsigned long g_allowed[RATE_CLASSES];
+static unsigned long g_limited[RATE_CLASSES];
+static unsigned long g_fanout_limited;
+
+static inline void stat_inc(unsigned long *c) {
+    __atomic_fetch_add(c, 1, __ATOMIC_RELAXED);
+}
+
+static inline uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// 지난 시간만큼 토큰 채우기 (최대 burst = 초당 횟수 2배)
+static void refill(rate_bucket *b, unsigned per_sec, uint64_t now) {
+    uint64_t elapsed = now - b->last_ns;
+    if (elapsed > MAX_ELAPSED_NS) elapsed = MAX_ELAPSED_NS;
+    int64_t burst = (int64_t)per_sec * 2 * TOKEN_UNIT;
+    b->tokens += (int64_t)(elapsed * per_sec / (1000000000ULL / TOKEN_UNIT));
+    if (b->tokens > burst) b->tokens = burst;
+    b->last_ns = now;
+}
+
+/**
+ * rate_parse - 종류별 초당 횟수 설정
+ * @spec: "채팅,전체,귓속말" (예: "10,2,10"), "off"면 모두 제한 없음
+ * @return: 0 성공, -1 형식 오류
+ */
+int rate_parse(const char *spec) {
+    unsigned v[RATE_CLASSES] = { 0 };
+    if (strcmp(spec, "off") == 0) {
+        for (int i = 0; i < RATE_CLASSES; i++) rate_per_sec[i] = 0;
+        return 0;
+    }
+    const char *p = spec;
+    for (int i = 0; i < RATE_CLASSES; i++) {
+        char *end;
+        long n = strtol(p, &end, 10);
+        if (end == p || n < 0 || n > 1000000) return -1;
+        v[i] = (unsigned)n;
+        if (i < RATE_CLASSES - 1) {
+            if (*end != ',') return -1;
+            p = end + 1;
+        } else if (*end != '\0') {
+            return -1;
+        }
+    }
+    for (int i = 0; i < RATE_CLASSES; i++) rate_per_sec[i] = v[i];
+    return 0;
+}
+
+void rate_init(rate_bucket *b) {
+    uint64_t now = now_ns();
+    for (int i = 0; i < RATE_CLASSES; i++) {
+        b[i].tokens = (int64_t)rate_per_sec[i] * 2 * TOKEN_UNIT;
+        b[i].last_ns = now;
+        b[i].limited = 0;
+    }
+}
+
+// 전체 fanout 예산 채우기 - 마지막 채운 시각을 CAS로 바꾼 쓰레드만 지난 시간만큼 더함
+static void fanout_refill(uint64_t now) {
+    uint64_t last = __atomic_load_n(&fanout_last, __ATOMIC_RELAXED);
+    if (now < last + FANOUT_REFILL_NS) return;
+    if (!__atomic_compare_exchange_n(&fanout_last, &last, now, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        return;                             // 다른 쓰레드가 이번 간격을 채움
+    }
+    uint64_t elapsed = now - last;
+    if (elapsed > MAX_ELAPSED_NS) elapsed = MAX_ELAPSED_NS;
+    int64_t burst = (int64_t)rate_fanout_per_sec * 2 * TOKEN_UNIT;
+    int64_t add = (int64_t)(elapsed * rate_fanout_per_sec / (1000000000ULL / TOKEN_UNIT));
+    int64_t cur = __atomic_add_fetch(&fanout_tokens, add, __ATOMIC_RELAXED);
+    while (cur > burst &&
+           !__atomic_compare_exchange_n(&fanout_tokens, &cur, burst, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+// 전체 fanout 예산이 남아 있는지 (보내기 전에 확인, 쓰는 것은 rate_charge_fanout)
+static int fanout_available(uint64_t now) {
+    fanout_refill(now);
+    return __atomic_load_n(&fanout_tokens, __ATOMIC_RELAXED) > 0;
+}
+
+/**
+ * rate_admit - 메시지를 처리할지 판단
+ * @b: 클라이언트의 bucket 배열 (RATE_CLASSES개, 주인 I/O 루프만 호출)
+ * @cls: 명령어 종류 (RATE_*)
+ * @notify: 거절 시 1이면 발신자에게 안내 (연속 거절 중 첫 번째만 1)
+ * @return: 1 처리, 0 거절
+ *
+ * 채팅/전체 종류는 클라이언트 bucket에 더해 전체 fanout 예산도 확인합니다.
+ */
+int rate_admit(rate_bucket *b, int cls, int *notify) {
+    *notify = 0;
+    if (cls == RATE_NONE) return 1;
+
+    rate_bucket *cb = &b[cls];
+    unsigned per_sec = rate_per_sec[cls];
+    uint64_t now = now_ns();
+    if (per_sec > 0) {
+        refill(cb, per_sec, now);
+        if (cb->tokens < TOKEN_UNIT) {
+            stat_inc(&g_limited[cls]);
+            *notify = !cb->limited;
+            cb->limited = 1;
+            return 0;
+        }
+    }
+    if ((cls == RATE_CHAT || cls == RATE_BROADCAST) && rate_fanout_per_sec > 0 &&
+        !fanout_available(now)) {
+        stat_inc(&g_fanout_limited);
+        *notify = !cb->limited;
+        cb->limited = 1;
+        return 0;
+    }
+    if (per_sec > 0) cb->tokens -= TOKEN_UNIT;
+    cb->limited = 0;
+    stat_inc(&g_allowed[cls]);
+    return 1;
+}
+
+/**
+ * rate_charge_fanout - 보낸 수신자 수만큼 전체 fanout 예산 사용
+ * @recipients: 메시지를 받은(대기열에 넣은) 클라이언트 수
+ */
+void rate_charge_fanout(unsigned long recipients) {
+    if (rate_fanout_per_sec == 0 || recipients == 0) return;
+    __atomic_sub_fetch(&fanout_tokens, (int64_t)recipients * TOKEN_UNIT, __ATOMIC_RELAXED);
+}
+
+const char *rate_class_name(int cls) {
+    switch (cls) {
+    case RATE_CHAT:         return "채팅";
+    case RATE_BROADCAST:    return "전체";
+    case RATE_PRIVATE:      return "귓속말";
+    default:                return "없음";
+    }
+}
+
+void rate_get_stats(rate_stats *st) {
+    for (int i = 0; i < RATE_CLASSES; i++) {
+        st->allowed[i] = __atomic_load_n(&g_allowed[i], __ATOMIC_RELAXED);
+        st->limited[i] = __atomic_load_n(&g_limited[i], __ATOMIC_RELAXED);
+    }
+    st->fanout_limited = __atomic_load_n(&g_fanout_limited, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,63 @@
+// ratelimit.h - 클라이언트별 속도 제한 / 전체 fanout 예산 헤더 파일
+//
+// 한 단말기가 메시지를 쏟아내도 다른 사용자의 지연이 늘어나지 않도록
+// 처리하기 전에 (작업 풀에 넘기는 메시지도 넘기기 전에) token bucket으로 받아들일지 정합니다.
+// - 클라이언트마다, 명령어 종류(채팅/전체/귓속말)마다 bucket 하나
+//   → 주인 I/O 루프만 만지므로 lock 없음
+// - 모든 클라이언트가 나눠 쓰는 fanout 예산 bucket 하나 (초당 전달 수신자 수)
+//   → lock 없이 원자적 카운터로 확인/차감하고, 채우기는 시각 CAS에 이긴 쓰레드 하나만 함
+//   → 브로드캐스트/그룹 호출은 보낸 수신자 수만큼 예산을 씀. 예산이 바닥나면
+//     (0 이하) 새 fanout을 거절하고, 보낸 뒤에 실제 수신자 수만큼 빼므로 잠깐 음수가 될 수 있음
+// - 거절은 처리 전에 판단하므로 포맷/fanout 비용이 들지 않고, 안내는 연속 거절 중
+//   처음 한 번만 보냄 (안내 메시지가 다시 폭주하지 않도록)
+
+#ifndef RATELIMIT_H
+#define RATELIMIT_H
+
+#include <stdint.h>
+
+// ================= 설정 =================
+
+// 명령어 종류
+#define RATE_NONE           (-1)        // 제한 없음 (/help, /quit 등)
+#define RATE_CHAT           0           // 일반 채팅 (전체 fanout)
+#define RATE_BROADCAST      1           // /all, /page, /name, /list (fanout 또는 전체 순회)
+#define RATE_PRIVATE        2           // /msg, /register
+#define RATE_CLASSES        3
+
+// 기본 제한 (초당 횟수, 0이면 제한 없음) - burst는 초당 횟수의 2배
+#define RATE_DEFAULT_CHAT       10
+#define RATE_DEFAULT_BROADCAST  2
+#define RATE_DEFAULT_PRIVATE    10
+#define RATE_DEFAULT_FANOUT     200000  // 서버 전체 초당 fanout 수신자 수
+
+// ================= 자료 구조 =================
+
+// token bucket - 토큰은 1/1000 단위 정수
+typedef struct {
+    int64_t tokens;
+    uint64_t last_ns;           // 마지막으로 채운 시각 (CLOCK_MONOTONIC)
+    int limited;                // 연속 거절 중 (안내를 이미 보냄)
+} rate_bucket;
+
+// 속도 제한 카운터
+typedef struct {
+    unsigned long allowed[RATE_CLASSES];
+    unsigned long limited[RATE_CLASSES];    // 클라이언트별 제한으로 거절
+    unsigned long fanout_limited;           // 전체 fanout 예산 부족으로 거절
+} rate_stats;
+
+extern unsigned rate_per_sec[RATE_CLASSES];     // 종류별 초당 횟수 (0: 제한 없음)
+extern unsigned rate_fanout_per_sec;            // 초당 fanout 수신자 수 (0: 제한 없음)
+
+// ================= 함수 선언 =================
+
+int  rate_parse(const char *spec);                  // "채팅,전체,귓속말" 초당 횟수 (-1: 형식 오류)
+void rate_init(rate_bucket *b);                     // 클라이언트 접속 시 (bucket을 가득 채움)
+int  rate_admit(rate_bucket *b, int cls, int *notify);  // 1: 처리, 0: 거절 (*notify: 안내할지)
+void rate_charge_fanout(unsigned long recipients);  // fanout 후 실제 수신자 수만큼 예산 사용
+const char *rate_class_name(int cls);
+
+void rate_get_stats(rate_stats *st);
+
+#endif // RATELIMIT_H
@@ -0,0 +1,394 @@
+// registry.c - 클라이언트 세션 테이블
+//
+// 고정 크기 배열 대신 접속자 수에 맞춰 늘어나는 세션 테이블입니다.
+// - 슬롯은 CLIENT_CHUNK_SIZE개 단위 청크로 할당 → 테이블이 늘어나도 기존 슬롯의 주소가
+//   바뀌지 않으므로 다른 쓰레드가 client_at()으로 얻은 포인터를 그대로 쓸 수 있음
+// - 빈 슬롯은 free list로 관리 → 추가/제거 O(1), 가장 최근에 비운 슬롯부터 재사용
+//   (사용한 슬롯 범위가 최대 동시 접속자 수 근처로 유지되어 순회 시 빈 슬롯이 적음)
+// - 슬롯은 해제하지 않고 재사용하므로 재접속이 잦아도 슬롯 할당이 없음. free list는
+//   lock 없는 스택: 반환(퇴장)은 CAS로 바로 넣고, 꺼내기(입장)는 ID 해시 갱신과 함께
+//   clients_mutex 안에서만 하므로 꺼내는 쪽이 하나뿐이라 ABA 문제가 없음
+// - 클라이언트 ID → 슬롯 해시 인덱스 → /msg 대상 찾기 O(1)
+// - ID는 1부터 단조 증가하며 재사용하지 않음 (끊긴 사용자 앞으로 온 귓속말이
+//   같은 슬롯에 새로 접속한 사용자에게 가지 않음). 호출번호 등록(/register)으로
+//   원하는 ID를 쓸 수 있지만 자동 ID 순서는 바꾸지 않고, 소유자가 기록된 호출번호는
+//   자동으로 부여하지 않음 (주인이 오프라인일 때 다른 세션이 그 번호의 페이지를 받지 않도록)
+//
+// 읽기(브로드캐스트, 귓속말 대상 찾기, 목록)는 lock 없이 epoch 기반 읽기 구간에서 수행하고,
+// 드문 쓰기(입장/퇴장/이름 변경)만 clients_mutex로 직렬화합니다.
+// - 입장: 슬롯을 모두 채운 뒤 active를 켜서 공개 (release)
+// - 퇴장: active를 끄고 해시에서 지운 뒤, 그 전에 시작한 읽기 구간이 모두 끝나기를
+//   기다렸다가(registry_synchronize) 소켓/대기열을 정리하고 슬롯을 재사용
+// - 해시 테이블은 open addressing이며, 크기를 바꿀 때는 새 테이블을 만들어 포인터를
+//   바꾸고 읽기 구간이 끝난 뒤 예전 테이블을 해제 (read-copy-update)
+// - 이름은 주인 I/O 루프만 바꾸므로 seqlock으로 다른 쓰레드가 일관된 값을 읽게 함
+
+#include "server.h"
+
+#include <sched.h>
+
+#define REGISTRY_MIN_TABLE      64          // ID 해시 테이블 최소 크기 (2의 거듭제곱)
+#define ID_EMPTY                0           // 해시 칸: 비어 있음 (ID는 1부터 시작)
+#define ID_TOMBSTONE            (-1)        // 해시 칸: 지워진 항목 (탐색은 계속)
+
+client_info **client_chunks;                // 슬롯 청크 디렉터리 (청크는 한 번 할당되면 유지)
+int max_clients = MAX_CLIENTS;
+
+static int nslots;                          // 지금까지 할당한 슬롯 수 (청크 단위로 증가)
+static int used_slots;                      // 한 번이라도 사용한 슬롯 수 (읽기 순회 범위)
+static int live_clients;                    // 접속 중인 클라이언트 수
+static int free_head = -1;                  // 빈 슬롯 스택 (client_info.next_free로 연결, lock 없이 반환)
+static int next_id = 1;                     // 다음에 줄 클라이언트 ID
+
+// ================= ID 해시 테이블 =================
+
+typedef struct {
+    int id;                     // ID_EMPTY / ID_TOMBSTONE / 클라이언트 ID
+    int index;                  // 슬롯 인덱스
+} id_entry;
+
+typedef struct {
+    unsigned mask;              // 칸 수 - 1
+    unsigned used;              // 사용 중 + 지워진 칸 수 (탐색 길이 기준)
+    id_entry e[];
+} id_table;
+
+static id_table *id_tab;                    // 읽기 구간에서 lock 없이 탐색
+
+// ================= 읽기 구간 (epoch) =================
+
+// 쓰레드별 읽기 상태 - 처음 읽기 구간에 들어갈 때 등록, 쓰레드 종료 시 반납 후 재사용
+typedef struct reader_rec {
+    struct reader_rec *next;
+    unsigned long epoch;        // 읽기 구간에 들어갈 때의 epoch (0: 구간 밖)
+    int depth;                  // 중첩 깊이
+    int in_use;                 // 쓰레드가 사용 중
+} reader_rec;
+
+static reader_rec *readers;                 // 등록된 읽기 상태 목록 (추가만 됨)
+static unsigned long global_epoch = 1;
+static __thread reader_rec *my_reader;
+static pthread_key_t reader_key;
+static pthread_once_t reader_once = PTHREAD_ONCE_INIT;
+
+// 쓰레드 종료 시 읽기 상태 반납
+static void reader_release(void *arg) {
+    reader_rec *r = arg;
+    __atomic_store_n(&r->epoch, 0, __ATOMIC_RELEASE);
+    r->depth = 0;
+    __atomic_store_n(&r->in_use, 0, __ATOMIC_RELEASE);
+}
+
+static void reader_key_init(void) {
+    pthread_key_create(&reader_key, reader_release);
+}
+
+// 현재 쓰레드의 읽기 상태 (반납된 것이 있으면 재사용, 없으면 새로 등록)
+static reader_rec *reader_self(void) {
+    if (my_reader) return my_reader;
+    pthread_once(&reader_once, reader_key_init);
+
+    reader_rec *r;
+    for (r = __atomic_load_n(&readers, __ATOMIC_ACQUIRE); r; r = r->next) {
+        int unused = 0;
+        if (__atomic_compare_exchange_n(&r->in_use, &unused, 1, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            break;
+        }
+    }
+    if (!r) {
+        r = calloc(1, sizeof(reader_rec));
+        if (!r) {
+            perror("읽기 상태 할당 실패");
+            exit(1);
+        }
+        r->in_use = 1;
+        r->next = __atomic_load_n(&readers, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&readers, &r->next, r, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+        }
+    }
+    pthread_setspecific(reader_key, r);
+    my_reader = r;
+    return r;
+}
+
+/**
+ * registry_read_lock - 읽기 구간 시작
+ *
+ * 구간 안에서 본 슬롯과 해시 테이블은 구간이 끝날 때까지 정리/재사용되지 않습니다.
+ * lock을 잡지 않으며 중첩할 수 있습니다. 구간 안에서 오래 막히는 일을 하면 안 됩니다.
+ */
+void registry_read_lock(void) {
+    reader_rec *r = reader_self();
+    if (r->depth++ > 0) return;
+    __atomic_store_n(&r->epoch, __atomic_load_n(&global_epoch, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);   // epoch 기록이 이후 읽기보다 먼저 보이도록
+}
+
+void registry_read_unlock(void) {
+    reader_rec *r = my_reader;
+    if (--r->depth > 0) return;
+    __atomic_store_n(&r->epoch, 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * registry_synchronize - 지금 진행 중인 읽기 구간이 모두 끝날 때까지 대기
+ *
+ * 이 함수가 반환된 뒤에는 앞서 공개를 취소한 슬롯이나 교체한 해시 테이블을
+ * 보고 있는 읽기 구간이 없습니다. 읽기 구간 안에서 호출하면 안 됩니다.
+ */
+void registry_synchronize(void) {
+    unsigned long target = __atomic_add_fetch(&global_epoch, 1, __ATOMIC_SEQ_CST);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    for (reader_rec *r = __atomic_load_n(&readers, __ATOMIC_ACQUIRE); r; r = r->next) {
+        while (1) {
+            unsigned long e = __atomic_load_n(&r->epoch, __ATOMIC_ACQUIRE);
+            if (e == 0 || e >= target) break;   // 구간 밖이거나 변경 이후에 시작한 구간
+            sched_yield();
+        }
+    }
+}
+
+// ================= 해시 테이블 조작 (clients_mutex 필요) =================
+
+static id_table *table_new(unsigned size) {
+    id_table *t = calloc(1, sizeof(id_table) + size * sizeof(id_entry));
+    if (!t) return NULL;
+    t->mask = size - 1;
+    return t;
+}
+
+// 새 항목을 빈 칸(또는 지워진 칸)에 기록 - index를 먼저 쓰고 id를 release로 공개
+static void table_put(id_table *t, int id, int index) {
+    unsigned i = (unsigned)id & t->mask;
+    while (t->e[i].id != ID_EMPTY && t->e[i].id != ID_TOMBSTONE) {
+        i = (i + 1) & t->mask;
+    }
+    if (t->e[i].id == ID_EMPTY) t->used++;
+    t->e[i].index = index;
+    __atomic_store_n(&t->e[i].id, id, __ATOMIC_RELEASE);
+}
+
+// 항목을 지워진 칸으로 표시 (탐색 중인 읽기 쪽은 다음 칸으로 계속 진행)
+static void table_del(id_table *t, int id) {
+    for (unsigned i = (unsigned)id & t->mask; t->e[i].id != ID_EMPTY; i = (i + 1) & t->mask) {
+        if (t->e[i].id == id) {
+            __atomic_store_n(&t->e[i].id, ID_TOMBSTONE, __ATOMIC_RELEASE);
+            return;
+        }
+    }
+}
+
+// 지워진 칸을 없앤 새 테이블로 교체 (크기는 접속자 수의 2배 이상)
+static int table_rebuild(void) {
+    unsigned size = REGISTRY_MIN_TABLE;
+    while (size < (unsigned)(live_clients + 1) * 2) size *= 2;
+
+    id_table *t = table_new(size);
+    if (!t) return -1;
+    id_table *old = id_tab;
+    for (unsigned i = 0; i <= old->mask; i++) {
+        if (old->e[i].id > 0) table_put(t, old->e[i].id, old->e[i].index);
+    }
+
+    __atomic_store_n(&id_tab, t, __ATOMIC_RELEASE);
+    registry_synchronize();                 // 예전 테이블을 탐색 중인 읽기 구간이 끝난 뒤 해제
+    free(old);
+    return 0;
+}
+
+// ================= 슬롯 관리 (clients_mutex 필요) =================
+
+// 슬롯 청크 하나를 새로 할당 (최대 수에 도달했으면 -1)
+static int grow_slots(void) {
+    if (nslots >= max_clients) return -1;
+
+    // 슬롯을 캐시 라인에 맞춰 할당 (client_info 크기는 64의 배수)
+    client_info *chunk = aligned_alloc(64, CLIENT_CHUNK_SIZE * sizeof(client_info));
+    if (!chunk) return -1;
+    memset(chunk, 0, CLIENT_CHUNK_SIZE * sizeof(client_info));
+    for (int i = 0; i < CLIENT_CHUNK_SIZE; i++) chunk[i].wake_fd = -1;
+    stats_count(STAT_SESSION_ALLOCS, 1);
+    __atomic_store_n(&client_chunks[nslots >> CLIENT_CHUNK_SHIFT], chunk, __ATOMIC_RELEASE);
+    nslots += CLIENT_CHUNK_SIZE;
+    return 0;
+}
+
+/**
+ * registry_init - 세션 테이블 준비
+ * @capacity: 최대 동시 접속자 수
+ * @return: 0 성공, -1 메모리 부족
+ *
+ * 청크 디렉터리와 해시 테이블만 만들고, 슬롯은 접속자가 늘어날 때 할당합니다.
+ */
+int registry_init(int capacity) {
+    max_clients = capacity;
+    int nchunks = (capacity + CLIENT_CHUNK_SIZE - 1) / CLIENT_CHUNK_SIZE;
+    client_chunks = calloc(nchunks, sizeof(client_info *));
+    id_tab = table_new(REGISTRY_MIN_TABLE);
+    if (!client_chunks || !id_tab) return -1;
+    return 0;
+}
+
+// 다음 자동 ID - 접속 중인 ID와 소유자가 있는 호출번호는 건너뜀
+// CLIENT_ID_MAX를 넘으면 1부터 다시 돎 (등록 번호 수와 접속자 수가 범위보다 훨씬 적으므로 빈 ID가 있음)
+static int take_id(void) {
+    while (1) {
+        if (next_id > CLIENT_ID_MAX) next_id = 1;
+        int id = next_id++;
+        if (registry_find(id) < 0 && !pagelog_owned(id)) return id;
+    }
+}
+
+/**
+ * registry_insert - 빈 슬롯을 잡고 새 클라이언트 ID 부여
+ * @return: 슬롯 인덱스 (id만 채워짐), 가득 찼거나 메모리 부족이면 -1
+ *
+ * 슬롯은 아직 읽기 쪽에 보이지 않습니다. 호출한 쪽이 나머지를 채운 뒤
+ * registry_publish로 공개합니다.
+ */
+int registry_insert(void) {
+    if (live_clients >= max_clients) return -1;
+    // 사용 중 + 지워진 칸이 3/4을 넘으면 탐색이 길어지므로 새 테이블로 교체
+    if ((id_tab->used + 1) * 4 > (id_tab->mask + 1) * 3 && table_rebuild() < 0) return -1;
+
+    int index = __atomic_load_n(&free_head, __ATOMIC_ACQUIRE);
+    while (index >= 0 &&
+           !__atomic_compare_exchange_n(&free_head, &index, client_at(index)->next_free, 1,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+    }
+    if (index < 0) {
+        if (used_slots == nslots && grow_slots() < 0) return -1;
+        index = used_slots;
+        __atomic_store_n(&used_slots, used_slots + 1, __ATOMIC_RELEASE);
+    }
+
+    client_at(index)->id = take_id();
+    live_clients++;
+    return index;
+}
+
+// 채워진 슬롯을 읽기 쪽에 공개 (해시 등록 후 active를 release로 켬)
+void registry_publish(int index) {
+    client_info *c = client_at(index);
+    table_put(id_tab, c->id, index);
+    __atomic_store_n(&c->active, 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * registry_remove - 슬롯을 읽기 쪽에서 숨김
+ * @index: 제거할 슬롯 인덱스
+ *
+ * 이미 읽기 구간 안에서 이 슬롯을 본 쓰레드가 있을 수 있으므로, 슬롯의 자원은
+ * registry_synchronize 후에 정리하고 registry_free로 반환해야 합니다.
+ */
+void registry_remove(int index) {
+    client_info *c = client_at(index);
+    __atomic_store_n(&c->active, 0, __ATOMIC_RELEASE);
+    table_del(id_tab, c->id);
+    live_clients--;
+}
+
+/**
+ * registry_prepare_id - ID를 바꿀 수 있는지 확인하고 해시 테이블 자리를 미리 확보
+ * @index: 슬롯 인덱스
+ * @id: 새 ID
+ * @return: 0 바꿀 수 있음, -1 다른 클라이언트가 사용 중이거나 메모리 부족
+ *
+ * 0을 돌려준 뒤 clients_mutex를 놓지 않고 부르는 registry_set_id는 실패하지 않습니다.
+ * 호출번호 소유를 기록하기 전에 등록이 성공할지 먼저 정할 때 씁니다.
+ */
+int registry_prepare_id(int index, int id) {
+    if (client_at(index)->id == id) return 0;
+    if (registry_find(id) >= 0) return -1;
+    // 지우기 전에 자리를 확보 - 새 테이블을 못 만들면 아무것도 바꾸지 않고 실패
+    // (먼저 지우면 실패했을 때 접속 중인 세션이 해시에서 빠져 /msg가 닿지 않음)
+    if ((id_tab->used + 1) * 4 > (id_tab->mask + 1) * 3 && table_rebuild() < 0) return -1;
+    return 0;
+}
+
+/**
+ * registry_set_id - 접속 중인 클라이언트의 ID 변경 (호출번호 등록)
+ * @index: 슬롯 인덱스
+ * @id: 새 ID
+ * @return: 0 성공, -1 다른 클라이언트가 사용 중
+ *
+ * 자동 ID 순서(next_id)는 건드리지 않습니다. 클라이언트가 고른 번호로 순서를 옮기면
+ * 범위 끝으로 보내 1부터 다시 돌게 만들 수 있기 때문입니다.
+ */
+int registry_set_id(int index, int id) {
+    client_info *c = client_at(index);
+    if (c->id == id) return 0;
+    if (registry_prepare_id(index, id) < 0) return -1;
+
+    table_del(id_tab, c->id);
+    __atomic_store_n(&c->id, id, __ATOMIC_RELEASE);
+    table_put(id_tab, id, index);
+    return 0;
+}
+
+// 정리가 끝난 슬롯을 free list에 반환 (lock 필요 없음)
+void registry_free(int index) {
+    client_info *c = client_at(index);
+    int head = __atomic_load_n(&free_head, __ATOMIC_RELAXED);
+    do {
+        c->next_free = head;
+    } while (!__atomic_compare_exchange_n(&free_head, &head, index, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+// ================= 읽기 (읽기 구간 안에서 호출) =================
+
+/**
+ * registry_find - 클라이언트 ID로 슬롯 찾기
+ * @id: 클라이언트 ID
+ * @return: 슬롯 인덱스, 없으면 -1
+ */
+int registry_find(int id) {
+    if (id <= 0) return -1;
+    id_table *t = __atomic_load_n(&id_tab, __ATOMIC_ACQUIRE);
+    for (unsigned i = (unsigned)id & t->mask; ; i = (i + 1) & t->mask) {
+        int cur = __atomic_load_n(&t->e[i].id, __ATOMIC_ACQUIRE);
+        if (cur == ID_EMPTY) return -1;
+        if (cur == id) {
+            int index = t->e[i].index;
+            return __atomic_load_n(&client_at(index)->active, __ATOMIC_ACQUIRE) ? index : -1;
+        }
+    }
+}
+
+// 순회 범위: 0 ~ registry_slots()-1 중 registry_active()인 슬롯이 접속 중
+int registry_slots(void) {
+    return __atomic_load_n(&used_slots, __ATOMIC_ACQUIRE);
+}
+
+int registry_active(int index) {
+    return __atomic_load_n(&client_at(index)->active, __ATOMIC_ACQUIRE);
+}
+
+int registry_count(void) {
+    return __atomic_load_n(&live_clients, __ATOMIC_RELAXED);
+}
+
+// ================= 이름 (seqlock) =================
+
+// 이름 변경 - 이 연결의 메시지를 처리 중인 쓰레드(I/O 루프 또는 작업 풀)에서만 호출
+void registry_set_name(int index, const char *name) {
+    client_info *c = client_at(index);
+    __atomic_fetch_add(&c->name_seq, 1, __ATOMIC_RELAXED);     // 홀수: 변경 중
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    strncpy(c->name, name, NAME_SIZE - 1);
+    c->name[NAME_SIZE - 1] = '\0';
+    __atomic_fetch_add(&c->name_seq, 1, __ATOMIC_RELEASE);     // 짝수: 완료
+}
+
+// 다른 쓰레드에서 이름 읽기 - 변경 중이었으면 다시 읽음
+void registry_get_name(int index, char *out) {
+    client_info *c = client_at(index);
+    unsigned seq;
+    do {
+        seq = __atomic_load_n(&c->name_seq, __ATOMIC_ACQUIRE);
+        memcpy(out, c->name, NAME_SIZE);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while ((seq & 1) || seq != __atomic_load_n(&c->name_seq, __ATOMIC_RELAXED));
+    out[NAME_SIZE - 1] = '\0';
+}
@@ -0,0 +1,302 @@
+// roster.c - 접속자 목록 (입장/퇴장 때 고쳐 두는 목록 + 버전별 스냅샷)
+//
+// 변경은 roster_lock 아래에서 항목 하나만 고칩니다 (O(1)). 스냅샷은 snap_lock으로
+// 보호하는 참조 카운트 객체로, 다 만든 뒤에는 바꾸지 않고 쪽 메시지 칸만 처음 요청될 때 채웁니다.
+// 두 lock을 함께 잡는 곳은 없습니다.
+
+#include "server.h"
+#include "roster.h"
+
+// 목록 항목 하나 (줄은 미리 만들어 둠)
+typedef struct {
+    int id;
+    int index;                  // 세션 슬롯 인덱스
+    char name[NAME_SIZE];
+    unsigned short len;         // 목록 줄 길이
+    char line[ROSTER_LINE_MAX];
+} roster_entry;
+
+// 스냅샷 - 어느 버전의 목록을 ID 순으로 정렬한 복사본
+typedef struct {
+    int refs;                   // snap_lock 아래에서만 변경
+    unsigned long version;
+    int count;
+    int npages;
+    msgbuf **pages;             // 쪽별 메시지 (처음 요청될 때 만들어 CAS로 채움)
+    roster_entry entries[];
+} roster_snap;
+
+static pthread_mutex_t roster_lock = PTHREAD_MUTEX_INITIALIZER;
+static roster_entry *entries;   // 빈칸 없는 배열
+static int nentries, entries_cap;
+static unsigned long version;
+
+static pthread_mutex_t snap_lock = PTHREAD_MUTEX_INITIALIZER;
+static roster_snap *current;    // 가장 최근 스냅샷 (참조 하나 보유)
+static int building;            // 새 스냅샷을 만드는 쓰레드가 있음
+static unsigned long rebuilds;
+
+// ================= 목록 변경 =================
+
+// 슬롯의 ID/이름/주소로 항목 채우기 (그 연결을 처리하는 쓰레드라서 이름을 바로 읽음)
+static void entry_fill(roster_entry *e, int index) {
+    client_info *c = client_at(index);
+    char ip[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &c->address.sin_addr, ip, sizeof(ip));
+    e->id = c->id;
+    e->index = index;
+    memcpy(e->name, c->name, NAME_SIZE);
+    int len = snprintf(e->line, ROSTER_LINE_MAX, "ID: %d, 이름: %s, IP: %s\n", c->id, c->name, ip);
+    e->len = (unsigned short)(len < ROSTER_LINE_MAX ? len : ROSTER_LINE_MAX - 1);
+}
+
+void roster_add(int index) {
+    roster_entry e;
+    entry_fill(&e, index);
+
+    pthread_mutex_lock(&roster_lock);
+    if (nentries == entries_cap) {
+        int cap = entries_cap ? entries_cap * 2 : CLIENT_CHUNK_SIZE;
+        roster_entry *bigger = realloc(entries, cap * sizeof(roster_entry));
+        if (!bigger) {
+            client_at(index)->roster_slot = -1;     // 목록에는 빠지지만 접속은 유지
+            pthread_mutex_unlock(&roster_lock);
+            return;
+        }
+        entries = bigger;
+        entries_cap = cap;
+    }
+    client_at(index)->roster_slot = nentries;
+    entries[nentries++] = e;
+    __atomic_add_fetch(&version, 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&roster_lock);
+}
+
+void roster_update(int index) {
+    roster_entry e;
+    entry_fill(&e, index);
+
+    pthread_mutex_lock(&roster_lock);
+    int slot = client_at(index)->roster_slot;
+    if (slot >= 0) {
+        entries[slot] = e;
+        __atomic_add_fetch(&version, 1, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&roster_lock);
+}
+
+// 마지막 항목을 빈 자리로 옮겨 O(1) 제거
+void roster_remove(int index) {
+    pthread_mutex_lock(&roster_lock);
+    int slot = client_at(index)->roster_slot;
+    if (slot >= 0) {
+        roster_entry *last = &entries[--nentries];
+        if (slot != nentries) {
+            entries[slot] = *last;
+            client_at(last->index)->roster_slot = slot;
+        }
+        client_at(index)->roster_slot = -1;
+        __atomic_add_fetch(&version, 1, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&roster_lock);
+}
+
+unsigned long roster_version(void) {
+    return __atomic_load_n(&version, __ATOMIC_RELAXED);
+}
+
+unsigned long roster_rebuilds(void) {
+    return __atomic_load_n(&rebuilds, __ATOMIC_RELAXED);
+}
+
+// ================= 스냅샷 =================
+
+static int entry_cmp(const void *a, const void *b) {
+    int x = ((const roster_entry *)a)->id, y = ((const roster_entry *)b)->id;
+    return (x > y) - (x < y);
+}
+
+// 현재 목록 복사 (lock은 복사하는 동안만) → 정렬
+static roster_snap *snap_build(void) {
+    pthread_mutex_lock(&roster_lock);
+    int n = nentries;
+    roster_snap *s = malloc(sizeof(roster_snap) + (size_t)n * sizeof(roster_entry));
+    if (!s) {
+        pthread_mutex_unlock(&roster_lock);
+        return NULL;
+    }
+    memcpy(s->entries, entries, (size_t)n * sizeof(roster_entry));
+    s->version = version;
+    pthread_mutex_unlock(&roster_lock);
+
+    qsort(s->entries, (size_t)n, sizeof(roster_entry), entry_cmp);
+    s->refs = 1;
+    s->count = n;
+    s->npages = n ? (n + ROSTER_PAGE_SIZE - 1) / ROSTER_PAGE_SIZE : 1;
+    s->pages = calloc((size_t)s->npages, sizeof(msgbuf *));
+    if (!s->pages) {
+        free(s);
+        return NULL;
+    }
+    __atomic_add_fetch(&rebuilds, 1, __ATOMIC_RELAXED);
+    return s;
+}
+
+static void snap_put(roster_snap *s) {
+    pthread_mutex_lock(&snap_lock);
+    int last = --s->refs == 0;
+    pthread_mutex_unlock(&snap_lock);
+    if (!last) return;
+    for (int i = 0; i < s->npages; i++) {
+        if (s->pages[i]) msgbuf_put(s->pages[i]);
+    }
+    free(s->pages);
+    free(s);
+}
+
+/**
+ * snap_get - 최신 스냅샷 얻기 (참조 하나 추가)
+ * @return: 스냅샷, 메모리 부족이면 NULL
+ *
+ * 목록이 바뀌었으면 새로 만들되, 다른 쓰레드가 이미 만들고 있으면 기다리지 않고
+ * 직전 스냅샷을 씁니다 (그 사이의 입장/퇴장 몇 건이 빠질 수 있음).
+ */
+static roster_snap *snap_get(void) {
+    pthread_mutex_lock(&snap_lock);
+    roster_snap *s = current;
+    if (s && (s->version == roster_version() || building)) {
+        s->refs++;
+        pthread_mutex_unlock(&snap_lock);
+        return s;
+    }
+    building = 1;
+    pthread_mutex_unlock(&snap_lock);
+
+    roster_snap *fresh = snap_build();
+
+    pthread_mutex_lock(&snap_lock);
+    building = 0;
+    roster_snap *old = NULL;
+    if (fresh) {
+        old = current;
+        current = fresh;
+    }
+    s = current;
+    if (s) s->refs++;
+    pthread_mutex_unlock(&snap_lock);
+    if (old) snap_put(old);
+    return s;
+}
+
+// ================= 쪽 메시지 =================
+
+// snprintf 결과를 len에 더함 - 잘렸으면 버퍼 끝(마지막 칸은 줄바꿈용으로 남김)에서 멈춤
+static size_t clamp_len(size_t len, int n, size_t cap) {
+    if (n < 0) return len;
+    len += (size_t)n;
+    return len < cap - 1 ? len : cap - 1;
+}
+
+// 쪽 메시지 만들기 (list: 이 쪽의 항목 n개, matched: 거른 결과 수, connected: 전체 접속자 수)
+static msgbuf *render(roster_entry **list, int n, int page, int npages,
+                      int matched, int connected, const char *prefix) {
+    size_t plen = prefix ? strlen(prefix) : 0;
+    size_t cap = 256 + 2 * plen + (size_t)n * ROSTER_LINE_MAX;    // 앞부분은 두 번 들어감
+    char *text = malloc(cap);
+    if (!text) return NULL;
+
+    size_t len = clamp_len(0, snprintf(text, cap, "\n=== 연결된 클라이언트 목록 (%d/%d쪽) ===\n",
+                                       page, npages), cap);
+    for (int i = 0; i < n; i++) {
+        memcpy(text + len, list[i]->line, list[i]->len);
+        len += list[i]->len;
+    }
+    if (prefix) {
+        len = clamp_len(len, snprintf(text + len, cap - len, "'%s'(으)로 시작하는 이름 %d명 / ",
+                                      prefix, matched), cap);
+    }
+    len = clamp_len(len, snprintf(text + len, cap - len, "총 %d명 접속 중", connected), cap);
+    if (page < npages) {
+        len = clamp_len(len, snprintf(text + len, cap - len, " (다음 쪽: /list %s%s%d)",
+                                      prefix ? prefix : "", prefix ? " " : "", page + 1), cap);
+    }
+    text[len++] = '\n';
+
+    msgbuf *m = msgbuf_new(text, len);
+    free(text);
+    return m;
+}
+
+/**
+ * roster_page - 접속자 목록 한 쪽
+ * @page: 쪽 번호 (1부터)
+ * @prefix: 이름 앞부분 (NULL이나 ""면 거르지 않음, NAME_SIZE - 1바이트 넘는 부분은 무시)
+ * @return: 쪽 메시지 (참조 1), 메모리 부족이면 NULL
+ *
+ * 거르지 않은 쪽은 스냅샷에 보관해 같은 버전 동안 다시 만들지 않습니다.
+ */
+msgbuf *roster_page(int page, const char *prefix) {
+    roster_snap *s = snap_get();
+    if (!s) return NULL;
+    if (prefix && !*prefix) prefix = NULL;
+
+    // 이름은 NAME_SIZE - 1바이트를 넘지 않으므로 그보다 긴 앞부분은 그 길이로 잘라서 씀
+    char cut[NAME_SIZE];
+    if (prefix && strlen(prefix) >= NAME_SIZE) {
+        memcpy(cut, prefix, NAME_SIZE - 1);
+        cut[NAME_SIZE - 1] = '\0';
+        prefix = cut;
+    }
+
+    roster_entry *list[ROSTER_PAGE_SIZE];
+    msgbuf *m = NULL;
+
+    if (!prefix) {
+        if (page < 1 || page > s->npages) {
+            m = msgbuf_printf("[시스템] %d쪽이 없습니다 (전체 %d쪽)\n", page, s->npages);
+            snap_put(s);
+            return m;
+        }
+        m = __atomic_load_n(&s->pages[page - 1], __ATOMIC_ACQUIRE);
+        if (!m) {
+            int first = (page - 1) * ROSTER_PAGE_SIZE;
+            int n = 0;
+            for (int i = first; i < s->count && n < ROSTER_PAGE_SIZE; i++) list[n++] = &s->entries[i];
+            msgbuf *fresh = render(list, n, page, s->npages, s->count, s->count, NULL);
+            if (!fresh) {
+                snap_put(s);
+                return NULL;
+            }
+            // 다른 쓰레드가 먼저 채웠으면 그것을 씀
+            msgbuf *expected = NULL;
+            if (__atomic_compare_exchange_n(&s->pages[page - 1], &expected, fresh, 0,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                m = fresh;
+            } else {
+                msgbuf_put(fresh);
+                m = expected;
+            }
+        }
+        msgbuf_get(m);
+        snap_put(s);
+        return m;
+    }
+
+    // 이름 앞부분으로 거름 - 맞는 항목을 세면서 요청한 쪽의 항목만 모음
+    size_t plen = strlen(prefix);
+    int matched = 0, n = 0;
+    int first = (page - 1) * ROSTER_PAGE_SIZE;
+    for (int i = 0; i < s->count; i++) {
+        if (strncmp(s->entries[i].name, prefix, plen) != 0) continue;
+        if (matched >= first && n < ROSTER_PAGE_SIZE) list[n++] = &s->entries[i];
+        matched++;
+    }
+    int npages = matched ? (matched + ROSTER_PAGE_SIZE - 1) / ROSTER_PAGE_SIZE : 1;
+    if (page < 1 || page > npages) {
+        m = msgbuf_printf("[시스템] %d쪽이 없습니다 (전체 %d쪽)\n", page, npages);
+    } else {
+        m = render(list, n, page, npages, matched, s->count, prefix);
+    }
+    snap_put(s);
+    return m;
+}
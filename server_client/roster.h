@@ -0,0 +1,37 @@
+// roster.h - 접속자 목록(/list) 헤더 파일
+//
+// /list 때마다 세션 테이블 전체를 훑어 목록을 만드는 대신, 입장/퇴장/이름 변경 때
+// 그 사람의 목록 줄만 고쳐 둡니다.
+// - 목록 줄("ID: .., 이름: .., IP: ..")은 입장/이름 변경 때 한 번만 만들어 둠
+// - 목록은 빈칸 없는 배열 (퇴장하면 마지막 항목을 빈 자리로 옮김, 위치는 client_info.roster_slot)
+// - /list는 버전이 붙은 스냅샷(ID 순으로 정렬한 복사본)을 읽음. 목록이 바뀌어 버전이 올라간 뒤
+//   처음 /list가 올 때 한 번만 새로 만들고, 쪽별 메시지도 처음 요청될 때 만들어 스냅샷에 보관
+// - 스냅샷을 만드는 동안 roster_lock은 배열 복사에만 잡으므로 입장/퇴장은 거의 기다리지 않고,
+//   다른 /list는 새 스냅샷을 기다리지 않고 직전 스냅샷을 씀
+// - 쪽 나누기(/list <쪽>)와 이름 앞부분으로 거르기(/list <이름>)
+
+#ifndef ROSTER_H
+#define ROSTER_H
+
+#include "msgbuf.h"         // 공유 메시지 버퍼
+
+// ================= 설정 =================
+
+#define ROSTER_PAGE_SIZE    20          // 한 쪽의 접속자 수
+#define ROSTER_LINE_MAX     112         // 목록 줄 하나의 최대 길이 (ID, 이름, IP)
+
+// ================= 함수 선언 =================
+
+// 목록 변경 (해당 연결의 메시지를 처리하는 쓰레드만 호출)
+void roster_add(int index);             // 입장 (ID, 이름, 주소가 채워진 뒤)
+void roster_update(int index);          // 이름/ID 변경
+void roster_remove(int index);          // 퇴장 (슬롯 반환 전)
+
+// 쪽 메시지 (page: 1부터, prefix: 이름 앞부분, NULL이나 ""면 모두)
+// 없는 쪽이면 안내 메시지, 메모리 부족이면 NULL
+msgbuf *roster_page(int page, const char *prefix);
+
+unsigned long roster_version(void);     // 목록이 바뀔 때마다 증가
+unsigned long roster_rebuilds(void);    // 스냅샷을 새로 만든 횟수 (지표용)
+
+#endif // ROSTER_H
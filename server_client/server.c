@@ -1,337 +1,734 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <unistd.h>
-#include <pthread.h>
-#include <sys/socket.h>
-#include <netinet/in.h>
-#include <arpa/inet.h>
-#include <signal.h>
-
-#define PORT 8080
-#define MAX_CLIENTS 100 // 수정 가능
-#define BUFFER_SIZE 1024
-#define NAME_SIZE 32
-
-// 클라이언트 정보 구조체
-typedef struct {
-    int socket;
-    int id;
-    char name[NAME_SIZE];
-    struct sockaddr_in address;
-    int active;
-} client_info;
+#include "server.h"
 
 // 전역 변수
 int server_socket = -1;
-client_info clients[MAX_CLIENTS];
 pthread_mutex_t clients_mutex = PTHREAD_MUTEX_INITIALIZER;
+int io_mode = DEFAULT_IO_MODE;
 
 // 시그널 핸들러 - 서버 종료시 소켓 정리
 void handle_shutdown(int sig) {
-    printf("\n서버를 종료합니다...\n");
+    log_printf(LOG_INFO, "서버를 종료합니다...");
     if (server_socket != -1) {
         close(server_socket);
     }
     exit(0);
 }
 
-// 모든 활성 클라이언트에게 메시지 브로드캐스트
-void broadcast_message(char *message, int sender_id) {
-    pthread_mutex_lock(&clients_mutex);
-    for (int i = 0; i < MAX_CLIENTS; i++) {
-        if (clients[i].active && clients[i].id != sender_id) {
-            if (send(clients[i].socket, message, strlen(message), 0) < 0) {
-                perror("브로드캐스트 전송 실패");
-            }
-        }
+// 클라이언트에게 공유 버퍼 전송
+// 모든 I/O 모델이 클라이언트별 송신 대기열을 거침: io_uring 모델은 링에 전송 요청을
+// 쌓고, epoll 모델은 담당 샤드를 거치며, thread 모델은 대기열에 넣고 담당 쓰레드를 깨움
+// 대기열에는 버퍼 참조만 들어가므로 수신자가 여럿이어도 메시지는 복사되지 않음
+// 반환값: 대기열에 넣었거나 정책에 따라 버린 경우 0, 실패 시 -1
+int client_send_buf(int index, msgbuf *buf) {
+    if (!buf) return -1;
+    if (io_mode == IO_MODE_URING) {
+        return uring_send(index, buf);
     }
-    pthread_mutex_unlock(&clients_mutex);
+    if (io_mode == IO_MODE_EPOLL) {
+        return epoll_send(index, buf);
+    }
+    
+    // 소켓 버퍼에 여유가 있으면 호출한 쓰레드가 바로 전송하고(대기열 lock으로 순서 보장),
+    // 남은 것이 생겼을 때만 담당 쓰레드를 깨워 쓰기 가능 이벤트를 기다리게 함
+    // 묶음 창을 쓰면 전송은 담당 쓰레드가 창이 끝날 때 한 번에 함
+    client_info *c = client_at(index);
+    int was_empty;
+    int ret = outq_push(&c->out, buf, &was_empty);
+    if (ret == OUTQ_OVERFLOW ||
+        (was_empty && (outq_batch_usec || outq_flush(&c->out, c->socket) != 0))) {
+        uint64_t one = 1;
+        if (write(c->wake_fd, &one, sizeof(one)) < 0) return -1;
+    }
+    return 0;
 }
 
-// 특정 클라이언트에게 메시지 전송
-void send_to_client(char *message, int target_id, int sender_id) {
-    pthread_mutex_lock(&clients_mutex);
-    int found = 0;
-    for (int i = 0; i < MAX_CLIENTS; i++) {
-        if (clients[i].active && clients[i].id == target_id) {
-            if (send(clients[i].socket, message, strlen(message), 0) < 0) {
-                perror("개인 메시지 전송 실패");
-            }
-            found = 1;
-            break;
-        }
+// 클라이언트에게 데이터 전송 (한 명에게만 보내는 응답용)
+int client_send(int index, const char *msg, size_t len) {
+    msgbuf *buf = msgbuf_new(msg, len);
+    int ret = client_send_buf(index, buf);
+    if (buf) msgbuf_put(buf);
+    return ret;
+}
+
+// 송신 대기열에 정책대로 버리지 않고 더 넣을 수 있는 메시지 수
+int client_send_room(int index) {
+    if (io_mode == IO_MODE_URING) return uring_send_room(index);
+    return (int)outq_room(&client_at(index)->out);
+}
+
+// 모든 활성 클라이언트에게 메시지 브로드캐스트 (같은 버퍼를 공유)
+void broadcast_message(msgbuf *message, int sender_id) {
+    if (!message) return;
+    
+    uint64_t start = stats_now();
+    
+    // epoll 모델: 샤드별로 한 번씩만 전달하고 각 샤드가 자기 클라이언트에게 fanout
+    if (io_mode == IO_MODE_EPOLL) {
+        epoll_broadcast(message, sender_id);
+        stats_record(STAT_FANOUT, stats_now() - start);
+        return;
     }
     
-    // 발신자에게 전송 결과 알림
-    if (!found && sender_id > 0) {
-        for (int i = 0; i < MAX_CLIENTS; i++) {
-            if (clients[i].active && clients[i].id == sender_id) {
-                char error_msg[100];
-                sprintf(error_msg, "[시스템] 클라이언트 %d를 찾을 수 없습니다.\n", target_id);
-                send(clients[i].socket, error_msg, strlen(error_msg), 0);
-                break;
+    // io_uring 모델: 작업 풀에서 보낸 브로드캐스트는 링 쓰레드가 fanout
+    if (io_mode == IO_MODE_URING && uring_broadcast(message, sender_id) == 0) {
+        return;
+    }
+    
+    // lock 없이 순회 - 입장/퇴장과 동시에 진행되어도 읽기 구간 동안 슬롯은 정리되지 않음
+    registry_read_lock();
+    int nslots = registry_slots();
+    for (int i = 0; i < nslots; i++) {
+        if (registry_active(i) && client_at(i)->id != sender_id) {
+            if (client_send_buf(i, message) < 0) {
+                log_printf(LOG_WARN, "브로드캐스트 전송 실패: %m");
             }
         }
     }
-    pthread_mutex_unlock(&clients_mutex);
+    registry_read_unlock();
+    stats_record(STAT_FANOUT, stats_now() - start);
 }
 
-// 활성 클라이언트 목록 생성
-void get_client_list(char *buffer) {
-    pthread_mutex_lock(&clients_mutex);
-    sprintf(buffer, "\n=== 연결된 클라이언트 목록 ===\n");
-    int count = 0;
-    for (int i = 0; i < MAX_CLIENTS; i++) {
-        if (clients[i].active) {
-            char temp[100];
-            sprintf(temp, "ID: %d, 이름: %s, IP: %s\n", 
-                    clients[i].id, 
-                    clients[i].name,
-                    inet_ntoa(clients[i].address.sin_addr));
-            strcat(buffer, temp);
-            count++;
+// 특정 클라이언트에게 메시지 전송
+void send_to_client(msgbuf *message, int target_id, int sender_id) {
+    if (!message) return;
+    
+    registry_read_lock();
+    int target = registry_find(target_id);
+    if (target >= 0) {
+        if (client_send_buf(target, message) < 0) {
+            log_printf(LOG_WARN, "개인 메시지 전송 실패: %m");
         }
     }
-    char summary[50];
-    sprintf(summary, "총 %d명 접속 중\n", count);
-    strcat(buffer, summary);
-    pthread_mutex_unlock(&clients_mutex);
+    registry_read_unlock();
+    if (target >= 0) return;
+    
+    // 접속해 있지 않으면 보관했다가 그 번호로 등록할 때 전달
+    // pagelog_store는 log_lock(압축 중 msync, 파일 확장)을 기다릴 수 있으므로 읽기 구간 밖에서 호출
+    // (읽기 구간이 길어지면 세션 슬롯 회수가 그만큼 밀림)
+    int stored = target_id > 0 && pagelog_store(target_id, message->data, message->len) == 0;
+    
+    // 발신자에게 전송 결과 알림
+    char error_msg[128];
+    if (stored) {
+        sprintf(error_msg, "[시스템] 클라이언트 %d는 접속해 있지 않아 보관했습니다. 등록하면 전달됩니다.\n", target_id);
+    } else {
+        sprintf(error_msg, "[시스템] 클라이언트 %d를 찾을 수 없습니다.\n", target_id);
+    }
+    registry_read_lock();
+    int sender = registry_find(sender_id);
+    if (sender >= 0) client_send(sender, error_msg, strlen(error_msg));
+    registry_read_unlock();
 }
 
-// 클라이언트 추가
-int add_client(int socket, struct sockaddr_in address) {
+// 클라이언트 추가 - 세션 테이블에서 빈 슬롯과 새 ID를 받고 모두 채운 뒤 공개
+// shard: 담당 epoll 샤드 (다른 모델은 0) - 공개 전에 채워야 다른 샤드의 epoll_send가 옛 값을 보지 않음
+int add_client(int socket, struct sockaddr_in address, int shard) {
     pthread_mutex_lock(&clients_mutex);
-    for (int i = 0; i < MAX_CLIENTS; i++) {
-        if (!clients[i].active) {
-            clients[i].socket = socket;
-            clients[i].address = address;
-            clients[i].active = 1;
-            clients[i].id = i + 1;
-            sprintf(clients[i].name, "User%d", clients[i].id);
-            pthread_mutex_unlock(&clients_mutex);
-            return i;
-        }
+    int index = registry_insert();
+    if (index < 0) {
+        pthread_mutex_unlock(&clients_mutex);
+        return -1;
+    }
+    client_info *c = client_at(index);
+    c->socket = socket;
+    c->address = address;
+    c->shard = shard;
+    c->closing = 0;
+    c->io_conn = NULL;
+    c->groups = 0;
+    c->last_rx = heartbeat_clock();
+    rate_init(c->rate);
+    strand_init(&c->strand);
+    sprintf(c->name, "User%d", c->id);
+    // 수신 버퍼와 eventfd는 슬롯에 남아 있으면 그대로 씀 (처음 쓰는 슬롯만 새로 만듦)
+    if (!c->rx.buf) stats_count(STAT_SESSION_ALLOCS, 1);
+    if (frame_rx_init(&c->rx) < 0) {
+        registry_remove(index);
+        registry_free(index);
+        pthread_mutex_unlock(&clients_mutex);
+        return -1;
+    }
+    outq_init(&c->out);
+    // thread 모델: 다른 쓰레드가 송신 대기열에 넣었을 때 담당 쓰레드를 깨우는 eventfd
+    if (io_mode == IO_MODE_THREAD && c->wake_fd < 0) {
+        c->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
     }
+    registry_publish(index);
     pthread_mutex_unlock(&clients_mutex);
-    return -1;
+    roster_add(index);
+    heartbeat_arm(index);
+    stats_count(STAT_ACCEPTS, 1);
+    return index;
 }
 
 // 클라이언트 제거
+// 목록에서 먼저 숨기고, 이 클라이언트에게 보내는 중인 읽기 구간이 끝난 뒤 자원을 정리
+// (소켓 번호가 재사용되어 다른 연결로 전송되는 일이 없도록 close도 그 뒤에 함)
+// 수신 버퍼와 eventfd는 슬롯과 함께 다음 연결이 재사용하므로 해제하지 않음
 void remove_client(int index) {
+    client_info *c = client_at(index);
     pthread_mutex_lock(&clients_mutex);
-    clients[index].active = 0;
-    close(clients[index].socket);
+    registry_remove(index);
     pthread_mutex_unlock(&clients_mutex);
+    roster_remove(index);
+    group_leave_all(index);
+    
+    registry_synchronize();
+    heartbeat_cancel(index);
+    close(c->socket);
+    outq_destroy(&c->out);
+    strand_destroy(&c->strand);
+    
+    registry_free(index);
 }
 
-// 클라이언트 처리 쓰레드 함수
-void *handle_client(void *arg) {
-    int index = *(int *)arg;
-    free(arg);
-    
-    client_info *client = &clients[index];
-    char buffer[BUFFER_SIZE];
-    int bytes_received;
-    
-    printf("[클라이언트 %d] 연결됨 - IP: %s, Port: %d\n", 
-           client->id,
-           inet_ntoa(client->address.sin_addr), 
-           ntohs(client->address.sin_port));
-    
-    // 환영 메시지 및 명령어 안내
-    char welcome_msg[500];
-    sprintf(welcome_msg, 
-            "\n=== 채팅 서버에 오신 것을 환영합니다! ===\n"
-            "당신의 ID: %d, 이름: %s\n"
-            "\n[명령어]\n"
-            "/name <이름> - 이름 변경\n"
-            "/list - 접속자 목록\n"
-            "/msg <ID> <메시지> - 개인 메시지\n"
-            "/all <메시지> - 전체 메시지\n"
-            "/quit - 종료\n"
-            "그 외 입력은 모두에게 전송됩니다.\n"
-            "=====================================\n",
-            client->id, client->name);
-    send(client->socket, welcome_msg, strlen(welcome_msg), 0);
+// 클라이언트 접속 직후 처리 - 환영 메시지 전송 및 입장 알림
+void client_on_connect(int index) {
+    client_info *client = client_at(index);
+    
+    char ip[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &client->address.sin_addr, ip, sizeof(ip));
+    log_printf(LOG_INFO, "[클라이언트 %d] 연결됨 - IP: %s, Port: %d",
+               client->id, ip, ntohs(client->address.sin_port));
+    
+    // 환영 메시지 및 명령어 안내 (안내는 명령어 표에서 생성)
+    char welcome_msg[2048];
+    int len = sprintf(welcome_msg, 
+                      "\n=== 채팅 서버에 오신 것을 환영합니다! ===\n"
+                      "당신의 ID: %d, 이름: %s\n"
+                      "\n[명령어]\n",
+                      client->id, client->name);
+    len += command_help(welcome_msg + len, sizeof(welcome_msg) - len - 128);
+    len += sprintf(welcome_msg + len,
+                   "그 외 입력은 모두에게 전송됩니다.\n"
+                   "=====================================\n");
+    client_send(index, welcome_msg, (size_t)len);
     
     // 다른 사용자들에게 입장 알림
-    char join_msg[100];
-    sprintf(join_msg, "[시스템] %s(ID:%d)님이 입장하셨습니다.\n", client->name, client->id);
+    msgbuf *join_msg = msgbuf_printf("[시스템] %s(ID:%d)님이 입장하셨습니다.\n", client->name, client->id);
     broadcast_message(join_msg, client->id);
+    if (join_msg) msgbuf_put(join_msg);
+}
+
+// 속도 제한 확인 - 거절하면 연속 거절 중 처음 한 번만 안내 (주인 I/O 루프에서만 호출)
+int client_admit(int index, int rate_class) {
+    int notify;
+    if (rate_admit(client_at(index)->rate, rate_class, &notify)) return 1;
+    if (notify) {
+        static const char limit_msg[] = "[시스템] 메시지가 너무 많습니다. 잠시 후 다시 보내세요.\n";
+        client_send(index, limit_msg, sizeof(limit_msg) - 1);
+    }
+    return 0;
+}
+
+// 수신 메시지 하나 처리 (속도 제한은 on_frame이 이미 확인함)
+// 반환값: 0 = 계속, -1 = 연결 종료 요청(/quit)
+int client_on_message(int index, char *buffer) {
+    // 개행 문자 제거
+    char *newline = strchr(buffer, '\n');
+    if (newline) *newline = '\0';
     
-    // 클라이언트로부터 메시지 수신
-    while ((bytes_received = recv(client->socket, buffer, BUFFER_SIZE - 1, 0)) > 0) {
-        buffer[bytes_received] = '\0';
-        
-        // 개행 문자 제거
-        char *newline = strchr(buffer, '\n');
-        if (newline) *newline = '\0';
-        
-        // printf("[클라이언트 %d] %s: %s\n", client->id, client->name, buffer);
-        printf("%s\n", buffer);
+    // printf("[클라이언트 %d] %s: %s\n", client->id, client->name, buffer);
+    // 받은 내용에는 귓속말 등이 들어 있으므로 -L debug일 때만 기록 (/register는 비밀번호를 빼고)
+    // 터미널에 직접 쓰지 않고 로그 링에 복사만 함 (출력은 로그 쓰레드가)
+    if (log_level <= LOG_DEBUG) {
+        size_t len = newline ? (size_t)(newline - buffer) : strlen(buffer);
+        if (strncmp(buffer, "/register", 9) == 0) len = 9;
+        log_write(LOG_DEBUG, buffer, len);
+    }
+    
+    // 하트비트 응답 (받은 것 자체로 활동 시각은 이미 갱신됨)
+    if (strcmp(buffer, HB_PONG_LINE) == 0) return 0;
+    
+    // 명령어 처리 (명령어 표에서 찾아 실행)
+    if (buffer[0] == '/') {
+        return command_dispatch(index, buffer);
+    }
+    else if (buffer[0] == HB_CTRL) {
+        // 채팅은 받은 줄을 그대로 보내므로 서버 제어 줄(PING 등)로 보일 수 있는 메시지는 거절
+        const char *reject_msg = "[시스템] 제어 문자로 시작하는 메시지는 보낼 수 없습니다.\n";
+        client_send(index, reject_msg, strlen(reject_msg));
+    }
+    else {
+        // 일반 메시지는 모든 사용자에게 전송
+        // msgbuf *chat_msg = msgbuf_printf("%s(ID:%d): %s\n", client->name, client->id, buffer);
+        msgbuf *chat_msg = msgbuf_printf("%s\n", buffer);  // 이름과 ID 제거, 메시지만 전송
+        broadcast_message(chat_msg, client_at(index)->id);
+        if (chat_msg) msgbuf_put(chat_msg);
+        rate_charge_fanout((unsigned long)registry_count());
         
-        // 명령어 처리
-        if (buffer[0] == '/') {
-            if (strncmp(buffer, "/quit", 5) == 0) {
-                printf("[클라이언트 %d] 연결 종료 요청\n", client->id);
-                break;
-            }
-            else if (strncmp(buffer, "/name ", 6) == 0) {
-                // 이름 변경
-                char old_name[NAME_SIZE];
-                strcpy(old_name, client->name);
-                strncpy(client->name, buffer + 6, NAME_SIZE - 1);
-                client->name[NAME_SIZE - 1] = '\0';
-                
-                char name_msg[200];
-                sprintf(name_msg, "[시스템] %s님이 이름을 %s(으)로 변경했습니다.\n", old_name, client->name);
-                broadcast_message(name_msg, -1);
-            }
-            else if (strncmp(buffer, "/list", 5) == 0) {
-                // 접속자 목록
-                char list_buffer[1024];
-                get_client_list(list_buffer);
-                send(client->socket, list_buffer, strlen(list_buffer), 0);
-            }
-            else if (strncmp(buffer, "/msg ", 5) == 0) {
-                // 개인 메시지
-                int target_id;
-                char msg_content[BUFFER_SIZE];
-                if (sscanf(buffer + 5, "%d %[^\n]", &target_id, msg_content) == 2) {
-                    char private_msg[BUFFER_SIZE + 100];
-                    sprintf(private_msg, "[귓속말 from %s(ID:%d)] %s\n", client->name, client->id, msg_content);
-                    send_to_client(private_msg, target_id, client->id);
-                    
-                    // 발신자에게 확인 메시지
-                    sprintf(private_msg, "[귓속말 to ID:%d] %s\n", target_id, msg_content);
-                    send(client->socket, private_msg, strlen(private_msg), 0);
-                } else {
-                    char error_msg[] = "[시스템] 사용법: /msg <ID> <메시지>\n";
-                    send(client->socket, error_msg, strlen(error_msg), 0);
-                }
-            }
-            else if (strncmp(buffer, "/all ", 5) == 0) {
-                // 전체 메시지 (명시적)
-                char broadcast_msg[BUFFER_SIZE + 100];
-                sprintf(broadcast_msg, "[전체] %s(ID:%d): %s\n", client->name, client->id, buffer + 5);
-                broadcast_message(broadcast_msg, client->id);
-                send(client->socket, broadcast_msg, strlen(broadcast_msg), 0);
-            }
-            else {
-                // 알 수 없는 명령어
-                char help_msg[] = "[시스템] 알 수 없는 명령어입니다. /help로 도움말을 확인하세요.\n";
-                send(client->socket, help_msg, strlen(help_msg), 0);
-            }
-        }
-        else {
-            // 일반 메시지는 모든 사용자에게 전송
-            char chat_msg[BUFFER_SIZE + 100];
-            // sprintf(chat_msg, "%s(ID:%d): %s\n", client->name, client->id, buffer);
-            sprintf(chat_msg, "%s\n", buffer);  // 이름과 ID 제거, 메시지만 전송
-            broadcast_message(chat_msg, client->id);
-            
-            // 발신자에게도 자신의 메시지 표시
-            //send(client->socket, chat_msg, strlen(chat_msg), 0);
-        }
+        // 발신자에게도 자신의 메시지 표시
+        //send(client->socket, chat_msg, strlen(chat_msg), 0);
     }
     
+    return 0;
+}
+
+// 클라이언트 연결 종료 처리 - 퇴장 알림 및 클라이언트 제거
+// 작업 풀에 넘긴 메시지가 모두 끝난 뒤에 호출 (퇴장 알림보다 앞서 처리되고, 슬롯이 재사용되기 전에 끝나도록)
+// epoll/io_uring은 strand_close로 기다리지 않고 비움 알림을 받은 뒤, thread 모델은 strand_wait 뒤에 호출
+void client_on_disconnect(int index) {
+    client_info *client = client_at(index);
+    
     // 클라이언트 연결 종료
-    printf("[클라이언트 %d] %s 연결 종료\n", client->id, client->name);
+    log_printf(LOG_INFO, "[클라이언트 %d] %s 연결 종료", client->id, client->name);
     
     // 퇴장 알림
-    char leave_msg[100];
-    sprintf(leave_msg, "[시스템] %s(ID:%d)님이 퇴장하셨습니다.\n", client->name, client->id);
+    msgbuf *leave_msg = msgbuf_printf("[시스템] %s(ID:%d)님이 퇴장하셨습니다.\n", client->name, client->id);
     broadcast_message(leave_msg, client->id);
+    if (leave_msg) msgbuf_put(leave_msg);
     
     // 클라이언트 제거
     remove_client(index);
-    
-    return NULL;
 }
 
-int main() {
-    struct sockaddr_in server_addr, client_addr;
-    socklen_t client_len = sizeof(client_addr);
-    pthread_t thread_id;
+// 프레임 하나 = 메시지 하나
+static __thread uint64_t rx_time;      // 지금 처리 중인 데이터를 받은 시각 (수신→fanout 지연 기준)
+
+// 작업 풀에서 메시지 하나 실행
+// /quit이면 수신 쪽을 닫아 담당 I/O 루프가 상대방 종료와 같은 경로로 연결을 정리하게 함
+// (실행이 끝나기 전에는 연결이 정리되지 않으므로 소켓은 아직 이 연결의 것)
+static void pool_message(int index, char *msg, uint64_t rx) {
+    if (client_on_message(index, msg) < 0) {
+        shutdown(client_at(index)->socket, SHUT_RD);
+    }
+    stats_record(STAT_RECV_TO_FANOUT, stats_now() - rx);
+}
+
+// 작업 풀로 넘길 메시지인지 - 접속자 수에 비례하는 작업이거나,
+// 앞서 넘긴 메시지가 아직 끝나지 않은 연결 (순서를 지키기 위해 뒤따르는 메시지도 넘김)
+static int want_pool(int index, const char *msg) {
+    if (!workpool_enabled()) return 0;
+    if (strand_busy(&client_at(index)->strand)) return 1;
+    if (msg[0] == '/') return command_pooled(msg);
+    return registry_count() >= WORKPOOL_FANOUT_MIN;
+}
+
+// 메시지의 속도 제한 종류 (하트비트 응답은 제한 없음)
+static int message_rate_class(const char *msg) {
+    if (msg[0] == '/') return command_rate_class(msg);
+    size_t n = strlen(HB_PONG_LINE);
+    if (strncmp(msg, HB_PONG_LINE, n) == 0 && (msg[n] == '\0' || msg[n] == '\n')) return RATE_NONE;
+    return RATE_CHAT;
+}
+
+static int on_frame(void *arg, char *msg, size_t len) {
+    int index = (int)(intptr_t)arg;
+    stats_count(STAT_RX_MESSAGES, 1);
+    stats_count(STAT_RX_BYTES, len);
     
-    // 시그널 핸들러 등록
-    signal(SIGINT, handle_shutdown);
+    // 속도 제한은 작업 풀에 복사해 넘기기 전에 I/O 루프에서 (bucket도 주인 루프만 만짐)
+    if (!client_admit(index, message_rate_class(msg))) return 0;
+    
+    if (want_pool(index, msg)) {
+        pool_strand *s = &client_at(index)->strand;
+        if (workpool_submit(s, pool_message, index, msg, len, rx_time) == 0) return 0;
+        if (strand_busy(s)) {
+            // 앞선 메시지가 풀에서 실행 중이라 여기서 실행하면 순서가 바뀜
+            log_printf(LOG_WARN, "[클라이언트 %d] 작업 풀에 넘기지 못해 메시지를 버렸습니다.", client_at(index)->id);
+            return 0;
+        }
+    }
     
-    // 클라이언트 배열 초기화
-    memset(clients, 0, sizeof(clients));
+    int ret = client_on_message(index, msg);
+    stats_record(STAT_RECV_TO_FANOUT, stats_now() - rx_time);
+    return ret;
+}
+
+/**
+ * client_read - 소켓에서 EAGAIN까지 읽고 완성된 메시지를 모두 처리 (thread/epoll 모델)
+ * @index: 클라이언트 인덱스 (논블로킹 소켓)
+ * @return: 0 = 연결 유지, -1 = 연결 종료 (상대방 종료, 오류, /quit)
+ *
+ * 한 번 읽은 데이터에 메시지가 여러 개 있으면 모두 처리하고,
+ * 잘려서 온 메시지는 나머지가 도착할 때까지 수신 링에 남겨 둡니다.
+ */
+int client_read(int index) {
+    client_info *c = client_at(index);
     
-    // 소켓 생성
-    server_socket = socket(AF_INET, SOCK_STREAM, 0);
-    if (server_socket < 0) {
-        perror("소켓 생성 실패");
-        exit(1);
+    while (1) {
+        ssize_t n = frame_rx_read(&c->rx, c->socket);
+        if (n > 0) {
+            rx_time = stats_now();
+            __atomic_store_n(&c->last_rx, heartbeat_clock(), __ATOMIC_RELAXED);
+            if (frame_rx_parse(&c->rx, on_frame, (void *)(intptr_t)index) < 0) return -1;
+            continue;
+        }
+        if (n == 0) return -1;                              // 상대방 연결 종료
+        if (errno == EAGAIN || errno == EWOULDBLOCK) return 0;
+        return -1;                                          // 수신 오류
+    }
+}
+
+// 다른 곳에서 받은 데이터 처리 (io_uring 제공 버퍼, data[len]에 1바이트 여유 필요)
+int client_on_data(int index, char *data, size_t len) {
+    rx_time = stats_now();
+    __atomic_store_n(&client_at(index)->last_rx, heartbeat_clock(), __ATOMIC_RELAXED);
+    return frame_rx_input(&client_at(index)->rx, data, len, on_frame, (void *)(intptr_t)index);
+}
+
+// 소켓을 논블로킹 모드로 설정
+static int set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0) return -1;
+    return fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+// ================= thread 모델 =================
+
+// 연결이 끝난 쓰레드는 바로 끝내지 않고 잠시 다음 연결을 기다림 (쓰레드 캐시)
+// 재접속이 잦을 때 연결마다 쓰레드를 만들고(스택 할당) 없애는 비용을 줄임
+#define THREAD_CACHE_MAX    64          // 다음 연결을 기다리는 최대 쓰레드 수
+#define THREAD_CACHE_IDLE   30          // 연결 없이 기다리다 끝내는 시간 (초)
+
+static pthread_mutex_t handoff_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t handoff_cond = PTHREAD_COND_INITIALIZER;
+static int handoff_idle;                        // 연결을 기다리는 쓰레드 수 (아직 넘겨받지 않은)
+static int handoff_queue[THREAD_CACHE_MAX];     // 기다리는 쓰레드에게 넘긴 연결
+static int handoff_count;
+
+// 기다리는 쓰레드가 있으면 연결을 넘김 (0: 넘김, -1: 새 쓰레드 필요)
+static int handoff_connection(int index) {
+    pthread_mutex_lock(&handoff_lock);
+    if (handoff_idle == 0) {
+        pthread_mutex_unlock(&handoff_lock);
+        return -1;
+    }
+    handoff_idle--;
+    handoff_queue[handoff_count++] = index;
+    pthread_cond_signal(&handoff_cond);
+    pthread_mutex_unlock(&handoff_lock);
+    return 0;
+}
+
+// 다음 연결을 기다림 (-1: 기다리는 쓰레드가 이미 많거나 오래 기다림 → 쓰레드 종료)
+static int handoff_wait(void) {
+    pthread_mutex_lock(&handoff_lock);
+    if (handoff_idle + handoff_count >= THREAD_CACHE_MAX) {
+        pthread_mutex_unlock(&handoff_lock);
+        return -1;
     }
+    handoff_idle++;
     
-    // SO_REUSEADDR 옵션 설정
-    int opt = 1;
-    if (setsockopt(server_socket, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
-        perror("setsockopt 실패");
-        exit(1);
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += THREAD_CACHE_IDLE;
+    while (handoff_count == 0) {
+        if (pthread_cond_timedwait(&handoff_cond, &handoff_lock, &deadline) == ETIMEDOUT &&
+            handoff_count == 0) {
+            handoff_idle--;
+            pthread_mutex_unlock(&handoff_lock);
+            return -1;
+        }
     }
+    int index = handoff_queue[--handoff_count];
+    pthread_mutex_unlock(&handoff_lock);
+    return index;
+}
+
+// 연결 하나 처리 - 소켓 수신과 송신 대기열 알림(eventfd)을 poll로 함께 기다림
+// 묶음 창 중이면 창이 끝날 때까지만 기다리고 쓰기 가능 이벤트는 보지 않음
+static void serve_client(int index) {
+    client_info *client = client_at(index);
+    int done = 0;
     
-    // 서버 주소 설정
-    memset(&server_addr, 0, sizeof(server_addr));
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_addr.s_addr = INADDR_ANY;
-    server_addr.sin_port = htons(PORT);
+    set_nonblocking(client->socket);
+    client_on_connect(index);
     
-    // 바인드
-    if (bind(server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0) {
-        perror("바인드 실패");
-        close(server_socket);
-        exit(1);
+    while (!done) {
+        long wait = outq_batch_wait(&client->out);
+        struct timespec ts = { wait / 1000000, (wait % 1000000) * 1000 };
+        struct pollfd pfds[2];
+        pfds[0].fd = client->socket;
+        pfds[0].events = POLLIN | (wait == 0 ? POLLOUT : 0);
+        pfds[1].fd = client->wake_fd;
+        pfds[1].events = POLLIN;
+        
+        if (ppoll(pfds, 2, wait > 0 ? &ts : NULL, NULL) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        
+        if (pfds[1].revents & POLLIN) {
+            uint64_t count;
+            if (read(client->wake_fd, &count, sizeof(count)) < 0 && errno != EAGAIN) break;
+        }
+        
+        // 송신 대기열 비우기 (disconnect 정책으로 넘쳤으면 종료)
+        if (client->out.overflowed) break;
+        if (outq_batch_wait(&client->out) == 0 && outq_flush(&client->out, client->socket) < 0) break;
+        
+        // 클라이언트로부터 메시지 수신
+        if (pfds[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+            done = client_read(index) < 0;
+        }
     }
     
-    // 리슨
-    if (listen(server_socket, MAX_CLIENTS) < 0) {
-        perror("리슨 실패");
-        close(server_socket);
-        exit(1);
+    // 종료 전 남은 응답(/quit 등)을 가능한 만큼 전송
+    // 작업 풀에 넘긴 메시지는 이 연결의 쓰레드에서 기다림 (다른 연결은 멈추지 않음)
+    outq_flush(&client->out, client->socket);
+    strand_wait(&client->strand);
+    client_on_disconnect(index);
+}
+
+// 클라이언트 처리 쓰레드 함수 (thread 모델, arg: 슬롯 인덱스)
+void *handle_client(void *arg) {
+    int index = (int)(intptr_t)arg;
+    do {
+        serve_client(index);
+    } while ((index = handoff_wait()) >= 0);
+    return NULL;
+}
+
+// I/O 모델 이름
+static const char *io_mode_name(int mode) {
+    switch (mode) {
+    case IO_MODE_EPOLL: return "epoll";
+    case IO_MODE_URING: return "uring";
+    default:            return "thread";
     }
-    
-    printf("채팅 서버가 포트 %d에서 시작되었습니다.\n", PORT);
-    printf("클라이언트 연결을 기다리는 중...\n");
+}
+
+// 사용법 출력
+static void print_usage(const char *prog) {
+    fprintf(stderr,
+            "사용법: %s [-m thread|epoll|uring] [-t 쓰레드수] [-w 작업쓰레드수] [-q 대기열크기] [-o 정책] [-c 최대접속자수] [-s 보관로그]\n"
+            "       [-r 채팅,전체,귓속말] [-f fanout예산] [-b 창us[,바이트][,cork]] [-k 핑초,종료초] [-u 지표소켓] [-L 로그레벨] [-l 로그파일]\n"
+            "  -m : I/O 모델 (기본값: %s)\n"
+            "  -t : epoll 샤드(리액터 쓰레드) 수 (기본값: %d)\n"
+            "  -w : 명령어 작업 풀 쓰레드 수, 0이면 모두 I/O 쓰레드에서 실행 (기본값: CPU 수)\n"
+            "  -q : 클라이언트당 송신 대기열 최대 메시지 수 (기본값: %d)\n"
+            "  -o : 대기열이 가득 찼을 때 정책 drop-oldest|drop-newest|disconnect (기본값: drop-oldest)\n"
+            "  -b : 묶음 전송 창(us)과 바로 보낼 바이트 수, cork면 MSG_MORE 사용, off면 바로 전송 (기본값: off, %d바이트)\n"
+            "  -c : 최대 동시 접속자 수 (기본값: %d)\n"
+            "  -s : 오프라인 호출 보관 로그 파일, off면 보관하지 않음 (기본값: %s)\n"
+            "  -r : 클라이언트당 초당 메시지 수 (채팅,전체,귓속말), 0이나 off면 제한 없음 (기본값: %d,%d,%d)\n"
+            "  -f : 서버 전체 초당 fanout 수신자 수, 0이면 제한 없음 (기본값: %d)\n"
+            "  -k : 마지막 수신 후 PING을 보낼 때까지, 연결을 끊을 때까지의 초, off면 끄기 (기본값: %d,%d)\n"
+            "  -u : 지표 Unix 소켓 경로, off면 열지 않음 (기본값: %s)\n"
+            "  -L : 로그 레벨 debug|info|warn|error (기본값: info)\n"
+            "  -l : 로그 파일 (기본값: 표준 출력)\n",
+            prog, io_mode_name(DEFAULT_IO_MODE), DEFAULT_IO_THREADS, OUTQ_DEFAULT_MAX_DEPTH,
+            OUTQ_DEFAULT_BATCH_BYTES, MAX_CLIENTS,
+            PAGELOG_DEFAULT_PATH, RATE_DEFAULT_CHAT, RATE_DEFAULT_BROADCAST, RATE_DEFAULT_PRIVATE,
+            RATE_DEFAULT_FANOUT, HB_DEFAULT_PING, HB_DEFAULT_TIMEOUT, STATS_DEFAULT_SOCK);
+}
+
+// thread 모델 - 접속마다 쓰레드를 생성하는 연결 수락 루프
+static void run_thread_server(void) {
+    struct sockaddr_in client_addr;
+    socklen_t client_len = sizeof(client_addr);
+    pthread_t thread_id;
     
     // 클라이언트 연결 수락 루프
     while (1) {
+        client_len = sizeof(client_addr);
         int client_socket = accept(server_socket, (struct sockaddr *)&client_addr, &client_len);
         
         if (client_socket < 0) {
-            perror("클라이언트 연결 수락 실패");
+            log_printf(LOG_WARN, "클라이언트 연결 수락 실패: %m");
             continue;
         }
         
         // 클라이언트 추가
-        int index = add_client(client_socket, client_addr);
+        int index = add_client(client_socket, client_addr, 0);
         if (index < 0) {
-            printf("최대 클라이언트 수에 도달했습니다.\n");
+            log_printf(LOG_WARN, "최대 클라이언트 수에 도달했습니다.");
             char full_msg[] = "서버가 가득 찼습니다. 나중에 다시 시도해주세요.\n";
             send(client_socket, full_msg, strlen(full_msg), 0);
             close(client_socket);
             continue;
         }
         
-        // 새 쓰레드에서 클라이언트 처리
-        int *arg = malloc(sizeof(int));
-        *arg = index;
+        // 연결을 기다리는 쓰레드에게 넘기고, 없으면 새 쓰레드에서 처리
+        if (handoff_connection(index) == 0) continue;
         
-        if (pthread_create(&thread_id, NULL, handle_client, arg) != 0) {
-            perror("쓰레드 생성 실패");
+        int err = pthread_create(&thread_id, NULL, handle_client, (void *)(intptr_t)index);
+        if (err != 0) {
+            log_printf(LOG_ERROR, "쓰레드 생성 실패: %s", strerror(err));
             remove_client(index);
-            free(arg);
             continue;
         }
+        stats_count(STAT_SESSION_ALLOCS, 1);
         
         // 쓰레드 분리
         pthread_detach(thread_id);
     }
+}
+
+/**
+ * create_listen_socket - 서버 리슨 소켓 생성 (bind + listen)
+ * @return: 소켓 디스크립터, 실패 시 -1
+ *
+ * SO_REUSEPORT를 설정하므로 epoll 샤드들이 같은 포트에 각자 리슨 소켓을
+ * 만들 수 있고, 커널이 들어오는 연결을 샤드들에게 분산합니다.
+ */
+int create_listen_socket(void) {
+    struct sockaddr_in server_addr;
+    
+    // 소켓 생성
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0) {
+        perror("소켓 생성 실패");
+        return -1;
+    }
+    
+    // SO_REUSEADDR / SO_REUSEPORT 옵션 설정
+    int reuse = 1;
+    if (setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) < 0 ||
+        setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof(reuse)) < 0) {
+        perror("setsockopt 실패");
+        close(sock);
+        return -1;
+    }
+    
+    // 서버 주소 설정
+    memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_addr.s_addr = INADDR_ANY;
+    server_addr.sin_port = htons(PORT);
+    
+    // 바인드
+    if (bind(sock, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0) {
+        perror("바인드 실패");
+        close(sock);
+        return -1;
+    }
+    
+    // 리슨
+    if (listen(sock, SOMAXCONN) < 0) {
+        perror("리슨 실패");
+        close(sock);
+        return -1;
+    }
+    
+    return sock;
+}
+
+int main(int argc, char *argv[]) {
+    int io_threads = DEFAULT_IO_THREADS;
+    int pool_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    const char *pagelog_path = PAGELOG_DEFAULT_PATH;
+    const char *stats_path = STATS_DEFAULT_SOCK;
+    const char *log_path = NULL;
+    int opt;
+    
+    // 명령줄 인자 처리
+    while ((opt = getopt(argc, argv, "m:t:w:q:o:b:c:s:r:f:k:u:L:l:h")) != -1) {
+        switch (opt) {
+        case 'm':
+            if (strcmp(optarg, "thread") == 0) io_mode = IO_MODE_THREAD;
+            else if (strcmp(optarg, "epoll") == 0) io_mode = IO_MODE_EPOLL;
+            else if (strcmp(optarg, "uring") == 0) io_mode = IO_MODE_URING;
+            else { print_usage(argv[0]); exit(1); }
+            break;
+        case 't':
+            io_threads = atoi(optarg);
+            if (io_threads < 1) { print_usage(argv[0]); exit(1); }
+            break;
+        case 'w':
+            pool_threads = atoi(optarg);
+            if (pool_threads < 0) { print_usage(argv[0]); exit(1); }
+            break;
+        case 'q':
+            if (atoi(optarg) < 1) { print_usage(argv[0]); exit(1); }
+            outq_max_depth = (unsigned)atoi(optarg);
+            break;
+        case 'c':
+            max_clients = atoi(optarg);
+            if (max_clients < 1) { print_usage(argv[0]); exit(1); }
+            break;
+        case 'r':
+            if (rate_parse(optarg) < 0) { print_usage(argv[0]); exit(1); }
+            break;
+        case 'f':
+            if (atoi(optarg) < 0) { print_usage(argv[0]); exit(1); }
+            rate_fanout_per_sec = (unsigned)atoi(optarg);
+            break;
+        case 'L':
+            log_level = log_parse_level(optarg);
+            if (log_level < 0) { print_usage(argv[0]); exit(1); }
+            break;
+        case 'l':
+            log_path = optarg;
+            break;
+        case 'k':
+            if (heartbeat_parse(optarg) < 0) { print_usage(argv[0]); exit(1); }
+            break;
+        case 'u':
+            stats_path = (strcmp(optarg, "off") == 0) ? NULL : optarg;
+            break;
+        case 's':
+            pagelog_path = (strcmp(optarg, "off") == 0) ? NULL : optarg;
+            break;
+        case 'o':
+            outq_policy = outq_parse_policy(optarg);
+            if (outq_policy < 0) { print_usage(argv[0]); exit(1); }
+            break;
+        case 'b':
+            if (outq_parse_batch(optarg) < 0) { print_usage(argv[0]); exit(1); }
+            break;
+        default:
+            print_usage(argv[0]);
+            exit(1);
+        }
+    }
+    
+    // 로그 쓰기 쓰레드 (이후 실행 중 메시지는 로그 링을 거쳐 출력)
+    if (log_init(log_path) < 0) exit(1);
+    
+    // 시그널 핸들러 등록
+    signal(SIGINT, handle_shutdown);
+    signal(SIGPIPE, SIG_IGN);   // 끊긴 소켓에 send 시 프로세스 종료 방지
+    
+    // 명령어 색인 생성
+    if (command_init() < 0) {
+        fprintf(stderr, "명령어 색인 생성 실패\n");
+        exit(1);
+    }
+    
+    // 세션 테이블 초기화
+    if (registry_init(max_clients) < 0) {
+        perror("세션 테이블 생성 실패");
+        exit(1);
+    }
+    
+    // 하트비트 (조용한 연결에 PING, 응답이 없으면 연결 종료)
+    if (heartbeat_init() < 0) exit(1);
+    
+    // 명령어 작업 풀 (접속자 수에 비례하는 명령어/브로드캐스트를 여러 코어에서 실행)
+    if (workpool_init(pool_threads) < 0) exit(1);
+    
+    // 오프라인 호출 보관 로그 (소유자가 있는 호출번호는 자동 부여하지 않음)
+    if (pagelog_path && pagelog_open(pagelog_path) < 0) exit(1);
+    
+    // 지표 소켓 (Prometheus 텍스트 형식)
+    if (stats_path && stats_serve(stats_path) < 0) exit(1);
+    
+    // 리슨 소켓 생성
+    server_socket = create_listen_socket();
+    if (server_socket < 0) {
+        exit(1);
+    }
+    
+    // io_uring을 쓸 수 없는 커널이면 epoll 리액터로 대체
+    if (io_mode == IO_MODE_URING && uring_server_init(server_socket) < 0) {
+        log_printf(LOG_WARN, "io_uring을 사용할 수 없어 epoll 모델로 대체합니다.");
+        io_mode = IO_MODE_EPOLL;
+    }
+    
+    log_printf(LOG_INFO, "채팅 서버가 포트 %d에서 시작되었습니다. (I/O 모델: %s)",
+               PORT, io_mode_name(io_mode));
+    log_printf(LOG_INFO, "클라이언트 연결을 기다리는 중...");
+    
+    if (io_mode == IO_MODE_URING) {
+        run_uring_server();
+    } else if (io_mode == IO_MODE_EPOLL) {
+        run_epoll_server(server_socket, io_threads);
+    } else {
+        run_thread_server();
+    }
     
     close(server_socket);
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,177 @@
+// server.h - 채팅(호출) 서버 공용 헤더 파일
+//
+// 서버의 I/O 모델(쓰레드-per-커넥션, epoll 리액터)이 공통으로 사용하는
+// 상수, 클라이언트 정보 구조체, 세션 처리 함수 선언들을 정의합니다.
+//
+// I/O 모델 구성:
+// - thread : 접속마다 쓰레드 하나 (blocking recv)
+// - epoll  : edge-triggered epoll 리액터 (논블로킹 소켓, SO_REUSEPORT 샤드 1~N개)
+// - uring  : io_uring 리액터 (멀티샷 accept/recv, 링크된 send, 미지원 시 epoll로 대체)
+
+#ifndef SERVER_H
+#define SERVER_H
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE         // accept4, CPU 친화도 등 GNU 확장
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <signal.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdint.h>
+#include <sys/eventfd.h>
+
+#include "msgbuf.h"         // 참조 카운트 공유 메시지 버퍼
+#include "outq.h"           // 클라이언트별 송신 대기열
+#include "frame.h"          // 수신 스트림 프레이밍
+#include "command.h"        // 명령어 디스패처
+#include "pagelog.h"        // 오프라인 호출 보관 로그
+#include "group.h"          // 그룹 호출 채널
+#include "ratelimit.h"      // 속도 제한
+#include "stats.h"          // 지연 히스토그램, 카운터
+#include "log.h"            // 비동기 로그
+#include "workpool.h"       // 명령어 실행 작업 풀
+#include "roster.h"         // 접속자 목록
+#include "heartbeat.h"      // 하트비트, 유휴 연결 종료
+
+// ================= 서버 설정 =================
+
+#define PORT 8080
+#ifndef MAX_CLIENTS
+#define MAX_CLIENTS 65536   // 기본 최대 동시 접속자 수 (명령줄 -c 옵션으로 변경)
+#endif
+#define BUFFER_SIZE 1024
+#define NAME_SIZE 32
+#define CLIENT_ID_MAX PAGELOG_MAX_ID    // 클라이언트 ID/호출번호 상한 (넘으면 자동 ID는 1부터 다시)
+
+// I/O 모델 선택 (명령줄 -m 옵션 또는 컴파일 시 -DDEFAULT_IO_MODE=IO_MODE_EPOLL)
+#define IO_MODE_THREAD  0   // 접속마다 쓰레드 생성
+#define IO_MODE_EPOLL   1   // epoll 리액터
+#define IO_MODE_URING   2   // io_uring 리액터
+
+#ifndef DEFAULT_IO_MODE
+#define DEFAULT_IO_MODE IO_MODE_THREAD
+#endif
+
+#ifndef DEFAULT_IO_THREADS
+#define DEFAULT_IO_THREADS 1    // epoll 샤드(리액터 쓰레드) 수
+#endif
+
+// ================= 클라이언트 관리 =================
+
+// 클라이언트 정보 구조체 (세션 슬롯)
+// 슬롯은 청크로 미리 할당되어 연결이 끊겨도 해제하지 않고 다음 연결이 재사용함
+// (수신 링 버퍼, thread 모델의 eventfd도 슬롯에 남겨 두고 다시 씀)
+// 브로드캐스트 순회가 슬롯마다 첫 캐시 라인만 읽도록 자주 쓰는 필드를 앞에 모으고,
+// 슬롯 시작을 캐시 라인에 맞춤 (이웃 슬롯과 캐시 라인을 나눠 쓰지 않음)
+typedef struct {
+    // 처리 경로 (fanout 순회, 송수신)
+    int active;
+    int id;
+    int socket;
+    int shard;              // 담당 epoll 샤드 번호 (epoll 모델)
+    int closing;            // 담당 I/O 루프가 연결을 끊기로 한 상태
+    int batched;            // 샤드의 묶음 전송 목록에 있음 (epoll 모델)
+    int wake_fd;            // 송신 대기열 알림 eventfd (thread 모델, 슬롯과 함께 재사용)
+    void *io_conn;          // I/O 모델별 연결 상태 (io_uring 모델)
+    outq out;               // 송신 대기열 (thread/epoll 모델)
+    frame_rx rx;            // 수신 링 버퍼 (메시지 경계 재조립, 버퍼는 슬롯과 함께 재사용)
+    rate_bucket rate[RATE_CLASSES];     // 명령어 종류별 속도 제한 (메시지를 처리 중인 쓰레드만 사용)
+    pool_strand strand;     // 작업 풀로 넘긴 메시지 (연결별 실행 순서)
+    int groups;             // 가입한 그룹 수
+    uint64_t last_rx;       // 마지막으로 데이터를 받은 틱 (heartbeat_clock)
+
+    // 드물게 쓰는 필드 (입장/퇴장, 이름, 목록)
+    unsigned name_seq;      // 이름 seqlock (홀수: 변경 중)
+    char name[NAME_SIZE];
+    struct sockaddr_in address;
+    int shard_slot;         // 샤드 멤버 배열 내 위치
+    int drained_next;       // 샤드의 비움 알림 대체 목록에서 다음 슬롯 (epoll 모델, 알림 할당 실패 시만)
+    int roster_slot;        // 접속자 목록 배열 내 위치 (-1: 목록에 없음)
+    hb_state hb;            // 하트비트 타이머 (hb_lock으로 보호)
+    int next_free;          // free list의 다음 빈 슬롯 (빈 슬롯일 때만 사용)
+} __attribute__((aligned(64))) client_info;
+
+// 세션 테이블 (registry.c) - 슬롯은 청크 단위로 할당되어 주소가 바뀌지 않음
+// 쓰기(입장/퇴장)는 clients_mutex로 직렬화하고, 읽기는 lock 없이 읽기 구간 안에서 수행
+#define CLIENT_CHUNK_SHIFT  8
+#define CLIENT_CHUNK_SIZE   (1 << CLIENT_CHUNK_SHIFT)  // 청크 하나의 슬롯 수
+
+extern client_info **client_chunks;
+extern int max_clients;             // 최대 동시 접속자 수
+
+// 슬롯 인덱스 → 클라이언트 정보 (lock 없이 사용 가능)
+static inline client_info *client_at(int index) {
+    return &client_chunks[index >> CLIENT_CHUNK_SHIFT][index & (CLIENT_CHUNK_SIZE - 1)];
+}
+
+int  registry_init(int capacity);   // 세션 테이블 준비
+
+// 쓰기 (clients_mutex 필요)
+int  registry_insert(void);         // 빈 슬롯 + 새 ID (-1: 가득 참)
+void registry_publish(int index);   // 채워진 슬롯을 읽기 쪽에 공개
+void registry_remove(int index);    // 읽기 쪽에서 숨김 (자원 정리는 synchronize 후)
+int  registry_prepare_id(int index, int id);    // ID 변경 가능 확인 + 자리 확보 (-1: 사용 중/메모리 부족)
+int  registry_set_id(int index, int id);    // ID 변경 (-1: 다른 클라이언트가 사용 중)
+
+void registry_free(int index);      // 정리가 끝난 슬롯 반환 (lock 필요 없음)
+
+// 읽기 구간 (epoch 기반, lock 없음)
+void registry_read_lock(void);
+void registry_read_unlock(void);
+void registry_synchronize(void);    // 진행 중인 읽기 구간이 모두 끝날 때까지 대기
+
+// 읽기 (읽기 구간 안에서 호출)
+int  registry_find(int id);         // ID → 슬롯 (-1: 없음)
+int  registry_slots(void);          // 순회 범위 (0 ~ 반환값-1)
+int  registry_active(int index);    // 접속 중인 슬롯인지
+int  registry_count(void);          // 접속 중인 클라이언트 수
+
+void registry_set_name(int index, const char *name);    // 이름 변경 (메시지를 처리 중인 쓰레드만)
+void registry_get_name(int index, char *out);           // 다른 쓰레드에서 이름 읽기
+
+extern int server_socket;
+extern pthread_mutex_t clients_mutex;
+extern int io_mode;                 // 현재 I/O 모델 (IO_MODE_*)
+
+int  create_listen_socket(void);    // SO_REUSEPORT 리슨 소켓 생성
+int  add_client(int socket, struct sockaddr_in address, int shard);
+void remove_client(int index);
+
+// ================= 세션 처리 (I/O 모델 공통) =================
+
+int  client_send_buf(int index, msgbuf *buf);              // 공유 버퍼 전송 (복사 없음)
+int  client_send(int index, const char *msg, size_t len);  // 데이터를 복사해 전송
+int  client_send_room(int index);                          // 송신 대기열 여유 (메시지 수)
+void broadcast_message(msgbuf *message, int sender_id);    // 모든 클라이언트에게 (발신자 제외)
+void send_to_client(msgbuf *message, int target_id, int sender_id);  // ID로 한 명에게
+
+void client_on_connect(int index);                      // 환영 메시지, 입장 알림
+int  client_on_message(int index, char *buffer);        // 수신 메시지 처리 (-1: 연결 종료 요청)
+int  client_admit(int index, int rate_class);           // 속도 제한 확인 (0: 거절, 안내는 보냄)
+int  client_read(int index);                            // 소켓에서 읽어 메시지 처리 (thread/epoll)
+int  client_on_data(int index, char *data, size_t len); // 받은 데이터 처리 (io_uring)
+void client_on_disconnect(int index);                   // 퇴장 알림, 클라이언트 제거
+
+// ================= I/O 모델 =================
+
+int  run_epoll_server(int listen_fd, int nshards);      // epoll 샤드 실행 (반환하지 않음)
+int  epoll_send(int index, msgbuf *buf);                // 담당 샤드를 거쳐 전송
+void epoll_broadcast(msgbuf *buf, int sender_id);       // 샤드별 fanout
+
+int  uring_server_init(int listen_fd);                  // io_uring 준비 (-1: 사용 불가)
+void run_uring_server(void);                            // io_uring 리액터 실행 (반환하지 않음)
+int  uring_send(int index, msgbuf *buf);                // 전송 요청을 링에 추가 (다른 쓰레드면 링 쓰레드로 넘김)
+int  uring_broadcast(msgbuf *buf, int sender_id);       // 다른 쓰레드의 브로드캐스트를 링 쓰레드로 넘김 (-1: 링 쓰레드)
+int  uring_send_room(int index);                        // 송신 대기열 여유 (링 쓰레드가 아니면 0)
+
+#endif // SERVER_H
@@ -0,0 +1,530 @@
+// server_epoll.c - edge-triggered epoll 리액터 I/O 모델 (SO_REUSEPORT 샤드)
+//
+// 접속마다 쓰레드를 만드는 대신, 고정된 수의 샤드가 각자의 epoll 인스턴스로
+// 논블로킹 소켓들을 감시합니다.
+// - 샤드마다 SO_REUSEPORT 리슨 소켓을 따로 가짐 → 커널이 연결을 샤드에 분산
+// - 샤드 쓰레드는 CPU 코어 하나에 고정 (샤드 i → CPU i % 코어 수)
+// - accept한 소켓은 그 샤드가 끝까지 담당 (샤드별 멤버 배열)
+// - 다른 샤드의 클라이언트로 보내는 메시지(/msg, 브로드캐스트)는 그 샤드의
+//   메시지 큐(inbox)에 넣고 eventfd로 깨움. 브로드캐스트는 샤드당 한 번만 전달
+// - 클라이언트 소켓은 EPOLLET: 이벤트마다 EAGAIN이 날 때까지 읽어야 함
+// - 보낼 메시지는 클라이언트 송신 대기열에 넣고 바로 비워 보며, 소켓 버퍼가 가득 차면
+//   남은 것은 EPOLLOUT 이벤트 때 전송. 끊어야 하는 연결은 이벤트 배치 처리 후 정리
+// - 묶음 창(-b)을 쓰면 바로 비우지 않고 샤드의 묶음 전송 목록에 올린 뒤, 창이 끝나면
+//   writev 한 번으로 전송 (epoll_pwait2 대기 시간을 가장 이른 창 끝에 맞춤)
+// - 명령어 처리는 thread 모델과 동일한 client_on_* 함수 사용
+
+#include "server.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <stdint.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#define MAX_EVENTS      256                 // epoll_wait 한 번에 받을 최대 이벤트 수
+#define LISTEN_TAG      UINT64_MAX          // 리슨 소켓 이벤트 식별값
+#define WAKE_TAG        (UINT64_MAX - 1)    // inbox eventfd 이벤트 식별값
+
+// 샤드 간 메시지 종류
+#define SHARD_MSG_UNICAST   0               // 특정 클라이언트 하나에게
+#define SHARD_MSG_BROADCAST 1               // 샤드의 모든 클라이언트에게 (발신자 제외)
+#define SHARD_MSG_DRAINED   2               // 닫는 중인 클라이언트의 작업 풀 메시지가 모두 끝남
+
+// 샤드 간 메시지 (inbox 항목) - 데이터는 공유 버퍼 참조로 전달
+typedef struct shard_msg {
+    struct shard_msg *next;
+    int type;
+    int target;                 // UNICAST/DRAINED: 대상 클라이언트 인덱스
+    int target_id;              // UNICAST: 대상 클라이언트 ID (슬롯 재사용 확인용)
+    int exclude_id;             // BROADCAST: 제외할 발신자 ID
+    msgbuf *buf;                // 공유 메시지 버퍼 (참조 하나 보유, DRAINED면 NULL)
+} shard_msg;
+
+// 샤드 상태
+typedef struct {
+    int id;
+    int listen_fd;
+    int epfd;
+    int wake_fd;                // inbox 알림용 eventfd
+
+    // 다른 샤드가 넣는 메시지 큐 (여러 생산자, 소비자는 샤드 자신)
+    pthread_mutex_t inbox_mutex;
+    shard_msg *inbox_head, *inbox_tail;
+    int drained_head;           // 비움 알림을 할당하지 못한 연결 (client_info.drained_next로 연결, -1: 없음)
+
+    // 이 샤드가 담당하는 클라이언트 인덱스 (샤드 쓰레드만 수정)
+    int *members;
+    int nmembers;
+    int members_cap;            // members/close_list/batch_list 할당 크기
+
+    // 이벤트 배치 처리 후 끊을 클라이언트 (대기열 초과, 전송 오류)
+    int *close_list;
+    int nclose;
+
+    // 묶음 창이 끝나면 송신 대기열을 비울 클라이언트 (client_info.batched로 중복 방지)
+    int *batch_list;
+    int nbatch;
+} epoll_shard;
+
+static epoll_shard *shards;
+static int nshards;
+static __thread epoll_shard *current_shard;     // 현재 쓰레드가 실행 중인 샤드
+
+// 소켓을 논블로킹 모드로 설정
+static int set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0) return -1;
+    return fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+// epoll 이벤트 데이터: 상위 32비트 = 소켓, 하위 32비트 = 클라이언트 인덱스
+// 같은 epoll_wait 배치 안에서 슬롯이 재사용된 경우를 걸러내기 위해 소켓도 함께 저장
+static inline uint64_t make_tag(int fd, int index) {
+    return ((uint64_t)(uint32_t)fd << 32) | (uint32_t)index;
+}
+
+// ================= 샤드 멤버 관리 =================
+
+// 멤버 추가 - 배열이 가득 차면 두 배로 늘림 (종료 예약, 묶음 전송 목록도 같은 크기로)
+static int shard_add_member(epoll_shard *sh, int index) {
+    if (sh->nmembers == sh->members_cap) {
+        int cap = sh->members_cap ? sh->members_cap * 2 : CLIENT_CHUNK_SIZE;
+        stats_count(STAT_SESSION_ALLOCS, 1);
+        int *members = realloc(sh->members, cap * sizeof(int));
+        if (!members) return -1;
+        sh->members = members;
+        int *close_list = realloc(sh->close_list, cap * sizeof(int));
+        if (!close_list) return -1;
+        sh->close_list = close_list;
+        int *batch_list = realloc(sh->batch_list, cap * sizeof(int));
+        if (!batch_list) return -1;
+        sh->batch_list = batch_list;
+        sh->members_cap = cap;
+    }
+    client_at(index)->shard_slot = sh->nmembers;     // shard는 add_client가 공개 전에 채움
+    sh->members[sh->nmembers++] = index;
+    return 0;
+}
+
+// 마지막 멤버를 빈 자리로 옮겨 O(1) 제거
+static void shard_remove_member(epoll_shard *sh, int index) {
+    int slot = client_at(index)->shard_slot;
+    int last = sh->members[--sh->nmembers];
+    sh->members[slot] = last;
+    client_at(last)->shard_slot = slot;
+}
+
+// ================= 샤드 간 메시지 큐 =================
+
+static shard_msg *shard_msg_new(int type, msgbuf *buf) {
+    shard_msg *m = malloc(sizeof(shard_msg));
+    if (!m) return NULL;
+    m->next = NULL;
+    m->type = type;
+    m->buf = buf ? msgbuf_get(buf) : NULL;
+    return m;
+}
+
+// inbox와 비움 대체 목록이 모두 비어 있는지 (inbox_mutex 필요)
+static int shard_inbox_empty(epoll_shard *sh) {
+    return sh->inbox_head == NULL && sh->drained_head < 0;
+}
+
+static void shard_wake(epoll_shard *sh) {
+    uint64_t one = 1;
+    if (write(sh->wake_fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+        log_printf(LOG_ERROR, "샤드 깨우기 실패: %m");
+    }
+}
+
+// 대상 샤드의 inbox에 메시지 추가, 큐가 비어 있었을 때만 eventfd로 깨움
+static void shard_post(epoll_shard *sh, shard_msg *m) {
+    pthread_mutex_lock(&sh->inbox_mutex);
+    int was_empty = shard_inbox_empty(sh);
+    if (sh->inbox_tail) sh->inbox_tail->next = m;
+    else sh->inbox_head = m;
+    sh->inbox_tail = m;
+    pthread_mutex_unlock(&sh->inbox_mutex);
+
+    if (was_empty) shard_wake(sh);
+}
+
+// 메시지를 할당하지 못한 비움 알림 - 슬롯 자체로 연결해 두고 깨움 (할당 없이 항상 성공)
+static void shard_post_drained(epoll_shard *sh, int index) {
+    pthread_mutex_lock(&sh->inbox_mutex);
+    int was_empty = shard_inbox_empty(sh);
+    client_at(index)->drained_next = sh->drained_head;
+    sh->drained_head = index;
+    pthread_mutex_unlock(&sh->inbox_mutex);
+
+    if (was_empty) shard_wake(sh);
+}
+
+// 연결 종료 예약 - 멤버 배열을 순회하는 중일 수 있으므로 배치 처리 후 정리
+static void shard_schedule_close(epoll_shard *sh, int index) {
+    if (client_at(index)->closing) return;
+    client_at(index)->closing = 1;
+    sh->close_list[sh->nclose++] = index;
+}
+
+// 이 샤드의 클라이언트에게 전송: 송신 대기열에 넣고 소켓 버퍼가 허용하는 만큼 바로 전송
+// 묶음 창 중이면 묶음 전송 목록에만 올려 두고 창이 끝날 때 한 번에 전송
+static void shard_deliver(epoll_shard *sh, int index, msgbuf *buf) {
+    client_info *c = client_at(index);
+    if (c->closing) {
+        outq_push(&c->out, buf, NULL);      // 정리를 미룬 동안의 응답 - 정리할 때 한 번 더 전송
+        return;
+    }
+
+    int ret = outq_push(&c->out, buf, NULL);
+    if (ret == OUTQ_OVERFLOW) {
+        shard_schedule_close(sh, index);
+        return;
+    }
+    if (outq_batch_usec && outq_batch_wait(&c->out) > 0) {
+        if (!c->batched) {
+            c->batched = 1;
+            sh->batch_list[sh->nbatch++] = index;
+        }
+        return;
+    }
+    if (outq_flush(&c->out, c->socket) < 0) shard_schedule_close(sh, index);
+}
+
+// 묶음 창이 끝난 클라이언트의 송신 대기열 전송
+// 반환값: 남은 클라이언트 중 가장 이른 창 끝까지 남은 시간 (us, 남은 것이 없으면 -1)
+static long shard_flush_batched(epoll_shard *sh) {
+    long next = -1;
+    for (int i = 0; i < sh->nbatch; ) {
+        int index = sh->batch_list[i];
+        client_info *c = client_at(index);
+        long wait = outq_batch_wait(&c->out);
+        if (wait > 0) {
+            if (next < 0 || wait < next) next = wait;
+            i++;
+            continue;
+        }
+        sh->batch_list[i] = sh->batch_list[--sh->nbatch];
+        c->batched = 0;
+        if (wait == 0 && outq_flush(&c->out, c->socket) < 0) shard_schedule_close(sh, index);
+    }
+    return next;
+}
+
+// 끊는 클라이언트를 묶음 전송 목록에서 제거 (슬롯이 다른 샤드에서 재사용될 수 있음)
+static void shard_unbatch(epoll_shard *sh, int index) {
+    if (!client_at(index)->batched) return;
+    client_at(index)->batched = 0;
+    for (int i = 0; i < sh->nbatch; i++) {
+        if (sh->batch_list[i] == index) {
+            sh->batch_list[i] = sh->batch_list[--sh->nbatch];
+            return;
+        }
+    }
+}
+
+// 이 샤드의 클라이언트들에게 fanout (발신자 제외)
+static void shard_fanout(epoll_shard *sh, msgbuf *buf, int exclude_id) {
+    for (int i = 0; i < sh->nmembers; i++) {
+        int index = sh->members[i];
+        if (client_at(index)->id == exclude_id) continue;
+        shard_deliver(sh, index, buf);
+    }
+}
+
+// 정리를 미뤄 둔 연결 - 그동안 쌓인 응답을 보내고 퇴장 알림과 제거
+static void shard_finish_drained(int index) {
+    client_info *c = client_at(index);
+    outq_flush(&c->out, c->socket);
+    client_on_disconnect(index);
+}
+
+// inbox를 통째로 가져와 처리
+static void shard_drain_inbox(epoll_shard *sh) {
+    uint64_t count;
+    if (read(sh->wake_fd, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+        log_printf(LOG_ERROR, "eventfd 읽기 실패: %m");
+    }
+
+    pthread_mutex_lock(&sh->inbox_mutex);
+    shard_msg *m = sh->inbox_head;
+    sh->inbox_head = sh->inbox_tail = NULL;
+    int drained = sh->drained_head;
+    sh->drained_head = -1;
+    pthread_mutex_unlock(&sh->inbox_mutex);
+
+    while (drained >= 0) {
+        int next = client_at(drained)->drained_next;
+        shard_finish_drained(drained);
+        drained = next;
+    }
+
+    while (m) {
+        shard_msg *next = m->next;
+        if (m->type == SHARD_MSG_BROADCAST) {
+            shard_fanout(sh, m->buf, m->exclude_id);
+        } else if (m->type == SHARD_MSG_DRAINED) {
+            shard_finish_drained(m->target);
+        } else {
+            client_info *c = client_at(m->target);
+            // 그 사이 연결이 끊겼거나 슬롯이 재사용됐으면 버림 (ID는 재사용되지 않음)
+            if (c->active && c->id == m->target_id && c->shard == sh->id) {
+                shard_deliver(sh, m->target, m->buf);
+            }
+        }
+        if (m->buf) msgbuf_put(m->buf);
+        free(m);
+        m = next;
+    }
+}
+
+/**
+ * epoll_send - 클라이언트에게 전송 (담당 샤드 경유)
+ * @index: 대상 클라이언트 인덱스
+ * @buf: 보낼 공유 버퍼
+ * @return: 송신 대기열에 넣었거나 다른 샤드로 넘긴 경우 0, 실패 시 -1
+ */
+int epoll_send(int index, msgbuf *buf) {
+    client_info *c = client_at(index);
+    if (current_shard && c->shard == current_shard->id) {
+        shard_deliver(current_shard, index, buf);
+        return 0;
+    }
+
+    shard_msg *m = shard_msg_new(SHARD_MSG_UNICAST, buf);
+    if (!m) return -1;
+    m->target = index;
+    m->target_id = c->id;
+    shard_post(&shards[c->shard], m);
+    return 0;
+}
+
+/**
+ * epoll_broadcast - 모든 샤드의 클라이언트에게 브로드캐스트
+ * @buf: 보낼 공유 버퍼
+ * @sender_id: 제외할 발신자 ID (-1이면 모두에게)
+ *
+ * 현재 샤드는 바로 fanout하고, 다른 샤드에는 버퍼 참조를 하나씩만 넘깁니다.
+ */
+void epoll_broadcast(msgbuf *buf, int sender_id) {
+    for (int i = 0; i < nshards; i++) {
+        if (&shards[i] == current_shard) {
+            shard_fanout(current_shard, buf, sender_id);
+            continue;
+        }
+        shard_msg *m = shard_msg_new(SHARD_MSG_BROADCAST, buf);
+        if (!m) continue;
+        m->exclude_id = sender_id;
+        shard_post(&shards[i], m);
+    }
+}
+
+// ================= 이벤트 처리 =================
+
+// 리슨 소켓에 쌓인 연결을 모두 accept
+static void accept_pending(epoll_shard *sh) {
+    while (1) {
+        struct sockaddr_in client_addr;
+        socklen_t client_len = sizeof(client_addr);
+        int client_socket = accept4(sh->listen_fd, (struct sockaddr *)&client_addr, &client_len,
+                                    SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (client_socket < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                log_printf(LOG_WARN, "클라이언트 연결 수락 실패: %m");
+            }
+            return;
+        }
+
+        int index = add_client(client_socket, client_addr, sh->id);
+        if (index < 0) {
+            log_printf(LOG_WARN, "최대 클라이언트 수에 도달했습니다.");
+            char full_msg[] = "서버가 가득 찼습니다. 나중에 다시 시도해주세요.\n";
+            send(client_socket, full_msg, strlen(full_msg), MSG_DONTWAIT | MSG_NOSIGNAL);
+            close(client_socket);
+            continue;
+        }
+
+        struct epoll_event ev;
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        ev.data.u64 = make_tag(client_socket, index);
+        if (epoll_ctl(sh->epfd, EPOLL_CTL_ADD, client_socket, &ev) < 0) {
+            log_printf(LOG_ERROR, "epoll_ctl 실패: %m");
+            remove_client(index);
+            continue;
+        }
+
+        if (shard_add_member(sh, index) < 0) {
+            log_printf(LOG_ERROR, "샤드 멤버 추가 실패: %m");
+            epoll_ctl(sh->epfd, EPOLL_CTL_DEL, client_socket, NULL);
+            remove_client(index);
+            continue;
+        }
+        client_on_connect(index);
+    }
+}
+
+// 닫는 중인 클라이언트의 마지막 작업 풀 메시지가 끝남 (작업 쓰레드) - 담당 샤드에 알림
+// 연결은 그 샤드가 알림을 처리할 때 정리하므로 그때까지 슬롯과 shard 값은 그대로
+static void shard_strand_drained(int index) {
+    epoll_shard *sh = &shards[client_at(index)->shard];
+    shard_msg *m = shard_msg_new(SHARD_MSG_DRAINED, NULL);
+    if (!m) {
+        log_printf(LOG_WARN, "[클라이언트 %d] 정리 알림 할당 실패 - 대체 목록으로 전달", client_at(index)->id);
+        shard_post_drained(sh, index);
+        return;
+    }
+    m->target = index;
+    shard_post(sh, m);
+}
+
+// 종료 예약된 연결 정리 (퇴장 알림 중에 새로 예약된 것도 포함)
+static void shard_close_pending(epoll_shard *sh) {
+    while (sh->nclose > 0) {
+        int index = sh->close_list[--sh->nclose];
+        client_info *c = client_at(index);
+        if (!c->active || !c->closing) continue;
+
+        outq_flush(&c->out, c->socket);         // /quit 응답 등 남은 메시지를 가능한 만큼 전송
+        epoll_ctl(sh->epfd, EPOLL_CTL_DEL, c->socket, NULL);
+        shard_unbatch(sh, index);
+        shard_remove_member(sh, index);
+        // 작업 풀에 넘긴 메시지가 남아 있으면 기다리지 않고 비움 알림(inbox)을 받은 뒤 정리
+        if (strand_close(&c->strand, shard_strand_drained, index)) continue;
+        client_on_disconnect(index);
+    }
+}
+
+// 샤드 쓰레드를 CPU 코어 하나에 고정
+static void pin_to_cpu(int shard_id) {
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    if (ncpu < 1) return;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(shard_id % ncpu, &set);
+    int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (err != 0) {
+        log_printf(LOG_WARN, "샤드 %d CPU 고정 실패: %s", shard_id, strerror(err));
+    }
+}
+
+// 샤드 쓰레드 메인 루프
+static void *shard_loop(void *arg) {
+    epoll_shard *sh = (epoll_shard *)arg;
+    struct epoll_event events[MAX_EVENTS];
+
+    current_shard = sh;
+    if (nshards > 1) pin_to_cpu(sh->id);
+
+    while (1) {
+        // 묶음 창이 끝난 전송을 먼저 하고, 남은 창 중 가장 이른 끝까지만 기다림
+        long wait = shard_flush_batched(sh);
+        struct timespec ts = { wait / 1000000, (wait % 1000000) * 1000 };
+        int n = epoll_pwait2(sh->epfd, events, MAX_EVENTS, wait >= 0 ? &ts : NULL, NULL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            log_printf(LOG_ERROR, "epoll_wait 실패: %m");
+            break;
+        }
+
+        for (int i = 0; i < n; i++) {
+            uint64_t tag = events[i].data.u64;
+            if (tag == LISTEN_TAG) {
+                accept_pending(sh);
+                continue;
+            }
+            if (tag == WAKE_TAG) {
+                shard_drain_inbox(sh);
+                continue;
+            }
+
+            int fd = (int)(tag >> 32);
+            int index = (int)(uint32_t)tag;
+            client_info *c = client_at(index);
+            if (!c->active || c->socket != fd || c->closing) continue;     // 이미 정리된 연결
+
+            int closing = (events[i].events & (EPOLLERR | EPOLLHUP)) != 0;
+            if (!closing && (events[i].events & EPOLLOUT) && !c->batched) {
+                closing = outq_flush(&c->out, fd) < 0;             // 쓰기 가능 - 대기열 전송 (묶음 창 중이면 창 끝에)
+            }
+            if (!closing && (events[i].events & (EPOLLIN | EPOLLRDHUP))) {
+                closing = client_read(index) < 0;          // EAGAIN까지 읽고 메시지 처리
+            }
+            if (closing) shard_schedule_close(sh, index);
+        }
+
+        shard_close_pending(sh);
+    }
+
+    return NULL;
+}
+
+// 샤드 하나 준비: 리슨 소켓, epoll, eventfd
+static int shard_init(epoll_shard *sh, int id, int listen_fd) {
+    sh->id = id;
+    sh->listen_fd = listen_fd;
+    pthread_mutex_init(&sh->inbox_mutex, NULL);
+    sh->drained_head = -1;
+
+    if (set_nonblocking(listen_fd) < 0) {
+        perror("논블로킹 설정 실패");
+        return -1;
+    }
+
+    sh->epfd = epoll_create1(EPOLL_CLOEXEC);
+    sh->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (sh->epfd < 0 || sh->wake_fd < 0) {
+        perror("epoll/eventfd 생성 실패");
+        return -1;
+    }
+
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.u64 = LISTEN_TAG;
+    if (epoll_ctl(sh->epfd, EPOLL_CTL_ADD, listen_fd, &ev) < 0) {
+        perror("리슨 소켓 epoll 등록 실패");
+        return -1;
+    }
+    ev.events = EPOLLIN;
+    ev.data.u64 = WAKE_TAG;
+    if (epoll_ctl(sh->epfd, EPOLL_CTL_ADD, sh->wake_fd, &ev) < 0) {
+        perror("eventfd epoll 등록 실패");
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * run_epoll_server - epoll 샤드 I/O 모델 실행
+ * @listen_fd: bind/listen이 끝난 서버 소켓 (0번 샤드가 사용)
+ * @n: 샤드 수 (1이면 단일 쓰레드)
+ *
+ * 1번 이후 샤드는 SO_REUSEPORT로 같은 포트에 리슨 소켓을 새로 만들고
+ * 각자의 쓰레드에서 실행됩니다. 0번 샤드는 호출한 쓰레드가 직접 실행합니다.
+ */
+int run_epoll_server(int listen_fd, int n) {
+    shards = calloc(n, sizeof(epoll_shard));
+    if (!shards) return -1;
+    nshards = n;
+
+    for (int i = 0; i < n; i++) {
+        int fd = (i == 0) ? listen_fd : create_listen_socket();
+        if (fd < 0 || shard_init(&shards[i], i, fd) < 0) {
+            exit(1);
+        }
+    }
+
+    for (int i = 1; i < n; i++) {
+        pthread_t tid;
+        if (pthread_create(&tid, NULL, shard_loop, &shards[i]) != 0) {
+            perror("샤드 쓰레드 생성 실패");
+            exit(1);
+        }
+        pthread_detach(tid);
+    }
+    shard_loop(&shards[0]);
+    return 0;
+}
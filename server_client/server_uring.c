@@ -0,0 +1,629 @@
+// server_uring.c - io_uring 리액터 I/O 모델
+//
+// accept/recv/send를 모두 io_uring 요청으로 처리하여 시스템 콜 수를 줄입니다.
+// liburing 없이 커널 uAPI(<linux/io_uring.h>)를 직접 사용합니다.
+//
+// 구성:
+// - 멀티샷 accept : 요청 하나로 들어오는 모든 연결을 수락
+// - 멀티샷 recv   : 제공 버퍼 링(provided buffer ring)에서 커널이 버퍼를 골라 채움
+// - 묶음 sendmsg  : 한 연결의 송신 대기열(outq)에 쌓인 메시지들을 iovec으로 모아
+//                   sendmsg 요청 하나로 전송 (연결당 요청은 한 번에 하나 → 순서 유지)
+// - 묶음 창       : 창(-b)이 끝나지 않은 연결은 flush 목록에 남겨 두고 타이머 요청으로 깨어남
+// - 일괄 제출     : 이벤트 처리 중 쌓인 요청(브로드캐스트 fanout 포함)을
+//                   루프당 io_uring_enter 한 번으로 제출
+// - 다른 쓰레드   : 작업 풀 쓰레드의 전송/브로드캐스트는 post 목록에 넣고 eventfd로 링 쓰레드를
+//                   깨움 (eventfd 읽기도 링 요청이므로 완료 대기 중에 함께 깨어남)
+//
+// 링 초기화나 버퍼 링 등록이 실패하면 uring_server_init이 -1을 반환하고
+// main에서 epoll 모델로 대체합니다.
+
+#include "server.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+#define URING_ENTRIES       4096                // SQ 크기 (CQ는 커널이 2배로 설정)
+#define URING_BGID          1                   // 제공 버퍼 그룹 ID
+#define URING_NBUFS         1024                // 제공 버퍼 개수 (2의 거듭제곱)
+#define URING_BUF_SIZE      BUFFER_SIZE         // 버퍼 하나 크기 (마지막 1바이트는 NULL용)
+
+// user_data 하위 비트로 요청 종류 구분 (포인터는 8바이트 정렬)
+#define OP_ACCEPT   0
+#define OP_RECV     1
+#define OP_SEND     2
+#define OP_WAKE     3
+#define OP_TIMER    4
+#define OP_MASK     7ULL
+
+typedef struct uring_conn uring_conn;
+
+// 연결 하나의 io_uring 상태
+struct uring_conn {
+    int fd;
+    int index;                  // 세션 테이블 슬롯 인덱스
+    int refs;                   // 참조 수 (연결 자체 + recv + 제출된 send + flush 목록)
+    int closing;                // 연결 종료 진행 중
+    int send_failed;            // send 오류 발생 - 이후 전송은 버림
+    int multishot;              // 멀티샷 recv 사용 여부 (미지원 커널이면 0)
+    int inflight;               // 제출된 sendmsg가 있음
+    int on_flush_list;
+    int on_close_list;
+    outq q;                     // 송신 대기열 (연결 상태와 수명이 같음)
+    struct msghdr msg;          // 제출된 sendmsg (완료될 때까지 커널이 참조)
+    struct iovec iov[OUTQ_IOV_MAX];
+    outq_msg *batch[OUTQ_IOV_MAX];      // sendmsg에 담은 메시지
+    int nbatch;
+    uring_conn *flush_next;
+    uring_conn *close_next;
+};
+
+// 링 상태 (단일 쓰레드에서만 접근)
+static struct {
+    int fd;
+    unsigned *sq_head, *sq_tail, sq_mask, sq_entries;
+    unsigned *cq_head, *cq_tail, cq_mask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    unsigned sq_local_tail;     // 아직 커널에 알리지 않은 SQ tail
+    unsigned to_submit;
+
+    struct io_uring_buf_ring *br;
+    char *bufs;
+    unsigned br_tail;
+
+    int listen_fd;
+} ring;
+
+static uring_conn *flush_list;                  // 전송할 메시지가 쌓인 연결 목록
+static uring_conn *close_list;                  // 완료 배치 처리 후 끊을 연결 (대기열 초과)
+static uring_conn *conn_cache;                  // 해제한 연결 상태 (재접속 때 재사용, flush_next로 연결)
+static struct __kernel_timespec batch_timer;    // 묶음 창 타이머 (제출 후 완료까지 커널이 참조)
+static int timer_armed;
+
+// 다른 쓰레드(작업 풀)에서 보낸 전송 - 링 쓰레드가 깨어나 처리
+typedef struct uring_post {
+    struct uring_post *next;
+    int target;                 // 슬롯 인덱스 (-1: 브로드캐스트)
+    int target_id;              // 슬롯 재사용 확인용 ID (브로드캐스트면 제외할 발신자 ID)
+    msgbuf *buf;                // 참조 하나 보유 (NULL: 닫는 중인 연결의 작업 풀 메시지가 모두 끝남)
+} uring_post;
+
+static pthread_mutex_t post_lock = PTHREAD_MUTEX_INITIALIZER;
+static uring_post *post_head, *post_tail;
+static int wake_fd = -1;
+static uint64_t wake_count;                     // eventfd 읽기 버퍼
+static __thread int on_ring_thread;             // 링 쓰레드인지
+
+static void conn_put(uring_conn *conn);
+static void drain_posts(void);
+static int post_to_ring(int target, int target_id, msgbuf *buf);
+
+// ================= 링 기본 연산 =================
+
+static int sys_io_uring_setup(unsigned entries, struct io_uring_params *p) {
+    return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+static int sys_io_uring_register(int fd, unsigned opcode, void *arg, unsigned nr_args) {
+    return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+// 쌓인 SQE를 제출하고 wait_nr개 이상의 완료를 기다림
+static int ring_submit(unsigned wait_nr) {
+    __atomic_store_n(ring.sq_tail, ring.sq_local_tail, __ATOMIC_RELEASE);
+    unsigned flags = wait_nr ? IORING_ENTER_GETEVENTS : 0;
+    while (1) {
+        int ret = sys_io_uring_enter(ring.fd, ring.to_submit, wait_nr, flags);
+        if (ret >= 0) {
+            ring.to_submit -= (unsigned)ret < ring.to_submit ? (unsigned)ret : ring.to_submit;
+            return ret;
+        }
+        if (errno != EINTR) return -1;
+    }
+}
+
+// SQ 빈 슬롯 수
+static unsigned ring_sq_space(void) {
+    unsigned head = __atomic_load_n(ring.sq_head, __ATOMIC_ACQUIRE);
+    return ring.sq_entries - (ring.sq_local_tail - head);
+}
+
+// 빈 SQE 하나 확보 (SQ가 가득 차면 먼저 제출)
+static struct io_uring_sqe *ring_get_sqe(void) {
+    while (ring_sq_space() == 0) {
+        ring_submit(0);
+    }
+    struct io_uring_sqe *sqe = &ring.sqes[ring.sq_local_tail & ring.sq_mask];
+    memset(sqe, 0, sizeof(*sqe));
+    ring.sq_local_tail++;
+    ring.to_submit++;
+    return sqe;
+}
+
+// 제공 버퍼를 버퍼 링에 반환
+static void ring_recycle_buffer(unsigned bid) {
+    struct io_uring_buf *buf = &ring.br->bufs[ring.br_tail & (URING_NBUFS - 1)];
+    buf->addr = (uint64_t)(uintptr_t)(ring.bufs + (size_t)bid * URING_BUF_SIZE);
+    buf->len = URING_BUF_SIZE - 1;
+    buf->bid = (uint16_t)bid;
+    ring.br_tail++;
+    __atomic_store_n(&ring.br->tail, (uint16_t)ring.br_tail, __ATOMIC_RELEASE);
+}
+
+// ================= 요청 준비 =================
+
+static void arm_accept(void) {
+    struct io_uring_sqe *sqe = ring_get_sqe();
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = ring.listen_fd;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->user_data = OP_ACCEPT;
+}
+
+static void arm_recv(uring_conn *conn) {
+    struct io_uring_sqe *sqe = ring_get_sqe();
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = conn->fd;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = URING_BGID;
+    if (conn->multishot) {
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+    } else {
+        sqe->len = URING_BUF_SIZE - 1;
+    }
+    sqe->user_data = (uint64_t)(uintptr_t)conn | OP_RECV;
+    conn->refs++;
+}
+
+static void arm_wake(void) {
+    struct io_uring_sqe *sqe = ring_get_sqe();
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = wake_fd;
+    sqe->addr = (uint64_t)(uintptr_t)&wake_count;
+    sqe->len = sizeof(wake_count);
+    sqe->user_data = OP_WAKE;
+}
+
+// 묶음 창 타이머 등록 (이미 있으면 그대로 - 먼저 등록한 타이머의 창이 먼저 끝남)
+static void arm_timer(long usec) {
+    if (timer_armed) return;
+    timer_armed = 1;
+    batch_timer.tv_sec = usec / 1000000;
+    batch_timer.tv_nsec = (usec % 1000000) * 1000;
+    struct io_uring_sqe *sqe = ring_get_sqe();
+    sqe->opcode = IORING_OP_TIMEOUT;
+    sqe->fd = -1;
+    sqe->addr = (uint64_t)(uintptr_t)&batch_timer;
+    sqe->len = 1;
+    sqe->user_data = OP_TIMER;
+}
+
+// 연결의 송신 대기열 앞부분을 sendmsg 하나로 제출
+// 연결당 요청을 하나씩만 두므로 짧게 끝나도 남은 부분을 다음 요청이 이어서 보냄
+static void flush_conn(uring_conn *conn) {
+    if (conn->closing || conn->inflight) return;        // 진행 중인 요청이 끝나면 다시 시도
+
+    int n = outq_gather(&conn->q, conn->iov, conn->batch, OUTQ_IOV_MAX);
+    if (n == 0) return;
+    conn->nbatch = n;
+    memset(&conn->msg, 0, sizeof(conn->msg));
+    conn->msg.msg_iov = conn->iov;
+    conn->msg.msg_iovlen = (size_t)n;
+
+    struct io_uring_sqe *sqe = ring_get_sqe();
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = conn->fd;
+    sqe->addr = (uint64_t)(uintptr_t)&conn->msg;
+    sqe->len = 1;
+    sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+    if (outq_cork && conn->q.depth > (unsigned)n) sqe->msg_flags |= MSG_MORE;
+    sqe->user_data = (uint64_t)(uintptr_t)conn | OP_SEND;
+    conn->inflight = 1;
+    conn->refs++;
+}
+
+static void mark_flush(uring_conn *conn) {
+    if (conn->on_flush_list) return;
+    conn->on_flush_list = 1;
+    conn->refs++;                       // 목록에 있는 동안 해제되지 않도록
+    conn->flush_next = flush_list;
+    flush_list = conn;
+}
+
+// flush 목록의 연결 제출 - 묶음 창이 남은 연결은 목록에 그대로 두고 타이머를 등록
+static void flush_all(void) {
+    uring_conn *later = NULL;
+    long next = -1;
+    while (flush_list) {
+        uring_conn *conn = flush_list;
+        flush_list = conn->flush_next;
+        long wait = conn->closing ? 0 : outq_batch_wait(&conn->q);
+        if (wait > 0) {
+            conn->flush_next = later;
+            later = conn;
+            if (next < 0 || wait < next) next = wait;
+            continue;
+        }
+        conn->on_flush_list = 0;
+        flush_conn(conn);
+        conn_put(conn);
+    }
+    flush_list = later;
+    if (next > 0) arm_timer(next);
+}
+
+// ================= 연결 관리 =================
+
+// 완료 대기 중인 요청이 없으면 연결 상태 해제
+// 연결 상태는 free하지 않고 캐시에 넣어 다음 연결이 재사용 (링 쓰레드만 쓰므로 lock 없음)
+static void conn_put(uring_conn *conn) {
+    if (--conn->refs > 0 || !conn->closing) return;
+    outq_destroy(&conn->q);
+    conn->flush_next = conn_cache;
+    conn_cache = conn;
+}
+
+static uring_conn *conn_alloc(void) {
+    uring_conn *conn = conn_cache;
+    if (conn) {
+        conn_cache = conn->flush_next;
+        memset(conn, 0, sizeof(uring_conn));
+        return conn;
+    }
+    stats_count(STAT_SESSION_ALLOCS, 1);
+    return calloc(1, sizeof(uring_conn));
+}
+
+// 연결 정리 마무리 - 퇴장 알림, 클라이언트 제거, 연결 자체의 참조 해제
+static void conn_finish(uring_conn *conn) {
+    client_at(conn->index)->io_conn = NULL;
+    client_on_disconnect(conn->index);  // 퇴장 알림 + 소켓 close
+    conn_put(conn);
+}
+
+// 닫는 중인 연결의 마지막 작업 풀 메시지가 끝남 (작업 쓰레드) - 링 쓰레드에 알림
+// 그 전에 작업 쓰레드가 넘긴 전송은 post 목록에서 이 알림보다 앞에 있음
+static void conn_strand_drained(int index) {
+    if (post_to_ring(index, client_at(index)->id, NULL) < 0) {
+        log_printf(LOG_ERROR, "[클라이언트 %d] 정리 알림 실패 - 연결 슬롯을 회수하지 못함", client_at(index)->id);
+    }
+}
+
+// 연결 종료 시작 - shutdown으로 남은 recv/send 요청을 끝내게 하고 클라이언트 정리
+// 작업 풀에 넘긴 메시지가 남아 있으면 링 쓰레드를 멈추지 않고 비움 알림을 받은 뒤 마무리
+static void conn_close(uring_conn *conn) {
+    if (conn->closing) return;
+    conn->closing = 1;
+    shutdown(conn->fd, SHUT_RDWR);
+    // 작업 풀이 이 연결의 메시지로 넘긴 브로드캐스트(/quit 앞의 /all 등)를 퇴장 알림보다 먼저 보냄
+    // (같은 완료 배치에서 recv 종료가 eventfd 읽기보다 먼저 처리될 수 있음)
+    drain_posts();
+    if (strand_close(&client_at(conn->index)->strand, conn_strand_drained, conn->index)) return;
+    conn_finish(conn);
+}
+
+// 연결 종료 예약 - 다른 클라이언트 처리 중(브로드캐스트 등)일 수 있으므로 배치 처리 후 정리
+static void schedule_close(uring_conn *conn) {
+    if (conn->on_close_list || conn->closing) return;
+    conn->on_close_list = 1;          // closing 전이므로 연결 자체의 참조가 남아 있음
+    conn->close_next = close_list;
+    close_list = conn;
+}
+
+static void close_pending(void) {
+    while (close_list) {
+        uring_conn *conn = close_list;
+        close_list = conn->close_next;
+        conn->on_close_list = 0;
+        conn_close(conn);
+    }
+}
+
+static void handle_accept(struct io_uring_cqe *cqe) {
+    if (!(cqe->flags & IORING_CQE_F_MORE)) arm_accept();   // 멀티샷이 끝났으면 다시 등록
+
+    if (cqe->res < 0) {
+        errno = -cqe->res;
+        log_printf(LOG_WARN, "클라이언트 연결 수락 실패: %m");
+        return;
+    }
+
+    int client_socket = cqe->res;
+    struct sockaddr_in client_addr;
+    socklen_t client_len = sizeof(client_addr);
+    memset(&client_addr, 0, sizeof(client_addr));
+    getpeername(client_socket, (struct sockaddr *)&client_addr, &client_len);
+
+    int index = add_client(client_socket, client_addr, 0);
+    if (index < 0) {
+        log_printf(LOG_WARN, "최대 클라이언트 수에 도달했습니다.");
+        char full_msg[] = "서버가 가득 찼습니다. 나중에 다시 시도해주세요.\n";
+        send(client_socket, full_msg, strlen(full_msg), MSG_DONTWAIT | MSG_NOSIGNAL);
+        close(client_socket);
+        return;
+    }
+
+    uring_conn *conn = conn_alloc();
+    if (!conn) {
+        remove_client(index);
+        return;
+    }
+    conn->fd = client_socket;
+    conn->index = index;
+    conn->multishot = 1;
+    conn->refs = 1;                     // 연결 자체의 참조 (conn_close 후 해제)
+    outq_init(&conn->q);
+    client_at(index)->io_conn = conn;
+
+    arm_recv(conn);
+    client_on_connect(index);
+}
+
+static void handle_recv(uring_conn *conn, struct io_uring_cqe *cqe) {
+    int more = (cqe->flags & IORING_CQE_F_MORE) != 0;
+
+    if (cqe->res > 0 && (cqe->flags & IORING_CQE_F_BUFFER)) {
+        unsigned bid = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+        char *buffer = ring.bufs + (size_t)bid * URING_BUF_SIZE;
+        // 버퍼 안에서 바로 메시지를 꺼내고, 잘린 메시지만 연결의 수신 링에 보관
+        if (!conn->closing && client_on_data(conn->index, buffer, (size_t)cqe->res) < 0) {
+            conn_close(conn);
+        }
+        ring_recycle_buffer(bid);
+    } else if (cqe->res == -ENOBUFS) {
+        // 버퍼가 모두 사용 중 - 재등록만 하면 됨
+    } else if (cqe->res == -EINVAL && conn->multishot) {
+        conn->multishot = 0;            // 멀티샷 recv 미지원 커널 - 단발 recv로 전환
+    } else if (!conn->closing) {
+        conn_close(conn);               // 연결 종료(0) 또는 수신 오류
+    }
+
+    if (!more) {
+        if (!conn->closing) arm_recv(conn);
+        conn_put(conn);
+    }
+}
+
+static void handle_send(uring_conn *conn, struct io_uring_cqe *cqe) {
+    conn->inflight = 0;
+    // 보낸 만큼 완료 처리 (일부만 보냈으면 나머지는 다음 요청에서)
+    outq_advance(&conn->q, conn->batch, conn->nbatch, cqe->res);
+    if (cqe->res < 0) conn->send_failed = 1;    // 전송 오류 - 이 연결의 나머지 전송은 버림
+
+    if (outq_pending(&conn->q) && !conn->closing && !conn->send_failed) {
+        mark_flush(conn);
+    }
+    conn_put(conn);
+}
+
+// ================= 다른 쓰레드에서 전송 =================
+
+// post 목록에 추가하고, 비어 있었으면 링 쓰레드를 깨움
+static int post_to_ring(int target, int target_id, msgbuf *buf) {
+    uring_post *p = malloc(sizeof(uring_post));
+    if (!p) return -1;
+    p->next = NULL;
+    p->target = target;
+    p->target_id = target_id;
+    p->buf = buf ? msgbuf_get(buf) : NULL;
+
+    pthread_mutex_lock(&post_lock);
+    int was_empty = (post_head == NULL);
+    if (post_tail) post_tail->next = p;
+    else post_head = p;
+    post_tail = p;
+    pthread_mutex_unlock(&post_lock);
+
+    if (was_empty) {
+        uint64_t one = 1;
+        if (write(wake_fd, &one, sizeof(one)) < 0) {
+            log_printf(LOG_ERROR, "링 쓰레드 깨우기 실패: %m");
+        }
+    }
+    return 0;
+}
+
+// 쌓인 post를 통째로 가져와 처리 (링 쓰레드)
+// 연결 정리와 슬롯 재사용은 링 쓰레드에서만 일어나므로 여기서 본 슬롯 상태는 바뀌지 않음
+static void drain_posts(void) {
+    pthread_mutex_lock(&post_lock);
+    uring_post *p = post_head;
+    post_head = post_tail = NULL;
+    pthread_mutex_unlock(&post_lock);
+
+    while (p) {
+        uring_post *next = p->next;
+        if (!p->buf) {
+            uring_conn *conn = client_at(p->target)->io_conn;
+            if (conn) conn_finish(conn);        // 정리를 미뤄 둔 연결
+        } else if (p->target < 0) {
+            broadcast_message(p->buf, p->target_id);
+        } else if (registry_active(p->target) && client_at(p->target)->id == p->target_id) {
+            uring_send(p->target, p->buf);
+        }
+        if (p->buf) msgbuf_put(p->buf);
+        free(p);
+        p = next;
+    }
+}
+
+// eventfd 읽기 완료 - 작업 풀이 넘긴 전송 처리
+static void handle_wake(struct io_uring_cqe *cqe) {
+    drain_posts();
+    arm_wake();
+}
+
+/**
+ * uring_broadcast - 다른 쓰레드에서 시작한 브로드캐스트를 링 쓰레드로 넘김
+ * @buf: 보낼 공유 버퍼
+ * @sender_id: 제외할 발신자 ID
+ * @return: 0 넘김, -1 링 쓰레드에서 호출했거나 넘기지 못함 (호출한 쪽이 직접 fanout)
+ */
+int uring_broadcast(msgbuf *buf, int sender_id) {
+    if (on_ring_thread) return -1;
+    return post_to_ring(-1, sender_id, buf);
+}
+
+/**
+ * uring_send - 클라이언트 송신 대기열에 메시지 추가
+ * @index: 클라이언트 인덱스
+ * @buf: 보낼 공유 버퍼 (복사하지 않고 참조만 추가)
+ * @return: 대기열에 넣었거나 정책에 따라 버린 경우 0, 실패 시 -1
+ *
+ * 실제 제출은 이벤트 루프가 현재 배치 처리를 마친 뒤 한꺼번에 수행합니다.
+ * 링 쓰레드가 아니면(작업 풀) post 목록을 거쳐 링 쓰레드가 대기열에 넣습니다.
+ */
+int uring_send(int index, msgbuf *buf) {
+    if (!on_ring_thread) return post_to_ring(index, client_at(index)->id, buf);
+
+    uring_conn *conn = client_at(index)->io_conn;
+    if (!conn || conn->closing || conn->send_failed) return -1;
+
+    if (outq_push(&conn->q, buf, NULL) == OUTQ_OVERFLOW) {
+        schedule_close(conn);
+        return 0;
+    }
+    mark_flush(conn);
+    return 0;
+}
+
+// 송신 대기열 여유 - 연결 상태는 링 쓰레드만 만지므로 다른 쓰레드에서는 0
+int uring_send_room(int index) {
+    if (!on_ring_thread) return 0;
+    uring_conn *conn = client_at(index)->io_conn;
+    if (!conn || conn->closing || conn->send_failed) return 0;
+    return (int)outq_room(&conn->q);
+}
+
+/**
+ * uring_server_init - io_uring 링과 제공 버퍼 링 준비
+ * @listen_fd: bind/listen이 끝난 서버 소켓
+ * @return: 0 성공, -1 io_uring 사용 불가
+ */
+int uring_server_init(int listen_fd) {
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+
+    ring.fd = sys_io_uring_setup(URING_ENTRIES, &p);
+    if (ring.fd < 0) {
+        perror("io_uring_setup 실패");
+        return -1;
+    }
+    if (!(p.features & IORING_FEAT_SINGLE_MMAP)) {
+        close(ring.fd);
+        return -1;
+    }
+
+    // SQ/CQ 링 매핑 (SINGLE_MMAP: 한 번의 mmap으로 둘 다 매핑)
+    size_t sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    size_t cq_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    size_t ring_size = sq_size > cq_size ? sq_size : cq_size;
+    char *rp = mmap(NULL, ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    ring.fd, IORING_OFF_SQ_RING);
+    if (rp == MAP_FAILED) {
+        close(ring.fd);
+        return -1;
+    }
+    ring.sqes = mmap(NULL, p.sq_entries * sizeof(struct io_uring_sqe), PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, ring.fd, IORING_OFF_SQES);
+    if (ring.sqes == MAP_FAILED) {
+        close(ring.fd);
+        return -1;
+    }
+
+    ring.sq_head = (unsigned *)(rp + p.sq_off.head);
+    ring.sq_tail = (unsigned *)(rp + p.sq_off.tail);
+    ring.sq_mask = *(unsigned *)(rp + p.sq_off.ring_mask);
+    ring.sq_entries = p.sq_entries;
+    unsigned *sq_array = (unsigned *)(rp + p.sq_off.array);
+    for (unsigned i = 0; i < p.sq_entries; i++) sq_array[i] = i;    // SQE 인덱스 고정 매핑
+    ring.sq_local_tail = *ring.sq_tail;
+
+    ring.cq_head = (unsigned *)(rp + p.cq_off.head);
+    ring.cq_tail = (unsigned *)(rp + p.cq_off.tail);
+    ring.cq_mask = *(unsigned *)(rp + p.cq_off.ring_mask);
+    ring.cqes = (struct io_uring_cqe *)(rp + p.cq_off.cqes);
+
+    // 제공 버퍼 링 등록 (5.19 이상)
+    ring.br = mmap(NULL, URING_NBUFS * sizeof(struct io_uring_buf), PROT_READ | PROT_WRITE,
+                   MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    ring.bufs = malloc((size_t)URING_NBUFS * URING_BUF_SIZE);
+    if (ring.br == MAP_FAILED || !ring.bufs) {
+        close(ring.fd);
+        return -1;
+    }
+
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (uint64_t)(uintptr_t)ring.br;
+    reg.ring_entries = URING_NBUFS;
+    reg.bgid = URING_BGID;
+    if (sys_io_uring_register(ring.fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        perror("제공 버퍼 링 등록 실패");
+        close(ring.fd);
+        return -1;
+    }
+    for (unsigned bid = 0; bid < URING_NBUFS; bid++) ring_recycle_buffer(bid);
+
+    wake_fd = eventfd(0, EFD_CLOEXEC);
+    if (wake_fd < 0) {
+        perror("eventfd 생성 실패");
+        close(ring.fd);
+        return -1;
+    }
+
+    ring.listen_fd = listen_fd;
+    return 0;
+}
+
+/**
+ * run_uring_server - io_uring 이벤트 루프
+ *
+ * 루프 한 바퀴: 쌓인 전송을 체인으로 만들고 → 제출 + 완료 대기(시스템 콜 1회)
+ * → 완료 큐를 모두 처리. 완료 처리 중 발생한 브로드캐스트는 다음 제출에 합쳐짐.
+ */
+void run_uring_server(void) {
+    on_ring_thread = 1;
+    arm_accept();
+    arm_wake();
+
+    while (1) {
+        flush_all();
+        if (ring_submit(1) < 0 && errno != EBUSY) {
+            log_printf(LOG_ERROR, "io_uring_enter 실패: %m");
+            break;
+        }
+
+        unsigned head = *ring.cq_head;
+        unsigned tail = __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            struct io_uring_cqe *cqe = &ring.cqes[head & ring.cq_mask];
+            uint64_t ud = cqe->user_data;
+            void *ptr = (void *)(uintptr_t)(ud & ~OP_MASK);
+
+            switch (ud & OP_MASK) {
+            case OP_ACCEPT: handle_accept(cqe); break;
+            case OP_RECV:   handle_recv((uring_conn *)ptr, cqe); break;
+            case OP_SEND:   handle_send((uring_conn *)ptr, cqe); break;
+            case OP_WAKE:   handle_wake(cqe); break;
+            case OP_TIMER:  timer_armed = 0; break;        // 다음 flush_all에서 창이 끝난 연결 제출
+            }
+
+            head++;
+            __atomic_store_n(ring.cq_head, head, __ATOMIC_RELEASE);
+            tail = __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE);
+        }
+
+        close_pending();
+    }
+
+    close(ring.fd);
+}
@@ -0,0 +1,466 @@
+// stats.c - 서버 지표 (지연 히스토그램, 카운터, 지표 소켓)
+
+#include "server.h"
+
+#include <stdarg.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#define STATS_REQ_TIMEOUT_MS    200     // 지표 소켓: 요청을 기다리는 시간 (없으면 본문만 보냄)
+
+// 기록 칸 하나 - 쓰레드 여러 개가 나눠 쓸 수 있으므로 원자적 덧셈으로만 변경
+typedef struct {
+    uint64_t count[STAT_HISTS];
+    uint64_t sum[STAT_HISTS];
+    uint64_t max[STAT_HISTS];
+    uint64_t b[STAT_HISTS][STATS_BUCKETS];
+    uint64_t counters[STAT_COUNTERS];
+} stats_stripe;
+
+static stats_stripe *stripes[STATS_STRIPES];    // 처음 쓸 때 할당 (해제하지 않음)
+static unsigned next_stripe;
+static __thread stats_stripe *my_stripe;
+
+// ================= 기록 =================
+
+uint64_t stats_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// 현재 쓰레드의 기록 칸 (처음이면 순서대로 하나 받음)
+static stats_stripe *stripe_self(void) {
+    if (my_stripe) return my_stripe;
+
+    unsigned i = __atomic_fetch_add(&next_stripe, 1, __ATOMIC_RELAXED) % STATS_STRIPES;
+    stats_stripe *s = __atomic_load_n(&stripes[i], __ATOMIC_ACQUIRE);
+    if (!s) {
+        stats_stripe *fresh = calloc(1, sizeof(stats_stripe));
+        if (!fresh) return NULL;
+        if (__atomic_compare_exchange_n(&stripes[i], &s, fresh, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            s = fresh;
+        } else {
+            free(fresh);                    // 다른 쓰레드가 먼저 할당함
+        }
+    }
+    my_stripe = s;
+    return s;
+}
+
+void stats_record(int hist, uint64_t value) {
+    stats_stripe *s = stripe_self();
+    if (!s) return;
+    __atomic_fetch_add(&s->b[hist][hdr_bucket_of(value)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&s->count[hist], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&s->sum[hist], value, __ATOMIC_RELAXED);
+    uint64_t cur = __atomic_load_n(&s->max[hist], __ATOMIC_RELAXED);
+    while (value > cur &&
+           !__atomic_compare_exchange_n(&s->max[hist], &cur, value, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+void stats_count(int counter, uint64_t n) {
+    stats_stripe *s = stripe_self();
+    if (s) __atomic_fetch_add(&s->counters[counter], n, __ATOMIC_RELAXED);
+}
+
+// ================= 합산 =================
+
+void stats_get_hist(int hist, stats_hist *out) {
+    memset(out, 0, sizeof(*out));
+    for (int i = 0; i < STATS_STRIPES; i++) {
+        stats_stripe *s = __atomic_load_n(&stripes[i], __ATOMIC_ACQUIRE);
+        if (!s) continue;
+        out->count += __atomic_load_n(&s->count[hist], __ATOMIC_RELAXED);
+        out->sum += __atomic_load_n(&s->sum[hist], __ATOMIC_RELAXED);
+        uint64_t max = __atomic_load_n(&s->max[hist], __ATOMIC_RELAXED);
+        if (max > out->max) out->max = max;
+        for (int j = 0; j < STATS_BUCKETS; j++) {
+            out->b[j] += __atomic_load_n(&s->b[hist][j], __ATOMIC_RELAXED);
+        }
+    }
+}
+
+uint64_t stats_get_counter(int counter) {
+    uint64_t total = 0;
+    for (int i = 0; i < STATS_STRIPES; i++) {
+        stats_stripe *s = __atomic_load_n(&stripes[i], __ATOMIC_ACQUIRE);
+        if (s) total += __atomic_load_n(&s->counters[counter], __ATOMIC_RELAXED);
+    }
+    return total;
+}
+
+/**
+ * stats_percentile - 히스토그램 백분위수
+ * @h: 합친 히스토그램
+ * @p: 백분위 (0~100)
+ * @return: 해당 순위 값이 든 칸의 상한값 (최대값을 넘지 않음), 기록이 없으면 0
+ */
+uint64_t stats_percentile(const stats_hist *h, double p) {
+    return hdr_percentile(h->b, h->count, h->max, p);
+}
+
+// ================= 출력 =================
+
+// 늘어나는 문자열 버퍼
+typedef struct {
+    char *p;
+    size_t len, cap;
+    int failed;
+} strbuf;
+
+static void sb_printf(strbuf *sb, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+static void sb_printf(strbuf *sb, const char *fmt, ...) {
+    if (sb->failed) return;
+    while (1) {
+        va_list ap;
+        va_start(ap, fmt);
+        int n = vsnprintf(sb->p + sb->len, sb->cap - sb->len, fmt, ap);
+        va_end(ap);
+        if (n < 0) {
+            sb->failed = 1;
+            return;
+        }
+        if ((size_t)n < sb->cap - sb->len) {
+            sb->len += (size_t)n;
+            return;
+        }
+        char *bigger = realloc(sb->p, sb->cap * 2 + (size_t)n);
+        if (!bigger) {
+            sb->failed = 1;
+            return;
+        }
+        sb->p = bigger;
+        sb->cap = sb->cap * 2 + (size_t)n;
+    }
+}
+
+static int sb_init(strbuf *sb) {
+    sb->cap = 4096;
+    sb->len = 0;
+    sb->failed = 0;
+    sb->p = malloc(sb->cap);
+    return sb->p ? 0 : -1;
+}
+
+// 결과를 넘겨줌 (실패 시 해제하고 -1)
+static int sb_finish(strbuf *sb, char **out) {
+    if (sb->failed) {
+        free(sb->p);
+        return -1;
+    }
+    *out = sb->p;
+    return (int)sb->len;
+}
+
+// 요약 한 줄 (ns 값은 us로 표시)
+static void summary_line(strbuf *sb, const char *label, int hist, int is_time) {
+    stats_hist h;
+    stats_get_hist(hist, &h);
+    if (h.count == 0) {
+        sb_printf(sb, "%s: 기록 없음\n", label);
+        return;
+    }
+    double div = is_time ? 1000.0 : 1.0;
+    sb_printf(sb, "%s: %lu건, 평균 %.1f, p50 %.1f, p90 %.1f, p99 %.1f, 최대 %.1f\n",
+              label, (unsigned long)h.count, (double)h.sum / (double)h.count / div,
+              stats_percentile(&h, 50) / div, stats_percentile(&h, 90) / div,
+              stats_percentile(&h, 99) / div, h.max / div);
+}
+
+/**
+ * stats_format - /stats 명령어용 요약
+ * @out: malloc한 텍스트 (호출한 쪽이 free)
+ * @return: 길이, -1 메모리 부족
+ */
+int stats_format(char **out) {
+    strbuf sb;
+    if (sb_init(&sb) < 0) return -1;
+
+    outq_stats qs;
+    rate_stats rs;
+    outq_get_stats(&qs);
+    rate_get_stats(&rs);
+    unsigned long rate_limited = rs.fanout_limited;
+    for (int i = 0; i < RATE_CLASSES; i++) rate_limited += rs.limited[i];
+
+    sb_printf(&sb, "[시스템] 서버 통계 (접속 %d명)\n", registry_count());
+    sb_printf(&sb, "수신: 메시지 %lu, %lu바이트 / 송신: 메시지 %lu, %lu바이트\n",
+              (unsigned long)stats_get_counter(STAT_RX_MESSAGES),
+              (unsigned long)stats_get_counter(STAT_RX_BYTES), qs.sent, qs.sent_bytes);
+    sb_printf(&sb, "송신 묶음: 쓰기 %lu번 (쓰기당 메시지 %.2f, 줄인 쓰기 %lu), 창 %uus%s\n",
+              qs.writes, qs.writes ? (double)qs.sent / (double)qs.writes : 0.0,
+              qs.sent > qs.writes ? qs.sent - qs.writes : 0, outq_batch_usec, outq_cork ? ", cork" : "");
+    unsigned long accepts = (unsigned long)stats_get_counter(STAT_ACCEPTS);
+    unsigned long allocs = (unsigned long)stats_get_counter(STAT_SESSION_ALLOCS);
+    sb_printf(&sb, "세션: 연결 %lu, 새 할당 %lu (연결당 %.3f)\n",
+              accepts, allocs, accepts ? (double)allocs / (double)accepts : 0.0);
+    if (hb_ping_sec > 0) {
+        sb_printf(&sb, "하트비트: 타이머 %lu개, PING %lu, 유휴 종료 %lu (%u초/%u초)\n",
+                  heartbeat_armed(), (unsigned long)stats_get_counter(STAT_PINGS),
+                  (unsigned long)stats_get_counter(STAT_REAPED), hb_ping_sec, hb_timeout_sec);
+    }
+    sb_printf(&sb, "버림: 대기열 %lu, 초과로 종료 %lu, 속도 제한 %lu, 로그 %lu\n",
+              qs.dropped, qs.disconnects, rate_limited, log_dropped());
+    workpool_stats ws;
+    workpool_get_stats(&ws);
+    if (ws.threads > 0) {
+        sb_printf(&sb, "작업 풀: 쓰레드 %d, 실행 %lu, 훔쳐 옴 %lu, 대기 %lu\n",
+                  ws.threads, ws.executed, ws.stolen, ws.queued);
+    }
+    summary_line(&sb, "수신→fanout(us)", STAT_RECV_TO_FANOUT, 1);
+    summary_line(&sb, "fanout 시간(us)", STAT_FANOUT, 1);
+    summary_line(&sb, "송신 대기열 길이", STAT_OUTQ_DEPTH, 0);
+    for (int i = 0; i < command_count() && i < STATS_MAX_COMMANDS; i++) {
+        stats_hist h;
+        stats_get_hist(STAT_COMMAND + i, &h);
+        if (h.count == 0) continue;
+        char label[64];
+        snprintf(label, sizeof(label), "명령어 %s(us)", command_name(i));
+        summary_line(&sb, label, STAT_COMMAND + i, 1);
+    }
+    return sb_finish(&sb, out);
+}
+
+// Prometheus 히스토그램 하나 (구간 경계는 2의 거듭제곱, 칸 경계와 일치)
+// is_time: ns 값을 초 단위로 출력, first_bit: 첫 경계 2^first_bit
+static void prom_hist(strbuf *sb, const char *name, const char *labels, int hist,
+                      int is_time, int first_bit) {
+    stats_hist h;
+    stats_get_hist(hist, &h);
+    const char *sep = labels[0] ? "," : "";
+
+    uint64_t cum = 0;
+    int i = 0;
+    for (int bit = first_bit; bit <= STATS_MAX_BITS; bit++) {
+        uint64_t limit = (uint64_t)1 << bit;        // 이 값 미만을 셈
+        while (i < STATS_BUCKETS && hdr_bucket_upper(i) < limit) cum += h.b[i++];
+        double le = is_time ? (double)limit * 1e-9 : (double)(limit - 1);
+        sb_printf(sb, "%s_bucket{%s%sle=\"%g\"} %lu\n", name, labels, sep, le, (unsigned long)cum);
+    }
+    sb_printf(sb, "%s_bucket{%s%sle=\"+Inf\"} %lu\n", name, labels, sep, (unsigned long)h.count);
+    sb_printf(sb, "%s_sum%s%s%s %g\n", name, labels[0] ? "{" : "", labels, labels[0] ? "}" : "",
+              is_time ? (double)h.sum * 1e-9 : (double)h.sum);
+    sb_printf(sb, "%s_count%s%s%s %lu\n", name, labels[0] ? "{" : "", labels, labels[0] ? "}" : "",
+              (unsigned long)h.count);
+}
+
+// Prometheus 텍스트 형식 전체
+static int format_prometheus(char **out) {
+    strbuf sb;
+    if (sb_init(&sb) < 0) return -1;
+
+    outq_stats qs;
+    rate_stats rs;
+    pagelog_stats ps;
+    unsigned long buf_live, buf_bytes;
+    outq_get_stats(&qs);
+    rate_get_stats(&rs);
+    pagelog_get_stats(&ps);
+    msgbuf_get_stats(&buf_live, &buf_bytes);
+
+    sb_printf(&sb, "# HELP pager_clients Connected clients.\n# TYPE pager_clients gauge\n");
+    sb_printf(&sb, "pager_clients %d\n", registry_count());
+
+    sb_printf(&sb, "# HELP pager_received_messages_total Messages received from clients.\n"
+                   "# TYPE pager_received_messages_total counter\n");
+    sb_printf(&sb, "pager_received_messages_total %lu\n", (unsigned long)stats_get_counter(STAT_RX_MESSAGES));
+    sb_printf(&sb, "# HELP pager_received_bytes_total Message bytes received from clients.\n"
+                   "# TYPE pager_received_bytes_total counter\n");
+    sb_printf(&sb, "pager_received_bytes_total %lu\n", (unsigned long)stats_get_counter(STAT_RX_BYTES));
+    sb_printf(&sb, "# HELP pager_accepts_total Accepted connections.\n"
+                   "# TYPE pager_accepts_total counter\n");
+    sb_printf(&sb, "pager_accepts_total %lu\n", (unsigned long)stats_get_counter(STAT_ACCEPTS));
+    sb_printf(&sb, "# HELP pager_session_allocs_total Session resources allocated because no recycled one was available.\n"
+                   "# TYPE pager_session_allocs_total counter\n");
+    sb_printf(&sb, "pager_session_allocs_total %lu\n", (unsigned long)stats_get_counter(STAT_SESSION_ALLOCS));
+    sb_printf(&sb, "# HELP pager_heartbeat_timers Armed heartbeat timers (one per connection).\n"
+                   "# TYPE pager_heartbeat_timers gauge\n");
+    sb_printf(&sb, "pager_heartbeat_timers %lu\n", heartbeat_armed());
+    sb_printf(&sb, "# HELP pager_heartbeat_pings_total PING lines sent to quiet connections.\n"
+                   "# TYPE pager_heartbeat_pings_total counter\n");
+    sb_printf(&sb, "pager_heartbeat_pings_total %lu\n", (unsigned long)stats_get_counter(STAT_PINGS));
+    sb_printf(&sb, "# HELP pager_idle_reaped_total Connections closed after the idle timeout.\n"
+                   "# TYPE pager_idle_reaped_total counter\n");
+    sb_printf(&sb, "pager_idle_reaped_total %lu\n", (unsigned long)stats_get_counter(STAT_REAPED));
+    sb_printf(&sb, "# HELP pager_roster_version Roster changes (joins, leaves, renames) since start.\n"
+                   "# TYPE pager_roster_version gauge\n");
+    sb_printf(&sb, "pager_roster_version %lu\n", roster_version());
+    sb_printf(&sb, "# HELP pager_roster_rebuilds_total Roster snapshots rebuilt for /list.\n"
+                   "# TYPE pager_roster_rebuilds_total counter\n");
+    sb_printf(&sb, "pager_roster_rebuilds_total %lu\n", roster_rebuilds());
+    sb_printf(&sb, "# HELP pager_sent_messages_total Messages fully sent to clients.\n"
+                   "# TYPE pager_sent_messages_total counter\n");
+    sb_printf(&sb, "pager_sent_messages_total %lu\n", qs.sent);
+    sb_printf(&sb, "# HELP pager_sent_bytes_total Message bytes sent to clients.\n"
+                   "# TYPE pager_sent_bytes_total counter\n");
+    sb_printf(&sb, "pager_sent_bytes_total %lu\n", qs.sent_bytes);
+    sb_printf(&sb, "# HELP pager_send_writes_total Write syscalls (io_uring: sendmsg requests) carrying outbound messages.\n"
+                   "# TYPE pager_send_writes_total counter\n");
+    sb_printf(&sb, "pager_send_writes_total %lu\n", qs.writes);
+    sb_printf(&sb, "# HELP pager_send_writes_saved_total Writes saved by batching messages into one writev.\n"
+                   "# TYPE pager_send_writes_saved_total counter\n");
+    sb_printf(&sb, "pager_send_writes_saved_total %lu\n", qs.sent > qs.writes ? qs.sent - qs.writes : 0);
+
+    sb_printf(&sb, "# HELP pager_outq_depth Messages waiting in outbound queues.\n"
+                   "# TYPE pager_outq_depth gauge\n");
+    sb_printf(&sb, "pager_outq_depth %lu\n", qs.depth);
+    sb_printf(&sb, "# HELP pager_outq_dropped_total Messages dropped by the queue-full policy.\n"
+                   "# TYPE pager_outq_dropped_total counter\n");
+    sb_printf(&sb, "pager_outq_dropped_total %lu\n", qs.dropped);
+    sb_printf(&sb, "# HELP pager_outq_overflow_disconnects_total Clients disconnected on queue overflow.\n"
+                   "# TYPE pager_outq_overflow_disconnects_total counter\n");
+    sb_printf(&sb, "pager_outq_overflow_disconnects_total %lu\n", qs.disconnects);
+
+    sb_printf(&sb, "# HELP pager_rate_limited_total Requests rejected by per-client rate limits.\n"
+                   "# TYPE pager_rate_limited_total counter\n");
+    for (int i = 0; i < RATE_CLASSES; i++) {
+        static const char *class_label[RATE_CLASSES] = { "chat", "broadcast", "private" };
+        sb_printf(&sb, "pager_rate_limited_total{class=\"%s\"} %lu\n", class_label[i], rs.limited[i]);
+    }
+    sb_printf(&sb, "# HELP pager_fanout_limited_total Requests rejected by the global fanout budget.\n"
+                   "# TYPE pager_fanout_limited_total counter\n");
+    sb_printf(&sb, "pager_fanout_limited_total %lu\n", rs.fanout_limited);
+    workpool_stats ws;
+    workpool_get_stats(&ws);
+    sb_printf(&sb, "# HELP pager_pool_executed_total Messages executed by the command worker pool.\n"
+                   "# TYPE pager_pool_executed_total counter\n");
+    sb_printf(&sb, "pager_pool_executed_total %lu\n", ws.executed);
+    sb_printf(&sb, "# HELP pager_pool_stolen_total Connections taken from another worker's deque.\n"
+                   "# TYPE pager_pool_stolen_total counter\n");
+    sb_printf(&sb, "pager_pool_stolen_total %lu\n", ws.stolen);
+    sb_printf(&sb, "# HELP pager_log_dropped_total Log records dropped because a log ring was full.\n"
+                   "# TYPE pager_log_dropped_total counter\n");
+    sb_printf(&sb, "pager_log_dropped_total %lu\n", log_dropped());
+
+    sb_printf(&sb, "# HELP pager_pages_pending Offline pages waiting for delivery.\n"
+                   "# TYPE pager_pages_pending gauge\n");
+    sb_printf(&sb, "pager_pages_pending %lu\n", ps.pending);
+    sb_printf(&sb, "# HELP pager_msgbuf_bytes Bytes held by live shared message buffers.\n"
+                   "# TYPE pager_msgbuf_bytes gauge\n");
+    sb_printf(&sb, "pager_msgbuf_bytes %lu\n", buf_bytes);
+
+    sb_printf(&sb, "# HELP pager_recv_to_fanout_seconds Time from receiving a message to finishing its processing.\n"
+                   "# TYPE pager_recv_to_fanout_seconds histogram\n");
+    prom_hist(&sb, "pager_recv_to_fanout_seconds", "", STAT_RECV_TO_FANOUT, 1, 10);
+    sb_printf(&sb, "# HELP pager_fanout_seconds Time spent queueing a broadcast or group page to all recipients.\n"
+                   "# TYPE pager_fanout_seconds histogram\n");
+    prom_hist(&sb, "pager_fanout_seconds", "", STAT_FANOUT, 1, 10);
+    sb_printf(&sb, "# HELP pager_outq_depth_sample Outbound queue length right after each enqueue.\n"
+                   "# TYPE pager_outq_depth_sample histogram\n");
+    prom_hist(&sb, "pager_outq_depth_sample", "", STAT_OUTQ_DEPTH, 0, 0);
+    sb_printf(&sb, "# HELP pager_command_seconds Command processing time.\n"
+                   "# TYPE pager_command_seconds histogram\n");
+    for (int i = 0; i < command_count() && i < STATS_MAX_COMMANDS; i++) {
+        char labels[64];
+        snprintf(labels, sizeof(labels), "command=\"%s\"", command_name(i));
+        prom_hist(&sb, "pager_command_seconds", labels, STAT_COMMAND + i, 1, 10);
+    }
+    return sb_finish(&sb, out);
+}
+
+// ================= 지표 소켓 =================
+
+static int send_all(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t n = send(fd, data, len, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+// 연결 하나에 지표를 한 번 보내고 닫음 (HTTP 요청이면 응답 헤더를 붙임)
+static void serve_one(int fd) {
+    int http = 0;
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+    if (poll(&pfd, 1, STATS_REQ_TIMEOUT_MS) > 0) {
+        char req[512];
+        ssize_t n = recv(fd, req, sizeof(req), 0);
+        http = (n >= 4 && memcmp(req, "GET ", 4) == 0);
+    }
+
+    char *body;
+    int len = format_prometheus(&body);
+    if (len < 0) return;
+    if (http) {
+        char header[160];
+        int hlen = snprintf(header, sizeof(header),
+                            "HTTP/1.0 200 OK\r\n"
+                            "Content-Type: text/plain; version=0.0.4\r\n"
+                            "Content-Length: %d\r\n"
+                            "Connection: close\r\n\r\n", len);
+        if (send_all(fd, header, (size_t)hlen) < 0) {
+            free(body);
+            return;
+        }
+    }
+    send_all(fd, body, (size_t)len);
+    free(body);
+}
+
+static void *serve_loop(void *arg) {
+    int listen_fd = (int)(intptr_t)arg;
+    struct timeval tv = { .tv_sec = 1 };
+
+    while (1) {
+        int fd = accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EINTR) log_printf(LOG_WARN, "지표 소켓 accept 실패: %m");
+            continue;
+        }
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));   // 읽지 않는 상대에게 묶이지 않도록
+        serve_one(fd);
+        close(fd);
+    }
+    return NULL;
+}
+
+/**
+ * stats_serve - 지표 Unix 소켓을 열고 응답 쓰레드 시작
+ * @path: 소켓 경로 (남아 있는 예전 소켓 파일은 지움)
+ * @return: 0 성공, -1 실패
+ *
+ * 소켓 파일 권한은 0660 (같은 그룹의 로컬 사용자만 접근).
+ */
+int stats_serve(const char *path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "지표 소켓 경로가 너무 깁니다: %s\n", path);
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        perror("지표 소켓 생성 실패");
+        return -1;
+    }
+    unlink(path);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        chmod(path, 0660) < 0 ||
+        listen(fd, 16) < 0) {
+        perror("지표 소켓 준비 실패");
+        close(fd);
+        return -1;
+    }
+
+    pthread_t tid;
+    if (pthread_create(&tid, NULL, serve_loop, (void *)(intptr_t)fd) != 0) {
+        perror("지표 쓰레드 생성 실패");
+        close(fd);
+        return -1;
+    }
+    pthread_detach(tid);
+    log_printf(LOG_INFO, "지표 소켓: %s", path);
+    return 0;
+}
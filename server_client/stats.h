@@ -0,0 +1,70 @@
+// stats.h - 서버 지표 (지연 히스토그램, 카운터) 헤더 파일
+//
+// 처리 경로에서 값 하나를 기록하는 비용이 시계 읽기와 원자적 덧셈 몇 번이 되도록
+// 쓰레드별로 나눠 기록하고, 읽을 때(/stats, 지표 소켓) 모두 합칩니다.
+// - 히스토그램은 HDR 방식(hdr.h): 2의 거듭제곱 구간마다 2^STATS_SUB_BITS개로 나눈 칸
+//   → 상대 오차 약 12.5%로 1ns ~ 2^40ns(약 18분)를 칸 304개로 표현
+// - 기록 칸(stripe)은 쓰레드가 처음 기록할 때 하나씩 받음. 리액터 쓰레드는 보통 칸을
+//   혼자 쓰고, 접속당 쓰레드 모델처럼 쓰레드가 많으면 STATS_STRIPES개를 나눠 씀
+// - 지표는 /stats 명령어(요약)와 로컬 Unix 소켓(Prometheus 텍스트 형식)으로 확인
+//   $ curl --unix-socket metrics.sock http://localhost/metrics
+//   $ nc -U metrics.sock
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hdr.h"
+
+// ================= 설정 =================
+
+#define STATS_SUB_BITS      HDR_SUB_BITS        // 2의 거듭제곱 구간 하나를 나누는 칸 수 (2^3)
+#define STATS_MAX_BITS      HDR_MAX_BITS        // 기록 가능한 최대값 2^40 - 1 (넘으면 마지막 칸)
+#define STATS_BUCKETS       HDR_BUCKETS
+#define STATS_STRIPES       64                  // 최대 기록 칸 수
+#define STATS_MAX_COMMANDS  16                  // 명령어별 히스토그램 수
+
+#define STATS_DEFAULT_SOCK  "metrics.sock"      // 지표 Unix 소켓 경로
+
+// 히스토그램
+#define STAT_RECV_TO_FANOUT 0                   // 메시지 수신 → 처리(fanout 대기열 추가) 완료 (ns)
+#define STAT_FANOUT         1                   // 브로드캐스트/그룹 호출 fanout 시간 (ns)
+#define STAT_OUTQ_DEPTH     2                   // 송신 대기열에 넣은 직후 길이
+#define STAT_COMMAND        3                   // 명령어 처리 시간 (ns), + 명령어 번호
+#define STAT_HISTS          (STAT_COMMAND + STATS_MAX_COMMANDS)
+
+// 카운터
+#define STAT_RX_MESSAGES    0                   // 받은 메시지 수
+#define STAT_RX_BYTES       1                   // 받은 메시지 바이트
+#define STAT_ACCEPTS        2                   // 받은 연결 수
+#define STAT_SESSION_ALLOCS 3                   // 연결 때문에 새로 할당한 세션 자원 수 (슬롯 청크, 수신 버퍼, 쓰레드 등)
+#define STAT_PINGS          4                   // 조용한 연결에 보낸 PING 수
+#define STAT_REAPED         5                   // 응답이 없어 끊은 연결 수
+#define STAT_COUNTERS       6
+
+// ================= 자료 구조 =================
+
+// 합친 히스토그램
+typedef struct {
+    uint64_t count;
+    uint64_t sum;
+    uint64_t max;
+    uint64_t b[STATS_BUCKETS];
+} stats_hist;
+
+// ================= 함수 선언 =================
+
+uint64_t stats_now(void);                       // 단조 시계 (ns)
+void stats_record(int hist, uint64_t value);    // 히스토그램에 값 하나 기록
+void stats_count(int counter, uint64_t n);      // 카운터 증가
+
+void stats_get_hist(int hist, stats_hist *out);             // 모든 쓰레드 합산
+uint64_t stats_get_counter(int counter);
+uint64_t stats_percentile(const stats_hist *h, double p);   // 백분위수 (p: 0~100, 칸 상한값)
+
+int  stats_format(char **out);                  // /stats 요약 (malloc, 길이 반환, -1: 실패)
+int  stats_serve(const char *path);             // 지표 소켓 쓰레드 시작 (-1: 실패)
+
+#endif // STATS_H
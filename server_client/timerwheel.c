@@ -0,0 +1,120 @@
+// timerwheel.c - 계층형 타이머 휠
+//
+// w->now는 다음에 처리할 틱입니다. 타이머는 만료까지 남은 틱 수로 단계를 고르고,
+// 그 단계의 칸 번호는 만료 틱의 해당 비트로 정합니다. 0단계 칸 번호가 0으로 돌아올 때마다
+// 1단계의 다음 칸을 풀어 다시 넣고, 1단계도 0으로 돌아왔으면 2단계를 푸는 식입니다.
+
+#include "timerwheel.h"
+
+#define TW_MASK     (TW_SLOTS - 1)
+#define TW_SPAN     ((uint64_t)1 << (TW_BITS * TW_LEVELS))     // 휠이 담을 수 있는 최대 틱 수
+
+static void list_init(tw_timer *head) {
+    head->next = head->prev = head;
+}
+
+static void list_add(tw_timer *head, tw_timer *t) {
+    t->prev = head->prev;
+    t->next = head;
+    head->prev->next = t;
+    head->prev = t;
+}
+
+static void list_del(tw_timer *t) {
+    t->prev->next = t->next;
+    t->next->prev = t->prev;
+    t->next = t->prev = NULL;
+}
+
+// 만료 틱에 맞는 칸에 넣기
+static void place(timer_wheel *w, tw_timer *t) {
+    uint64_t expires = t->expires;
+    if (expires < w->now) {
+        list_add(&w->slots[0][w->now & TW_MASK], t);    // 이미 지남 - 이번 틱에 실행
+        return;
+    }
+    uint64_t delta = expires - w->now;
+    if (delta >= TW_SPAN) {
+        expires = w->now + TW_SPAN - 1;                 // 너무 멀면 휠 끝에 두고 나중에 다시 넣음
+        delta = TW_SPAN - 1;
+    }
+    int level = 0;
+    while (delta >= ((uint64_t)1 << (TW_BITS * (level + 1)))) level++;
+    list_add(&w->slots[level][(expires >> (TW_BITS * level)) & TW_MASK], t);
+}
+
+// level 단계의 index 칸을 풀어 아래 단계로 다시 넣음 (반환: index, 0이면 윗단계도 풀어야 함)
+static int cascade(timer_wheel *w, int level, int index) {
+    tw_timer *head = &w->slots[level][index];
+    tw_timer list;
+    if (head->next == head) return index;
+    list.next = head->next;
+    list.prev = head->prev;
+    list.next->prev = &list;
+    list.prev->next = &list;
+    list_init(head);
+
+    while (list.next != &list) {
+        tw_timer *t = list.next;
+        list_del(t);
+        place(w, t);
+    }
+    return index;
+}
+
+void tw_init(timer_wheel *w, uint64_t now) {
+    w->now = now;
+    w->armed = 0;
+    for (int l = 0; l < TW_LEVELS; l++) {
+        for (int i = 0; i < TW_SLOTS; i++) list_init(&w->slots[l][i]);
+    }
+}
+
+void tw_arm(timer_wheel *w, tw_timer *t, uint64_t expires) {
+    if (tw_armed(t)) list_del(t);
+    else w->armed++;
+    t->expires = expires;
+    place(w, t);
+}
+
+void tw_cancel(timer_wheel *w, tw_timer *t) {
+    if (!tw_armed(t)) return;
+    list_del(t);
+    w->armed--;
+}
+
+/**
+ * tw_advance - now 틱까지 진행하며 만료된 타이머 실행
+ * @w: 휠
+ * @now: 이 틱까지 만료된 타이머를 실행
+ * @fn: 만료된 타이머마다 호출 (등록 해제된 뒤 호출되므로 다시 등록 가능)
+ * @arg: fn에 넘길 값
+ *
+ * 한 틱에 드는 비용은 칸 하나를 비우는 것뿐이고, cascade는 TW_SLOTS틱에 한 번입니다.
+ */
+void tw_advance(timer_wheel *w, uint64_t now, tw_fn fn, void *arg) {
+    while (w->now <= now) {
+        int index = (int)(w->now & TW_MASK);
+        for (int l = 1; l < TW_LEVELS && index == 0; l++) {
+            index = cascade(w, l, (int)((w->now >> (TW_BITS * l)) & TW_MASK));
+        }
+        tw_timer *head = &w->slots[0][w->now & TW_MASK];
+        w->now++;
+
+        // 칸을 통째로 떼어 낸 뒤 하나씩 실행 (fn 안에서 같은 칸에 다시 등록해도 섞이지 않음)
+        tw_timer list;
+        if (head->next == head) continue;
+        list.next = head->next;
+        list.prev = head->prev;
+        list.next->prev = &list;
+        list.prev->next = &list;
+        list_init(head);
+
+        while (list.next != &list) {
+            tw_timer *t = list.next;
+            list_del(t);
+            w->armed--;
+            fn(t, arg);
+        }
+    }
+}
@@ -0,0 +1,52 @@
+// timerwheel.h - 계층형 타이머 휠 헤더 파일
+//
+// 연결마다 하나씩 있는 타이머(하트비트, 유휴 종료) 수만 개를 정렬 없이 관리합니다.
+// - 타이머 노드는 사용하는 쪽 구조체에 들어 있음 (할당 없음)
+// - 휠은 단계 TW_LEVELS개, 단계마다 칸 TW_SLOTS개. 0단계 한 칸이 1틱이고,
+//   단계가 오를 때마다 한 칸이 TW_SLOTS배 길어짐 (틱 100ms 기준 0단계 6.4초, 1단계 약 7분, ...)
+// - 등록/취소는 이중 연결 리스트에 넣고 빼기뿐이라 O(1)
+// - 틱이 0단계 한 바퀴를 돌 때마다 윗단계 칸 하나를 아래로 내려 다시 넣음 (cascade)
+// - lock은 없음: 휠 하나는 한 쓰레드가 쓰거나 사용하는 쪽이 lock으로 보호
+
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ================= 설정 =================
+
+#define TW_BITS     6
+#define TW_SLOTS    (1 << TW_BITS)      // 단계당 칸 수
+#define TW_LEVELS   4                   // 단계 수 (최대 TW_SLOTS^TW_LEVELS 틱 뒤까지, 넘으면 맨 끝에 둠)
+
+// ================= 자료 구조 =================
+
+// 타이머 하나 (사용하는 쪽 구조체에 넣어 둠)
+typedef struct tw_timer {
+    struct tw_timer *next, *prev;       // 칸 리스트 (등록되지 않았으면 next == NULL)
+    uint64_t expires;                   // 만료 틱
+} tw_timer;
+
+typedef struct {
+    uint64_t now;                       // 다음에 처리할 틱
+    tw_timer slots[TW_LEVELS][TW_SLOTS];    // 칸마다 원형 리스트의 머리
+    unsigned long armed;                // 등록된 타이머 수
+} timer_wheel;
+
+// ================= 함수 선언 =================
+
+void tw_init(timer_wheel *w, uint64_t now);
+void tw_arm(timer_wheel *w, tw_timer *t, uint64_t expires);    // 등록 (이미 등록돼 있으면 옮김)
+void tw_cancel(timer_wheel *w, tw_timer *t);                    // 취소 (등록되지 않았으면 아무것도 안 함)
+
+static inline int tw_armed(const tw_timer *t) {
+    return t->next != NULL;
+}
+
+// 만료된 타이머마다 호출 (등록 해제된 상태로 넘어오므로 그 안에서 다시 등록해도 됨)
+typedef void (*tw_fn)(tw_timer *t, void *arg);
+
+void tw_advance(timer_wheel *w, uint64_t now, tw_fn fn, void *arg);   // now 틱까지 진행
+
+#endif // TIMERWHEEL_H
@@ -0,0 +1,312 @@
+// workpool.c - 명령어 실행 작업 풀 (work-stealing deque + 연결별 strand)
+//
+// deque 하나는 작업 쓰레드 하나의 몫입니다.
+// - 주인 쓰레드는 아래쪽(bottom)에서 꺼내고(최근 것 먼저, 캐시에 남아 있을 가능성이 큼)
+// - 다른 쓰레드는 위쪽(top)에서 훔쳐감(오래 기다린 것 먼저)
+// - I/O 쓰레드는 처음 넘길 때 정해진 deque 하나에 계속 넣음
+//
+// 할 일이 없는 쓰레드는 idle_cond에서 잠들고, 넣는 쪽은 잠든 쓰레드가 있을 때만 깨움.
+// 넣는 쪽은 queued를 올린 뒤 sleepers를 보고, 잠드는 쪽은 sleepers를 올린 뒤 queued를
+// 다시 보므로(둘 다 seq_cst) 깨우기를 놓치지 않음
+
+#include "workpool.h"
+#include "log.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+struct pool_task {
+    pool_task *next;
+    pool_fn fn;
+    int index;
+    uint64_t rx_time;
+    char data[];
+};
+
+typedef struct {
+    pthread_mutex_t lock;
+    pool_strand **items;        // 원형 배열
+    unsigned long top, bottom;  // top <= bottom, 크기는 bottom - top
+    unsigned long cap;          // 2의 거듭제곱
+    int id;
+} pool_deque;
+
+static pool_deque deques[WORKPOOL_MAX_THREADS];
+static int nworkers;
+
+static __thread pool_deque *self_deque;     // 작업 쓰레드 자신의 deque
+static __thread pool_deque *home_deque;     // I/O 쓰레드가 넣을 deque
+static unsigned next_home;
+
+static pthread_mutex_t idle_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t idle_cond = PTHREAD_COND_INITIALIZER;
+static int sleepers;
+static unsigned long queued;
+
+static unsigned long n_executed;
+static unsigned long n_stolen;
+
+// ================= deque =================
+
+static int deque_push(pool_deque *d, pool_strand *s) {
+    pthread_mutex_lock(&d->lock);
+    if (d->bottom - d->top == d->cap) {
+        pool_strand **bigger = malloc(sizeof(pool_strand *) * d->cap * 2);
+        if (!bigger) {
+            pthread_mutex_unlock(&d->lock);
+            return -1;
+        }
+        for (unsigned long i = d->top; i < d->bottom; i++) {
+            bigger[i & (d->cap * 2 - 1)] = d->items[i & (d->cap - 1)];
+        }
+        free(d->items);
+        d->items = bigger;
+        d->cap *= 2;
+    }
+    d->items[d->bottom & (d->cap - 1)] = s;
+    d->bottom++;
+    __atomic_add_fetch(&queued, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&d->lock);
+
+    if (__atomic_load_n(&sleepers, __ATOMIC_SEQ_CST) > 0) {
+        pthread_mutex_lock(&idle_lock);
+        pthread_cond_signal(&idle_cond);
+        pthread_mutex_unlock(&idle_lock);
+    }
+    return 0;
+}
+
+// 주인 쓰레드: 아래쪽에서 꺼냄
+static pool_strand *deque_pop(pool_deque *d) {
+    pool_strand *s = NULL;
+    pthread_mutex_lock(&d->lock);
+    if (d->bottom != d->top) {
+        d->bottom--;
+        s = d->items[d->bottom & (d->cap - 1)];
+        __atomic_sub_fetch(&queued, 1, __ATOMIC_SEQ_CST);
+    }
+    pthread_mutex_unlock(&d->lock);
+    return s;
+}
+
+// 다른 쓰레드: 위쪽에서 훔침 (비어 있어 보이면 lock 없이 넘어감)
+static pool_strand *deque_steal(pool_deque *d) {
+    if (__atomic_load_n(&d->bottom, __ATOMIC_RELAXED) == __atomic_load_n(&d->top, __ATOMIC_RELAXED)) {
+        return NULL;
+    }
+    pool_strand *s = NULL;
+    pthread_mutex_lock(&d->lock);
+    if (d->bottom != d->top) {
+        s = d->items[d->top & (d->cap - 1)];
+        d->top++;
+        __atomic_sub_fetch(&queued, 1, __ATOMIC_SEQ_CST);
+    }
+    pthread_mutex_unlock(&d->lock);
+    return s;
+}
+
+// ================= strand =================
+
+void strand_init(pool_strand *s) {
+    pthread_mutex_init(&s->lock, NULL);
+    s->head = s->tail = NULL;
+    s->scheduled = 0;
+    s->pending = 0;
+    s->drained = NULL;
+    s->drained_index = -1;
+}
+
+void strand_destroy(pool_strand *s) {
+    pthread_mutex_destroy(&s->lock);
+}
+
+// 연결마다 쓰레드가 있는 thread 모델에서만 씀 (그 연결의 쓰레드만 멈춤)
+void strand_wait(pool_strand *s) {
+    struct timespec pause = { 0, 100000 };      // 100us
+    while (strand_busy(s)) nanosleep(&pause, NULL);
+}
+
+/**
+ * strand_close - 연결을 닫기 전에 남은 메시지 확인 (기다리지 않음)
+ * @s: 닫는 연결의 strand (이후 새 메시지를 넣지 않음)
+ * @fn: 남은 메시지가 있으면 마지막 메시지가 끝난 뒤 작업 쓰레드에서 호출할 함수
+ * @index: fn 인자 (클라이언트 인덱스)
+ * @return: 0 = 남은 메시지 없음 (바로 정리), 1 = fn이 불린 뒤 정리
+ *
+ * pending 감소와 이 확인이 모두 s->lock 아래에서 일어나므로 알림을 놓치지 않습니다.
+ */
+int strand_close(pool_strand *s, strand_drained_fn fn, int index) {
+    pthread_mutex_lock(&s->lock);
+    int busy = __atomic_load_n(&s->pending, __ATOMIC_ACQUIRE) > 0;
+    if (busy) {
+        s->drained = fn;
+        s->drained_index = index;
+    }
+    pthread_mutex_unlock(&s->lock);
+    return busy;
+}
+
+/**
+ * strand_run - 연결 하나의 메시지를 순서대로 실행
+ * @d: 실행 중인 쓰레드의 deque (양보할 때 다시 넣는 곳)
+ * @s: 실행할 strand
+ *
+ * pending을 줄이고 lock을 놓는 것이 strand에 대한 마지막 접근입니다. pending이 0이 되면
+ * 연결이 정리되어 슬롯이 재사용될 수 있기 때문입니다. 닫는 중인 연결이면 그 뒤에
+ * 비움 알림만 호출합니다 (알림을 받은 담당 루프가 정리하므로 그때까지 슬롯은 유효).
+ */
+static void strand_run(pool_deque *d, pool_strand *s) {
+    for (int n = 1; ; n++) {
+        pthread_mutex_lock(&s->lock);
+        pool_task *t = s->head;
+        s->head = t->next;
+        if (!s->head) s->tail = NULL;
+        pthread_mutex_unlock(&s->lock);
+
+        t->fn(t->index, t->data, t->rx_time);
+        free(t);
+        __atomic_add_fetch(&n_executed, 1, __ATOMIC_RELAXED);
+
+        pthread_mutex_lock(&s->lock);
+        int more = s->head != NULL;
+        if (!more) s->scheduled = 0;
+        strand_drained_fn drained = NULL;
+        int drained_index = s->drained_index;
+        if (__atomic_sub_fetch(&s->pending, 1, __ATOMIC_RELEASE) == 0) drained = s->drained;
+        pthread_mutex_unlock(&s->lock);
+
+        if (drained) drained(drained_index);
+        if (!more) return;
+        if (n >= WORKPOOL_STRAND_BATCH && deque_push(d, s) == 0) return;    // 다른 연결에 양보
+    }
+}
+
+/**
+ * workpool_submit - 메시지를 연결의 strand에 넣고 필요하면 strand를 deque에 넣음
+ * @s: 연결의 strand
+ * @fn: 실행할 함수
+ * @index: 클라이언트 인덱스
+ * @data: 메시지 (복사함)
+ * @len: 메시지 길이
+ * @rx_time: 수신 시각 (지연 측정용)
+ * @return: 0 성공, -1 메모리 부족
+ */
+int workpool_submit(pool_strand *s, pool_fn fn, int index,
+                    const char *data, size_t len, uint64_t rx_time) {
+    pool_task *t = malloc(sizeof(pool_task) + len + 1);
+    if (!t) return -1;
+    t->next = NULL;
+    t->fn = fn;
+    t->index = index;
+    t->rx_time = rx_time;
+    memcpy(t->data, data, len);
+    t->data[len] = '\0';
+
+    if (!home_deque) {
+        home_deque = self_deque ? self_deque
+                   : &deques[__atomic_fetch_add(&next_home, 1, __ATOMIC_RELAXED) % (unsigned)nworkers];
+    }
+
+    __atomic_add_fetch(&s->pending, 1, __ATOMIC_RELAXED);
+    pthread_mutex_lock(&s->lock);
+    if (s->tail) s->tail->next = t;
+    else s->head = t;
+    s->tail = t;
+    int schedule = !s->scheduled;
+    s->scheduled = 1;
+    pthread_mutex_unlock(&s->lock);
+
+    if (schedule && deque_push(home_deque, s) < 0) {
+        // deque를 늘리지 못함 - 방금 넣은 메시지를 되돌림 (이 strand는 실행 중이 아님)
+        pthread_mutex_lock(&s->lock);
+        s->head = s->tail = NULL;
+        s->scheduled = 0;
+        pthread_mutex_unlock(&s->lock);
+        __atomic_sub_fetch(&s->pending, 1, __ATOMIC_RELEASE);
+        free(t);
+        return -1;
+    }
+    return 0;
+}
+
+// ================= 작업 쓰레드 =================
+
+static pool_strand *find_work(pool_deque *d) {
+    pool_strand *s = deque_pop(d);
+    if (s) return s;
+    for (int i = 1; i < nworkers; i++) {
+        s = deque_steal(&deques[(d->id + i) % nworkers]);
+        if (s) {
+            __atomic_add_fetch(&n_stolen, 1, __ATOMIC_RELAXED);
+            return s;
+        }
+    }
+    return NULL;
+}
+
+static void *worker_loop(void *arg) {
+    pool_deque *d = (pool_deque *)arg;
+    self_deque = d;
+
+    while (1) {
+        pool_strand *s = find_work(d);
+        if (s) {
+            strand_run(d, s);
+            continue;
+        }
+
+        pthread_mutex_lock(&idle_lock);
+        __atomic_add_fetch(&sleepers, 1, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&queued, __ATOMIC_SEQ_CST) == 0) {
+            pthread_cond_wait(&idle_cond, &idle_lock);
+        }
+        __atomic_sub_fetch(&sleepers, 1, __ATOMIC_SEQ_CST);
+        pthread_mutex_unlock(&idle_lock);
+    }
+    return NULL;
+}
+
+/**
+ * workpool_init - 작업 쓰레드 시작
+ * @nthreads: 쓰레드 수 (0이면 풀을 쓰지 않고 모든 메시지를 I/O 루프에서 실행)
+ * @return: 0 성공, -1 실패
+ */
+int workpool_init(int nthreads) {
+    if (nthreads > WORKPOOL_MAX_THREADS) nthreads = WORKPOOL_MAX_THREADS;
+    for (int i = 0; i < nthreads; i++) {
+        pool_deque *d = &deques[i];
+        pthread_mutex_init(&d->lock, NULL);
+        d->cap = WORKPOOL_DEQUE_INIT;
+        d->top = d->bottom = 0;
+        d->id = i;
+        d->items = malloc(sizeof(pool_strand *) * d->cap);
+        if (!d->items) {
+            log_printf(LOG_ERROR, "작업 풀 deque 할당 실패");
+            return -1;
+        }
+    }
+    nworkers = nthreads;
+
+    for (int i = 0; i < nthreads; i++) {
+        pthread_t tid;
+        int err = pthread_create(&tid, NULL, worker_loop, &deques[i]);
+        if (err != 0) {
+            log_printf(LOG_ERROR, "작업 쓰레드 생성 실패: %s", strerror(err));
+            return -1;
+        }
+        pthread_detach(tid);
+    }
+    return 0;
+}
+
+int workpool_enabled(void) {
+    return nworkers > 0;
+}
+
+void workpool_get_stats(workpool_stats *st) {
+    st->threads = nworkers;
+    st->executed = __atomic_load_n(&n_executed, __ATOMIC_RELAXED);
+    st->stolen = __atomic_load_n(&n_stolen, __ATOMIC_RELAXED);
+    st->queued = __atomic_load_n(&queued, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,77 @@
+// workpool.h - 명령어 실행 작업 풀 헤더 파일
+//
+// 접속자 수에 비례하는 작업(/list 목록 생성, /all·/page, 큰 브로드캐스트 등)을
+// I/O 루프에서 바로 실행하지 않고 CPU 수만큼 띄운 작업 쓰레드로 넘깁니다.
+// 가벼운 명령어는 지금처럼 받은 쓰레드에서 바로 실행합니다.
+// - 작업 쓰레드마다 deque가 있고, 자기 deque가 비면 다른 쓰레드의 deque 반대쪽에서 훔쳐옴
+//   (I/O 쓰레드 여러 개가 넣을 수 있으므로 deque는 짧은 mutex로 보호)
+// - 연결별 순서 보장: 넘긴 메시지는 연결의 strand(작업 목록)에 쌓이고, deque에는 strand가
+//   한 번만 들어감. strand는 한 번에 한 쓰레드만 실행하므로 같은 연결의 메시지는 받은 순서대로,
+//   다른 연결의 메시지는 여러 코어에서 동시에 실행됨
+// - 실행이 끝나지 않은 메시지가 있는 연결은 가벼운 메시지도 풀로 넘겨 순서를 지킴
+// - 연결을 닫을 때 남은 메시지가 있으면 I/O 루프는 기다리지 않고(strand_close), 마지막 메시지를
+//   실행한 작업 쓰레드가 "strand 비움" 알림을 담당 루프에 넘겨 그때 정리함
+// - I/O 모델과 무관: 전송은 client_send_buf를 거치므로 어느 모델에서든 작업 쓰레드가 보낼 수 있음
+
+#ifndef WORKPOOL_H
+#define WORKPOOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+
+// ================= 설정 =================
+
+#define WORKPOOL_MAX_THREADS    64          // 최대 작업 쓰레드 수
+#define WORKPOOL_DEQUE_INIT     256         // deque 초기 크기 (가득 차면 두 배로)
+#define WORKPOOL_STRAND_BATCH   16          // strand 하나를 연속 실행할 최대 메시지 수 (넘으면 양보)
+#define WORKPOOL_FANOUT_MIN     256         // 채팅 브로드캐스트를 풀로 넘기는 최소 접속자 수
+
+// ================= 자료 구조 =================
+
+typedef struct pool_task pool_task;
+
+// 작업 함수: 메시지 하나 실행 (data는 NULL로 끝나며 수정 가능)
+typedef void (*pool_fn)(int index, char *data, uint64_t rx_time);
+
+// strand 비움 알림: 닫는 중인 연결의 마지막 메시지가 끝나면 작업 쓰레드에서 호출
+typedef void (*strand_drained_fn)(int index);
+
+// 연결 하나의 작업 목록 - 한 번에 한 쓰레드만 실행
+typedef struct {
+    pthread_mutex_t lock;
+    pool_task *head, *tail;
+    int scheduled;              // deque에 들어 있거나 실행 중
+    int pending;                // 실행이 끝나지 않은 메시지 수 (0이면 바로 실행해도 됨)
+    strand_drained_fn drained;  // 닫는 중: pending이 0이 되면 호출 (lock 아래에서 설정/확인)
+    int drained_index;
+} pool_strand;
+
+// 작업 풀 카운터
+typedef struct {
+    int threads;                // 작업 쓰레드 수 (0: 사용 안 함)
+    unsigned long executed;     // 실행한 메시지 수
+    unsigned long stolen;       // 다른 쓰레드의 deque에서 가져온 strand 수
+    unsigned long queued;       // 지금 deque에 있는 strand 수
+} workpool_stats;
+
+// ================= 함수 선언 =================
+
+int  workpool_init(int nthreads);           // 작업 쓰레드 시작 (0: 사용 안 함, -1: 실패)
+int  workpool_enabled(void);
+
+void strand_init(pool_strand *s);
+void strand_wait(pool_strand *s);           // 넘긴 메시지가 모두 끝날 때까지 대기 (thread 모델 전용)
+int  strand_close(pool_strand *s, strand_drained_fn fn, int index);    // 1: 남은 메시지가 끝나면 fn 호출
+void strand_destroy(pool_strand *s);
+
+static inline int strand_busy(pool_strand *s) {
+    return __atomic_load_n(&s->pending, __ATOMIC_ACQUIRE) > 0;
+}
+
+int  workpool_submit(pool_strand *s, pool_fn fn, int index,
+                     const char *data, size_t len, uint64_t rx_time);   // 복사해서 넘김 (-1: 메모리 부족)
+
+void workpool_get_stats(workpool_stats *st);
+
+#endif // WORKPOOL_H